@@ -1,7 +1,13 @@
 #pragma once
 
+#include <algorithm>
+#include <cstdint>
+#include <optional>
 #include <sstream>
+#include <stdexcept>
 #include <unordered_map>
+#include <utility>
+#include <vector>
 
 namespace slog {
 
@@ -13,11 +19,94 @@ namespace slog {
  * following their number. In other words, if the item right after the
  * most recently read item has not been added to the log, read cannot
  * advance. A log can only be iterated forward in one direction.
+ *
+ * Items are buffered in a ring whose slot for a position is found at
+ * offset (position - next position to read) from the head, so inserting
+ * and reading are array accesses. The ring grows to fit the furthest
+ * position inserted so far, hence its size is bounded by the distance
+ * between the first unread position and the furthest one.
  */
 template <typename T>
 class AsyncLog {
  public:
-  AsyncLog(uint32_t start_from = 0) : next_(start_from) {}
+  AsyncLog(uint32_t start_from = 0) : next_(start_from), head_(0), size_(0) { Grow(kInitialCapacity); }
+
+  void Insert(uint32_t position, const T& item) {
+    if (position < next_) {
+      return;
+    }
+    size_t offset = position - next_;
+    if (offset >= ring_.size()) {
+      Grow(offset + 1);
+    }
+    auto& slot = ring_[(head_ + offset) & mask_];
+    if (slot.has_value()) {
+      std::ostringstream os;
+      os << "Log position " << position << " has already been taken";
+      throw std::runtime_error(os.str());
+    }
+    slot.emplace(item);
+    size_++;
+  }
+
+  bool HasNext() const { return ring_[head_].has_value(); }
+
+  const T& Peek() {
+    if (!HasNext()) {
+      throw std::out_of_range("Next item does not exist");
+    }
+    return ring_[head_].value();
+  }
+
+  std::pair<uint32_t, T> Next() {
+    if (!HasNext()) {
+      throw std::runtime_error("Next item does not exist");
+    }
+    auto& slot = ring_[head_];
+    std::pair<uint32_t, T> res(next_, std::move(slot.value()));
+    slot.reset();
+    head_ = (head_ + 1) & mask_;
+    next_++;
+    size_--;
+    return res;
+  }
+
+  /* For debugging */
+  size_t NumBufferredItems() const { return size_; }
+
+ private:
+  static constexpr size_t kInitialCapacity = 16;
+
+  void Grow(size_t min_capacity) {
+    size_t capacity = std::max<size_t>(ring_.size(), 1);
+    while (capacity < min_capacity) {
+      capacity <<= 1;
+    }
+    // Unroll the ring so that the head lands at the start of the new ring
+    std::vector<std::optional<T>> new_ring(capacity);
+    for (size_t i = 0; i < ring_.size(); i++) {
+      new_ring[i] = std::move(ring_[(head_ + i) & mask_]);
+    }
+    ring_.swap(new_ring);
+    mask_ = capacity - 1;
+    head_ = 0;
+  }
+
+  std::vector<std::optional<T>> ring_;
+  size_t mask_;
+  uint32_t next_;
+  size_t head_;
+  size_t size_;
+};
+
+/**
+ * The same log as AsyncLog but with the items buffered in a hash map, which
+ * takes an allocation per item. Only kept as a baseline for benchmarking.
+ */
+template <typename T>
+class MapAsyncLog {
+ public:
+  MapAsyncLog(uint32_t start_from = 0) : next_(start_from) {}
 
   void Insert(uint32_t position, const T& item) {
     if (position < next_) {
@@ -56,4 +145,4 @@ class AsyncLog {
   uint32_t next_;
 };
 
-}  // namespace slog
\ No newline at end of file
+}  // namespace slog
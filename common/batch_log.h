@@ -1,15 +1,24 @@
 #pragma once
 
+#include <memory>
 #include <queue>
 #include <unordered_map>
 
 #include "common/async_log.h"
+#include "common/spsc_queue.h"
 #include "common/types.h"
 #include "proto/internal.pb.h"
 
 namespace slog {
 
-using BatchPtr = std::unique_ptr<internal::Batch>;
+// A batch is usually owned by the arena or the envelope that it was deserialized into rather than
+// by itself. The txns of the batch share this ownership so the whole batch is freed in one shot
+// when the last of its txns is released
+using BatchPtr = std::shared_ptr<internal::Batch>;
+using TxnPtr = std::shared_ptr<Transaction>;
+
+// Hands the txns of the batches emitted by a log manager to the scheduler
+using TxnQueue = SpscQueue<TxnPtr>;
 
 class BatchLog {
  public:
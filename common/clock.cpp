@@ -3,9 +3,18 @@
 namespace slog {
 
 std::atomic<int64_t> slog_clock::offset_ = 0;
+std::atomic<int64_t> slog_clock::error_bound_ = -1;
 
 slog_clock::time_point slog_clock::now() {
   return std::chrono::system_clock::now() + std::chrono::nanoseconds(offset_);
 }
 
-}  // namespace slog
\ No newline at end of file
+std::optional<std::chrono::nanoseconds> slog_clock::error_bound() {
+  auto error_bound = error_bound_.load(std::memory_order_relaxed);
+  if (error_bound < 0) {
+    return std::nullopt;
+  }
+  return std::chrono::nanoseconds(error_bound);
+}
+
+}  // namespace slog
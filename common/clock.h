@@ -2,6 +2,7 @@
 
 #include <atomic>
 #include <chrono>
+#include <optional>
 
 namespace slog {
 
@@ -9,9 +10,17 @@ struct slog_clock {
   using time_point = std::chrono::system_clock::time_point;
   static time_point now();
 
+  /**
+   * Estimated max difference between this clock and the clocks of the machines that it is
+   * synchronized with. Unknown until the clock synchronizer has heard from a peer
+   */
+  static std::optional<std::chrono::nanoseconds> error_bound();
+
  private:
   friend class ClockSynchronizer;
   static std::atomic<int64_t> offset_;
+  // Negative if unknown
+  static std::atomic<int64_t> error_bound_;
 };
 
-}  // namespace slog
\ No newline at end of file
+}  // namespace slog
@@ -0,0 +1,62 @@
+#include "common/clock_offset_estimator.h"
+
+#include <algorithm>
+#include <cstdlib>
+
+namespace slog {
+
+ClockOffsetEstimator::ClockOffsetEstimator(size_t window_size, size_t history_size)
+    : window_size_(std::max<size_t>(window_size, 1)),
+      history_size_(std::max<size_t>(history_size, 2)),
+      best_{0, 0, 0},
+      drift_(0),
+      drift_error_(kMaxDrift) {}
+
+void ClockOffsetEstimator::AddSample(int64_t local_time, int64_t remote_time, int64_t rtt) {
+  window_.push_back({.local_time = local_time, .offset = remote_time - local_time, .rtt = std::max<int64_t>(rtt, 0)});
+  if (window_.size() > window_size_) {
+    window_.pop_front();
+  }
+
+  // Samples with the same round-trip time are equally accurate so prefer the newest one
+  auto best = window_.begin();
+  for (auto it = window_.begin(); it != window_.end(); it++) {
+    if (it->rtt <= best->rtt) {
+      best = it;
+    }
+  }
+  if (!history_.empty() && history_.back().local_time == best->local_time) {
+    return;
+  }
+  best_ = *best;
+  history_.push_back(best_);
+  if (history_.size() > history_size_) {
+    history_.pop_front();
+  }
+  UpdateDrift();
+}
+
+void ClockOffsetEstimator::UpdateDrift() {
+  if (history_.size() < 2) {
+    return;
+  }
+  const auto& first = history_.front();
+  const auto& last = history_.back();
+  auto span = static_cast<double>(last.local_time - first.local_time);
+  if (span <= 0) {
+    return;
+  }
+  // The offsets at both ends can be off by up to half of their round-trip times
+  drift_ = std::clamp((last.offset - first.offset) / span, -kMaxDrift, kMaxDrift);
+  drift_error_ = std::min((first.rtt + last.rtt) / 2 / span, kMaxDrift);
+}
+
+int64_t ClockOffsetEstimator::OffsetAt(int64_t local_time) const {
+  return best_.offset + static_cast<int64_t>(drift_ * (local_time - best_.local_time));
+}
+
+int64_t ClockOffsetEstimator::ErrorBoundAt(int64_t local_time) const {
+  return best_.rtt / 2 + static_cast<int64_t>(drift_error_ * std::abs(local_time - best_.local_time));
+}
+
+}  // namespace slog
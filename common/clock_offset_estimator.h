@@ -0,0 +1,75 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+
+namespace slog {
+
+/**
+ * Estimates the offset of a remote clock from the local clock in the style of NTP.
+ *
+ * Each sample is a remote clock reading taken during a round trip. Its error is at most half of
+ * the round-trip time, so among the recent samples only the one with the lowest round-trip time
+ * is used. The samples selected this way over time are used to estimate the drift, i.e. how fast
+ * the offset changes, so that the offset can be extrapolated between samples.
+ *
+ * All times are in nanoseconds.
+ */
+class ClockOffsetEstimator {
+ public:
+  /**
+   * @param window_size  Number of recent samples among which the one with the lowest round-trip
+   *                     time is selected
+   * @param history_size Number of selected samples over which the drift is estimated
+   */
+  ClockOffsetEstimator(size_t window_size, size_t history_size = 8);
+
+  /**
+   * @param local_time  Local time at the middle of the round trip
+   * @param remote_time Remote time read during the round trip
+   * @param rtt         Round-trip time
+   */
+  void AddSample(int64_t local_time, int64_t remote_time, int64_t rtt);
+
+  bool has_estimate() const { return !window_.empty(); }
+
+  /**
+   * @return Estimated remote time minus local time at the given local time
+   */
+  int64_t OffsetAt(int64_t local_time) const;
+
+  /**
+   * @return Bound of the error of OffsetAt at the given local time, which grows with the
+   *         distance from the selected sample by the uncertainty of the drift
+   */
+  int64_t ErrorBoundAt(int64_t local_time) const;
+
+  // Change of the offset per unit of local time
+  double drift() const { return drift_; }
+
+  int64_t min_rtt() const { return best_.rtt; }
+
+  // Largest drift assumed to be possible. This accounts for the frequency error of the local
+  // and remote oscillators as well as the remote clock being slewed
+  static constexpr double kMaxDrift = 1e-3;
+
+ private:
+  struct Sample {
+    int64_t local_time;
+    int64_t offset;
+    int64_t rtt;
+  };
+
+  void UpdateDrift();
+
+  size_t window_size_;
+  size_t history_size_;
+  std::deque<Sample> window_;
+  std::deque<Sample> history_;
+  Sample best_;
+  double drift_;
+  double drift_error_;
+};
+
+}  // namespace slog
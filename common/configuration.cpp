@@ -51,17 +51,28 @@ Configuration::Configuration(const internal::Configuration& config, const string
   CHECK_LT(config_.regions_size(), kMaxNumLogs) << "Too many reigons";
   CHECK_LE(config_.num_log_managers(), config_.regions_size())
       << "Number of log managers cannot exceed number of regions";
+  CHECK_LE(config_.sequencer_min_batch_duration_us(), config_.sequencer_max_batch_duration_us())
+      << "Min sequencer batch duration cannot exceed max sequencer batch duration";
+  CHECK_LE(config_.mh_orderer_min_batch_duration_us(), config_.mh_orderer_max_batch_duration_us())
+      << "Min mh orderer batch duration cannot exceed max mh orderer batch duration";
+
+#ifdef REMASTER_PROTOCOL_COUNTERLESS
+  CHECK_NE(config_.lock_manager(), internal::LockManagerType::OLD)
+      << "COUNTERLESS remaster protocol is not compatible with OLD lock manager";
+#endif
+#if defined(REMASTER_PROTOCOL_SIMPLE) || defined(REMASTER_PROTOCOL_PER_KEY)
+  CHECK_EQ(config_.lock_manager(), internal::LockManagerType::OLD)
+      << "SIMPLE and PER_KEY remaster protocols are only compatible with OLD lock manager";
+#endif
 
   if (config_.force_bypass_mh_orderer()) {
     config_.set_bypass_mh_orderer(true);
-  } else {
-#ifdef LOCK_MANAGER_DDR
+  } else if (lock_manager() == internal::LockManagerType::DDR) {
     CHECK(!config_.bypass_mh_orderer() || config_.ddr_interval() > 0)
         << "Deadlock resolver must be enabled in orderer-bypassing mode";
-#else
+  } else {
     CHECK(!config_.bypass_mh_orderer() || config_.synchronized_batching())
         << "Batching by timestamp must be enabled in orderer-bypassing mode";
-#endif
   }
 
   bool local_address_is_valid = local_address_.empty();
@@ -190,6 +201,22 @@ std::chrono::milliseconds Configuration::mh_orderer_batch_duration() const {
   return milliseconds(config_.mh_orderer_batch_duration());
 }
 
+int Configuration::mh_orderer_batch_size() const { return config_.mh_orderer_batch_size(); }
+
+bool Configuration::adaptive_mh_orderer_batching() const { return config_.mh_orderer_max_batch_duration_us() > 0; }
+
+std::chrono::microseconds Configuration::mh_orderer_min_batch_duration() const {
+  return std::chrono::microseconds(config_.mh_orderer_min_batch_duration_us());
+}
+
+std::chrono::microseconds Configuration::mh_orderer_max_batch_duration() const {
+  return std::chrono::microseconds(config_.mh_orderer_max_batch_duration_us());
+}
+
+uint32_t Configuration::mh_orderer_target_backlog() const {
+  return config_.mh_orderer_target_backlog() == 0 ? 2 : config_.mh_orderer_target_backlog();
+}
+
 milliseconds Configuration::forwarder_batch_duration() const {
   return milliseconds(config_.forwarder_batch_duration());
 }
@@ -203,8 +230,32 @@ milliseconds Configuration::sequencer_batch_duration() const {
 
 int Configuration::sequencer_batch_size() const { return config_.sequencer_batch_size(); }
 
+bool Configuration::adaptive_sequencer_batching() const { return config_.sequencer_max_batch_duration_us() > 0; }
+
+std::chrono::microseconds Configuration::sequencer_min_batch_duration() const {
+  return std::chrono::microseconds(config_.sequencer_min_batch_duration_us());
+}
+
+std::chrono::microseconds Configuration::sequencer_max_batch_duration() const {
+  return std::chrono::microseconds(config_.sequencer_max_batch_duration_us());
+}
+
+uint32_t Configuration::sequencer_target_backlog() const {
+  return config_.sequencer_target_backlog() == 0 ? 1000 : config_.sequencer_target_backlog();
+}
+
 bool Configuration::sequencer_rrr() const { return config_.sequencer_rrr(); }
 
+uint32_t Configuration::paxos_window_size() const { return config_.paxos_window_size(); }
+
+const internal::PaxosDurability& Configuration::local_paxos_durability() const {
+  return config_.local_paxos_durability();
+}
+
+const internal::PaxosDurability& Configuration::global_paxos_durability() const {
+  return config_.global_paxos_durability();
+}
+
 uint32_t Configuration::replication_factor() const { return std::max(config_.replication_factor(), 1U); }
 
 bool Configuration::local_sync_replication() const { return config_.regions(local_region_).sync_replication(); }
@@ -242,6 +293,8 @@ bool Configuration::bypass_mh_orderer() const { return config_.bypass_mh_orderer
 
 milliseconds Configuration::ddr_interval() const { return milliseconds(config_.ddr_interval()); };
 
+bool Configuration::ddr_compact_graph_log() const { return config_.ddr_compact_graph_log(); }
+
 vector<int> Configuration::cpu_pinnings(ModuleId module) const {
   vector<int> cpus;
   for (auto& entry : config_.cpu_pinnings()) {
@@ -266,8 +319,16 @@ milliseconds Configuration::clock_sync_interval() const { return milliseconds(co
 
 int64_t Configuration::timestamp_buffer_us() const { return config_.timestamp_buffer_us(); }
 
+bool Configuration::dynamic_timestamp_buffer() const { return config_.dynamic_timestamp_buffer(); }
+
+uint32_t Configuration::clock_max_slew_ppm() const {
+  return config_.clock_max_slew_ppm() == 0 ? 500 : config_.clock_max_slew_ppm();
+}
+
 uint32_t Configuration::avg_latency_window_size() const { return std::max(config_.avg_latency_window_size(), 1U); }
 
+double Configuration::mh_timestamp_latency_percentile() const { return config_.mh_timestamp_latency_percentile(); }
+
 bool Configuration::shrink_mh_orderer() const { return config_.regions(local_region_).shrink_mh_orderer(); };
 
 std::vector<int> Configuration::distance_ranking_from(RegionId region_id) const {
@@ -287,4 +348,30 @@ int Configuration::long_sender_sndbuf() const {
 
 int Configuration::tps_limit() const { return config_.tps_limit(); }
 
+bool Configuration::worker_key_affinity() const { return config_.worker_key_affinity(); }
+
+int Configuration::worker_affinity_max_load() const {
+  return config_.worker_affinity_max_load() == 0 ? 16 : config_.worker_affinity_max_load();
+}
+
+internal::LockManagerType Configuration::lock_manager() const { return config_.lock_manager(); }
+
+std::chrono::microseconds Configuration::remote_read_batch_duration() const {
+  return std::chrono::microseconds(config_.remote_read_batch_duration_us());
+}
+
+bool Configuration::speculative_multi_home() const { return config_.speculative_multi_home(); }
+
+bool Configuration::priority_dispatch() const { return config_.priority_dispatch(); }
+
+uint32_t Configuration::forwarder_metadata_cache_size() const { return config_.forwarder_metadata_cache_size(); }
+
+internal::WireFormat Configuration::wire_format() const { return config_.wire_format(); }
+
+uint32_t Configuration::sender_coalescing_bytes() const { return config_.sender_coalescing_bytes(); }
+
+uint32_t Configuration::server_max_in_flight_txns() const { return config_.server_max_in_flight_txns(); }
+
+uint32_t Configuration::server_admission_queue_size() const { return config_.server_admission_queue_size(); }
+
 }  // namespace slog
\ No newline at end of file
@@ -37,10 +37,22 @@ class Configuration {
   int num_log_managers() const;
   std::vector<MachineId> all_machine_ids() const;
   std::chrono::milliseconds mh_orderer_batch_duration() const;
+  int mh_orderer_batch_size() const;
+  bool adaptive_mh_orderer_batching() const;
+  std::chrono::microseconds mh_orderer_min_batch_duration() const;
+  std::chrono::microseconds mh_orderer_max_batch_duration() const;
+  uint32_t mh_orderer_target_backlog() const;
   std::chrono::milliseconds forwarder_batch_duration() const;
   std::chrono::milliseconds sequencer_batch_duration() const;
   int sequencer_batch_size() const;
+  bool adaptive_sequencer_batching() const;
+  std::chrono::microseconds sequencer_min_batch_duration() const;
+  std::chrono::microseconds sequencer_max_batch_duration() const;
+  uint32_t sequencer_target_backlog() const;
   bool sequencer_rrr() const;
+  uint32_t paxos_window_size() const;
+  const internal::PaxosDurability& local_paxos_durability() const;
+  const internal::PaxosDurability& global_paxos_durability() const;
   uint32_t replication_factor() const;
   bool local_sync_replication() const;
 
@@ -59,6 +71,7 @@ class Configuration {
   std::vector<TransactionEvent> enabled_events() const;
   bool bypass_mh_orderer() const;
   std::chrono::milliseconds ddr_interval() const;
+  bool ddr_compact_graph_log() const;
   std::vector<int> cpu_pinnings(ModuleId module) const;
   internal::ExecutionType execution_type() const;
   const std::vector<uint32_t>& replication_order() const;
@@ -67,13 +80,27 @@ class Configuration {
   std::chrono::milliseconds fs_latency_interval() const;
   std::chrono::milliseconds clock_sync_interval() const;
   int64_t timestamp_buffer_us() const;
+  bool dynamic_timestamp_buffer() const;
+  uint32_t clock_max_slew_ppm() const;
   uint32_t avg_latency_window_size() const;
+  double mh_timestamp_latency_percentile() const;
   bool shrink_mh_orderer() const;
   std::vector<int> distance_ranking_from(RegionId region_id) const;
 
   int broker_rcvbuf() const;
   int long_sender_sndbuf() const;
   int tps_limit() const;
+  bool worker_key_affinity() const;
+  int worker_affinity_max_load() const;
+  internal::LockManagerType lock_manager() const;
+  std::chrono::microseconds remote_read_batch_duration() const;
+  bool speculative_multi_home() const;
+  bool priority_dispatch() const;
+  uint32_t forwarder_metadata_cache_size() const;
+  internal::WireFormat wire_format() const;
+  uint32_t sender_coalescing_bytes() const;
+  uint32_t server_max_in_flight_txns() const;
+  uint32_t server_admission_queue_size() const;
 
  private:
   internal::Configuration config_;
@@ -35,6 +35,11 @@ const Channel kMaxChannel = 70;
 // anything larger than or equal to kMaxNumMachines must be reserved for workers' tags.
 // The range [kMaxChannel, kMaxNumMachines) is reserved for the log managers.
 const uint32_t kMaxNumMachines = 100;
+// Worker tags are made from TxnIds so they are at least 10 * kMaxNumMachines. This tag, which
+// is below that, is used for batches of remote reads that the broker splits among the workers.
+const Channel kRemoteReadBatchTag = kMaxNumMachines;
+// Tag of a frame holding several small messages coalesced by a Sender, which the receiver splits
+const Channel kCoalescedMessagesTag = kMaxNumMachines + 1;
 
 constexpr Channel kMaxNumBrokers = kLogManagerChannel - kBrokerChannel;
 constexpr Channel kMaxNumLogManagers = kWorkerChannel - kLogManagerChannel;
@@ -45,8 +50,14 @@ const uint32_t kPaxosDefaultLeaderPosition = 0;
 
 const size_t kLockTableSizeLimit = 1000000;
 
+// Max number of early-aborted txns for which a worker still absorbs late remote reads
+const size_t kWorkerTombstoneLimit = 10000;
+
 const int kRecvRetries = 4000;
 
+// Smallest first block of the arena that an incoming envelope is deserialized into
+const size_t kMinArenaBlockSize = 1024;
+
 // We never use 0 for txn id
 const TxnId kSentinelTxnId = 0;
 
@@ -60,12 +71,19 @@ const char NUM_PENDING_RESPONSES[] = "num_pending_responses";
 const char NUM_PARTIALLY_FINISHED_TXNS[] = "num_partially_finished_txns";
 const char PENDING_RESPONSES[] = "pending_responses";
 const char PARTIALLY_FINISHED_TXNS[] = "partially_finished_txns";
+const char NUM_IN_FLIGHT_TXNS[] = "num_in_flight_txns";
+const char NUM_TXNS_WAITING_FOR_ADMISSION[] = "num_txns_waiting_for_admission";
+const char NUM_SHED_TXNS[] = "num_shed_txns";
 
 /* Forwarder */
 const char FORW_LATENCIES_NS[] = "forw_latencies_us";
 const char FORW_BATCH_SIZE[] = "forw_batch_size";
 const char FORW_NUM_PENDING_TXNS[] = "forw_num_pending_txns";
 const char FORW_PENDING_TXNS[] = "forw_pending_txns";
+const char FORW_METADATA_CACHE_SIZE[] = "forw_metadata_cache_size";
+const char FORW_METADATA_CACHE_HITS[] = "forw_metadata_cache_hits";
+const char FORW_METADATA_CACHE_MISSES[] = "forw_metadata_cache_misses";
+const char FORW_METADATA_CACHE_HIT_RATE[] = "forw_metadata_cache_hit_rate";
 
 /* Sequencer */
 const char SEQ_NUM_FUTURE_TXNS[] = "seq_num_future_txns";
@@ -95,5 +113,13 @@ const char TXN_NUM_DISPATCHES[] = "num_dispatches";
 const char TXN_EXPECTED_NUM_LO[] = "expected_num_lo";
 const char TXN_MULTI_HOME[] = "multi_home";
 const char TXN_MULTI_PARTITION[] = "multi_partition";
+const char WORKER_LOADS[] = "worker_loads";
+const char WORKER_CACHE_MISSES[] = "worker_cache_misses";
+const char NUM_AFFINITY_DISPATCHES[] = "num_affinity_dispatches";
+const char NUM_AFFINITY_FALLBACKS[] = "num_affinity_fallbacks";
+const char NUM_REMOTE_READ_BATCHES[] = "num_remote_read_batches";
+const char NUM_COALESCED_REMOTE_READS[] = "num_coalesced_remote_reads";
+const char NUM_SPECULATIONS[] = "num_speculations";
+const char NUM_COMMITTED_SPECULATIONS[] = "num_committed_speculations";
 
 }  // namespace slog
\ No newline at end of file
@@ -0,0 +1,175 @@
+/**
+ * flat_hash_map.h
+ *
+ * A single-threaded hash map with open addressing and linear probing. The entries are stored
+ * directly in one array so a lookup touches a few adjacent slots instead of chasing the node
+ * pointers of std::unordered_map, and inserting or erasing an entry does not allocate.
+ *
+ * Erasing uses backward-shift deletion so no tombstones are left behind. Because entries are
+ * moved on erase and on rehash, pointers and iterators to entries are invalidated by any insert
+ * or erase. Store pointers (e.g. from an ObjectPool) as values if they need stable addresses.
+ */
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <optional>
+#include <utility>
+#include <vector>
+
+namespace slog {
+
+template <typename KeyType, typename ValueType, typename HashFn = std::hash<KeyType>>
+class FlatHashMap {
+  using Slot = std::optional<std::pair<KeyType, ValueType>>;
+
+  // Grow when the map is more than 3/4 full
+  static constexpr size_t kMaxLoadNumerator = 3;
+  static constexpr size_t kMaxLoadDenominator = 4;
+
+  template <typename MapT, typename EntryT>
+  class IteratorT {
+   public:
+    IteratorT(MapT* map, size_t idx) : map_(map), idx_(idx) { SkipEmpty(); }
+
+    EntryT& operator*() const { return *map_->slots_[idx_]; }
+    EntryT* operator->() const { return &*map_->slots_[idx_]; }
+
+    IteratorT& operator++() {
+      idx_++;
+      SkipEmpty();
+      return *this;
+    }
+
+    bool operator==(const IteratorT& other) const { return idx_ == other.idx_; }
+    bool operator!=(const IteratorT& other) const { return idx_ != other.idx_; }
+
+   private:
+    friend class FlatHashMap;
+
+    void SkipEmpty() {
+      while (idx_ < map_->slots_.size() && !map_->slots_[idx_].has_value()) {
+        idx_++;
+      }
+    }
+
+    MapT* map_;
+    size_t idx_;
+  };
+
+ public:
+  using value_type = std::pair<KeyType, ValueType>;
+  using iterator = IteratorT<FlatHashMap, value_type>;
+  using const_iterator = IteratorT<const FlatHashMap, const value_type>;
+
+  /**
+   * The capacity is rounded up to a power of 2
+   */
+  explicit FlatHashMap(size_t initial_capacity = 64) : size_(0) { Rehash(initial_capacity); }
+
+  iterator begin() { return iterator(this, 0); }
+  iterator end() { return iterator(this, slots_.size()); }
+  const_iterator begin() const { return const_iterator(this, 0); }
+  const_iterator end() const { return const_iterator(this, slots_.size()); }
+
+  size_t size() const { return size_; }
+  bool empty() const { return size_ == 0; }
+
+  iterator find(const KeyType& key) { return iterator(this, FindIndex(key)); }
+  const_iterator find(const KeyType& key) const { return const_iterator(this, FindIndex(key)); }
+
+  /**
+   * Constructs the value in place if the key does not exist. Otherwise does nothing.
+   *
+   * @return Iterator to the entry of the key and whether the value is constructed
+   */
+  template <typename... Args>
+  std::pair<iterator, bool> try_emplace(const KeyType& key, Args&&... args) {
+    if (auto idx = FindIndex(key); idx != slots_.size()) {
+      return {iterator(this, idx), false};
+    }
+    if ((size_ + 1) * kMaxLoadDenominator > slots_.size() * kMaxLoadNumerator) {
+      Rehash(slots_.size() * 2);
+    }
+    auto idx = HomeIndex(key);
+    while (slots_[idx].has_value()) {
+      idx = (idx + 1) & mask_;
+    }
+    slots_[idx].emplace(std::piecewise_construct, std::forward_as_tuple(key),
+                        std::forward_as_tuple(std::forward<Args>(args)...));
+    size_++;
+    return {iterator(this, idx), true};
+  }
+
+  void erase(iterator it) { EraseIndex(it.idx_); }
+
+  size_t erase(const KeyType& key) {
+    auto idx = FindIndex(key);
+    if (idx == slots_.size()) {
+      return 0;
+    }
+    EraseIndex(idx);
+    return 1;
+  }
+
+ private:
+  // Fibonacci hashing spreads keys whose hashes only differ in the high bits, such as txn ids,
+  // which std::hash maps to themselves
+  size_t HomeIndex(const KeyType& key) const {
+    return (static_cast<uint64_t>(HashFn{}(key)) * 11400714819323198485ULL) >> shift_;
+  }
+
+  size_t FindIndex(const KeyType& key) const {
+    for (auto idx = HomeIndex(key); slots_[idx].has_value(); idx = (idx + 1) & mask_) {
+      if (slots_[idx]->first == key) {
+        return idx;
+      }
+    }
+    return slots_.size();
+  }
+
+  void EraseIndex(size_t hole) {
+    slots_[hole].reset();
+    size_--;
+    // Shift back the following entries of the same cluster that would not be found past the hole
+    for (auto idx = (hole + 1) & mask_; slots_[idx].has_value(); idx = (idx + 1) & mask_) {
+      auto home = HomeIndex(slots_[idx]->first);
+      // Distance from the home slot is compared to avoid dealing with wrapping around
+      if (((idx - home) & mask_) >= ((idx - hole) & mask_)) {
+        slots_[hole] = std::move(slots_[idx]);
+        slots_[idx].reset();
+        hole = idx;
+      }
+    }
+  }
+
+  void Rehash(size_t min_capacity) {
+    size_t capacity = 2;
+    int bits = 1;
+    while (capacity < min_capacity) {
+      capacity <<= 1;
+      bits++;
+    }
+    std::vector<Slot> old_slots(capacity);
+    old_slots.swap(slots_);
+    mask_ = capacity - 1;
+    shift_ = 64 - bits;
+    for (auto& slot : old_slots) {
+      if (slot.has_value()) {
+        auto idx = HomeIndex(slot->first);
+        while (slots_[idx].has_value()) {
+          idx = (idx + 1) & mask_;
+        }
+        slots_[idx] = std::move(slot);
+      }
+    }
+  }
+
+  std::vector<Slot> slots_;
+  size_t size_;
+  size_t mask_;
+  int shift_;
+};
+
+}  // namespace slog
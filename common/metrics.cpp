@@ -90,7 +90,7 @@ class DeadlockResolverRunMetrics {
       : sampler_(sample_rate, 1), local_region_(local_region), local_partition_(local_partition) {}
 
   void Record(int64_t runtime, size_t unstable_graph_sz, size_t stable_graph_sz, size_t deadlocks_resolved,
-              int64_t graph_update_time) {
+              int64_t graph_update_time, size_t graph_log_bytes, size_t sent_graph_log_bytes) {
     if (sampler_.IsChosen(0)) {
       data_.push_back({.time = system_clock::now().time_since_epoch().count(),
                        .partition = local_partition_,
@@ -99,7 +99,9 @@ class DeadlockResolverRunMetrics {
                        .unstable_graph_sz = unstable_graph_sz,
                        .stable_graph_sz = stable_graph_sz,
                        .deadlocks_resolved = deadlocks_resolved,
-                       .graph_update_time = graph_update_time});
+                       .graph_update_time = graph_update_time,
+                       .graph_log_bytes = graph_log_bytes,
+                       .sent_graph_log_bytes = sent_graph_log_bytes});
     }
   }
 
@@ -112,16 +114,20 @@ class DeadlockResolverRunMetrics {
     size_t stable_graph_sz;
     size_t deadlocks_resolved;
     int64_t graph_update_time;
+    size_t graph_log_bytes;       // size of the graph log in the plain GraphLog format
+    size_t sent_graph_log_bytes;  // size of the graph log actually broadcasted
   };
   list<Data>& data() { return data_; }
 
   static void WriteToDisk(const std::string& dir, const list<Data>& data) {
     CSVWriter deadlock_resolver_csv(dir + "/deadlock_resolver.csv",
                                     {"time", "partition", "region", "runtime", "unstable_graph_sz", "stable_graph_sz",
-                                     "deadlocks_resolved", "graph_update_time"});
+                                     "deadlocks_resolved", "graph_update_time", "graph_log_bytes",
+                                     "sent_graph_log_bytes"});
     for (const auto& d : data) {
       deadlock_resolver_csv << d.time << d.partition << d.region << d.runtime << d.unstable_graph_sz
-                            << d.stable_graph_sz << d.deadlocks_resolved << d.graph_update_time << csvendl;
+                            << d.stable_graph_sz << d.deadlocks_resolved << d.graph_update_time << d.graph_log_bytes
+                            << d.sent_graph_log_bytes << csvendl;
     }
   }
 
@@ -266,7 +272,7 @@ class ClockSyncMetrics {
   ClockSyncMetrics(int sample_rate) : sampler_(sample_rate, 1) {}
 
   void Record(uint32_t dst, int64_t src_time, int64_t dst_time, int64_t src_recv_time, int64_t local_slog_time,
-              int64_t avg_latency, int64_t new_offset) {
+              int64_t avg_latency, int64_t new_offset, int64_t error_bound) {
     if (sampler_.IsChosen(0)) {
       data_.push_back({.dst = dst,
                        .src_time = src_time,
@@ -274,7 +280,8 @@ class ClockSyncMetrics {
                        .src_recv_time = src_recv_time,
                        .local_slog_time = local_slog_time,
                        .avg_latency = avg_latency,
-                       .new_offset = new_offset});
+                       .new_offset = new_offset,
+                       .error_bound = error_bound});
     }
   }
 
@@ -286,15 +293,17 @@ class ClockSyncMetrics {
     int64_t local_slog_time;
     int64_t avg_latency;
     int64_t new_offset;
+    int64_t error_bound;
   };
   list<Data>& data() { return data_; }
 
   static void WriteToDisk(const std::string& dir, const list<Data>& data) {
-    CSVWriter clock_sync_csv(dir + "/clock_sync.csv", {"dst", "src_time", "dst_time", "src_recv_time",
-                                                       "local_slog_time", "avg_latency", "new_offset"});
+    CSVWriter clock_sync_csv(dir + "/clock_sync.csv",
+                             {"dst", "src_time", "dst_time", "src_recv_time", "local_slog_time", "avg_latency",
+                              "new_offset", "error_bound"});
     for (const auto& d : data) {
       clock_sync_csv << d.dst << d.src_time << d.dst_time << d.src_recv_time << d.local_slog_time << d.avg_latency
-                     << d.new_offset << csvendl;
+                     << d.new_offset << d.error_bound << csvendl;
     }
   }
 
@@ -307,9 +316,13 @@ class BatchMetrics {
  public:
   BatchMetrics(int sample_rate) : sampler_(sample_rate, 1) {}
 
-  void Record(BatchId batch_id, size_t batch_size, int64_t batch_duration) {
+  // batch_window is the time the batch was allowed to stay open, or 0 if not recorded
+  void Record(BatchId batch_id, size_t batch_size, int64_t batch_duration, int64_t batch_window = 0) {
     if (sampler_.IsChosen(0)) {
-      data_.push_back({.batch_id = batch_id, .batch_size = batch_size, .batch_duration = batch_duration});
+      data_.push_back({.batch_id = batch_id,
+                       .batch_size = batch_size,
+                       .batch_duration = batch_duration,
+                       .batch_window = batch_window});
     }
   }
 
@@ -317,13 +330,121 @@ class BatchMetrics {
     BatchId batch_id;
     size_t batch_size;
     int64_t batch_duration;
+    int64_t batch_window;
   };
   list<Data>& data() { return data_; }
 
   static void WriteToDisk(const std::string& file_path, const list<Data>& data) {
-    CSVWriter batch_csv(file_path, {"batch_id", "batch_size", "batch_duration"});
+    CSVWriter batch_csv(file_path, {"batch_id", "batch_size", "batch_duration", "batch_window"});
     for (const auto& d : data) {
-      batch_csv << d.batch_id << d.batch_size << d.batch_duration << csvendl;
+      batch_csv << d.batch_id << d.batch_size << d.batch_duration << d.batch_window << csvendl;
+    }
+  }
+
+ private:
+  Sampler sampler_;
+  list<Data> data_;
+};
+
+class MHOrdererBatchMetrics {
+ public:
+  MHOrdererBatchMetrics(int sample_rate) : sampler_(sample_rate, 1) {}
+
+  // order_duration is the time from sending the batch to receiving its global order, or -1 if the
+  // order is not received by the orderer that sent the batch
+  void Record(BatchId batch_id, size_t batch_size, int64_t batch_duration, int64_t batch_window,
+              int64_t order_duration) {
+    if (sampler_.IsChosen(0)) {
+      data_.push_back({.batch_id = batch_id,
+                       .batch_size = batch_size,
+                       .batch_duration = batch_duration,
+                       .batch_window = batch_window,
+                       .order_duration = order_duration});
+    }
+  }
+
+  struct Data {
+    BatchId batch_id;
+    size_t batch_size;
+    int64_t batch_duration;
+    int64_t batch_window;
+    int64_t order_duration;
+  };
+  list<Data>& data() { return data_; }
+
+  static void WriteToDisk(const std::string& dir, const list<Data>& data) {
+    CSVWriter batch_csv(dir + "/mhorderer_batch.csv",
+                        {"batch_id", "batch_size", "batch_duration", "batch_window", "order_duration"});
+    for (const auto& d : data) {
+      batch_csv << d.batch_id << d.batch_size << d.batch_duration << d.batch_window << d.order_duration << csvendl;
+    }
+  }
+
+ private:
+  Sampler sampler_;
+  list<Data> data_;
+};
+
+class PaxosSyncMetrics {
+ public:
+  PaxosSyncMetrics(int sample_rate) : sampler_(sample_rate, 1) {}
+
+  // added_latency is the time from the first record of the synced group entering the log to the end of the sync
+  void Record(Channel group, size_t num_records, size_t num_bytes, int64_t sync_duration, int64_t added_latency) {
+    if (sampler_.IsChosen(0)) {
+      data_.push_back({.group = group,
+                       .num_records = num_records,
+                       .num_bytes = num_bytes,
+                       .sync_duration = sync_duration,
+                       .added_latency = added_latency});
+    }
+  }
+
+  struct Data {
+    Channel group;
+    size_t num_records;
+    size_t num_bytes;
+    int64_t sync_duration;
+    int64_t added_latency;
+  };
+  list<Data>& data() { return data_; }
+
+  static void WriteToDisk(const std::string& dir, const list<Data>& data) {
+    CSVWriter paxos_sync_csv(dir + "/paxos_sync.csv",
+                             {"group", "num_records", "num_bytes", "sync_duration", "added_latency"});
+    for (const auto& d : data) {
+      paxos_sync_csv << d.group << d.num_records << d.num_bytes << d.sync_duration << d.added_latency << csvendl;
+    }
+  }
+
+ private:
+  Sampler sampler_;
+  list<Data> data_;
+};
+
+class LateArrivalMetrics {
+ public:
+  LateArrivalMetrics(int sample_rate) : sampler_(sample_rate, 1) {}
+
+  void Record(int64_t time, uint32_t from_region, uint64_t num_txns, uint64_t num_late_txns) {
+    if (sampler_.IsChosen(0)) {
+      data_.push_back(
+          {.time = time, .from_region = from_region, .num_txns = num_txns, .num_late_txns = num_late_txns});
+    }
+  }
+
+  struct Data {
+    int64_t time;
+    uint32_t from_region;
+    uint64_t num_txns;
+    uint64_t num_late_txns;
+  };
+  list<Data>& data() { return data_; }
+
+  static void WriteToDisk(const std::string& dir, const list<Data>& data) {
+    CSVWriter late_arrivals_csv(dir + "/late_arrivals.csv", {"time", "from_region", "num_txns", "num_late_txns"});
+    for (const auto& d : data) {
+      late_arrivals_csv << d.time << d.from_region << d.num_txns << d.num_late_txns << csvendl;
     }
   }
 
@@ -407,7 +528,9 @@ struct AllMetrics {
   ClockSyncMetrics clock_sync_metrics;
   BatchMetrics forwarder_batch_metrics;
   BatchMetrics sequencer_batch_metrics;
-  BatchMetrics mhorderer_batch_metrics;
+  MHOrdererBatchMetrics mhorderer_batch_metrics;
+  PaxosSyncMetrics paxos_sync_metrics;
+  LateArrivalMetrics late_arrival_metrics;
   TxnTimestampMetrics txn_timestamp_metrics;
   GenericMetrics generic_metrics;
 };
@@ -425,10 +548,12 @@ system_clock::time_point MetricsRepository::RecordTxnEvent(TxnId txn_id, Transac
 
 void MetricsRepository::RecordDeadlockResolverRun(int64_t running_time, size_t unstable_graph_sz,
                                                   size_t stable_graph_sz, size_t deadlocks_resolved,
-                                                  int64_t graph_update_time) {
+                                                  int64_t graph_update_time, size_t graph_log_bytes,
+                                                  size_t sent_graph_log_bytes) {
   std::lock_guard<SpinLatch> guard(latch_);
   return metrics_->deadlock_resolver_run_metrics.Record(running_time, unstable_graph_sz, stable_graph_sz,
-                                                        deadlocks_resolved, graph_update_time);
+                                                        deadlocks_resolved, graph_update_time, graph_log_bytes,
+                                                        sent_graph_log_bytes);
 }
 
 void MetricsRepository::RecordDeadlockResolverDeadlock(int num_vertices,
@@ -456,10 +581,11 @@ void MetricsRepository::RecordForwSequLatency(uint32_t region, int64_t src_time,
 }
 
 void MetricsRepository::RecordClockSync(uint32_t dst, int64_t src_time, int64_t dst_time, int64_t src_recv_time,
-                                        int64_t local_slog_time, int64_t avg_latency, int64_t new_offset) {
+                                        int64_t local_slog_time, int64_t avg_latency, int64_t new_offset,
+                                        int64_t error_bound) {
   std::lock_guard<SpinLatch> guard(latch_);
   return metrics_->clock_sync_metrics.Record(dst, src_time, dst_time, src_recv_time, local_slog_time, avg_latency,
-                                             new_offset);
+                                             new_offset, error_bound);
 }
 
 void MetricsRepository::RecordForwarderBatch(size_t batch_size, int64_t batch_duration) {
@@ -467,14 +593,28 @@ void MetricsRepository::RecordForwarderBatch(size_t batch_size, int64_t batch_du
   return metrics_->forwarder_batch_metrics.Record(0, batch_size, batch_duration);
 }
 
-void MetricsRepository::RecordSequencerBatch(BatchId batch_id, size_t batch_size, int64_t batch_duration) {
+void MetricsRepository::RecordSequencerBatch(BatchId batch_id, size_t batch_size, int64_t batch_duration,
+                                             int64_t batch_window) {
+  std::lock_guard<SpinLatch> guard(latch_);
+  return metrics_->sequencer_batch_metrics.Record(batch_id, batch_size, batch_duration, batch_window);
+}
+
+void MetricsRepository::RecordMHOrdererBatch(BatchId batch_id, size_t batch_size, int64_t batch_duration,
+                                             int64_t batch_window, int64_t order_duration) {
+  std::lock_guard<SpinLatch> guard(latch_);
+  return metrics_->mhorderer_batch_metrics.Record(batch_id, batch_size, batch_duration, batch_window, order_duration);
+}
+
+void MetricsRepository::RecordPaxosSync(Channel group, size_t num_records, size_t num_bytes, int64_t sync_duration,
+                                        int64_t added_latency) {
   std::lock_guard<SpinLatch> guard(latch_);
-  return metrics_->sequencer_batch_metrics.Record(batch_id, batch_size, batch_duration);
+  return metrics_->paxos_sync_metrics.Record(group, num_records, num_bytes, sync_duration, added_latency);
 }
 
-void MetricsRepository::RecordMHOrdererBatch(BatchId batch_id, size_t batch_size, int64_t batch_duration) {
+void MetricsRepository::RecordLateArrivals(int64_t time, uint32_t from_region, uint64_t num_txns,
+                                           uint64_t num_late_txns) {
   std::lock_guard<SpinLatch> guard(latch_);
-  return metrics_->mhorderer_batch_metrics.Record(batch_id, batch_size, batch_duration);
+  return metrics_->late_arrival_metrics.Record(time, from_region, num_txns, num_late_txns);
 }
 
 void MetricsRepository::RecordTxnTimestamp(TxnId txn_id, uint32_t from, int64_t txn_timestamp, int64_t server_time) {
@@ -503,7 +643,9 @@ std::unique_ptr<AllMetrics> MetricsRepository::Reset() {
        .clock_sync_metrics = ClockSyncMetrics(config_->metric_options().clock_sync_sample()),
        .forwarder_batch_metrics = BatchMetrics(config_->metric_options().forwarder_batch_sample()),
        .sequencer_batch_metrics = BatchMetrics(config_->metric_options().sequencer_batch_sample()),
-       .mhorderer_batch_metrics = BatchMetrics(config_->metric_options().mhorderer_batch_sample()),
+       .mhorderer_batch_metrics = MHOrdererBatchMetrics(config_->metric_options().mhorderer_batch_sample()),
+       .paxos_sync_metrics = PaxosSyncMetrics(config_->metric_options().paxos_sync_sample()),
+       .late_arrival_metrics = LateArrivalMetrics(config_->metric_options().late_arrival_sample()),
        .txn_timestamp_metrics = TxnTimestampMetrics(config_->metric_options().txn_timestamp_sample()),
        .generic_metrics = GenericMetrics(config_->metric_options().generic_sample(), local_region, local_partition)}));
 
@@ -537,7 +679,10 @@ void MetricsRepositoryManager::AggregateAndFlushToDisk(const std::string& dir) {
   vector<LogManagerLogs::Data> global_log;
   list<ForwSequLatencyMetrics::Data> forw_sequ_latency_data;
   list<ClockSyncMetrics::Data> clock_sync_data;
-  list<BatchMetrics::Data> forwarder_batch_data, sequencer_batch_data, mhorderer_batch_data;
+  list<BatchMetrics::Data> forwarder_batch_data, sequencer_batch_data;
+  list<MHOrdererBatchMetrics::Data> mhorderer_batch_data;
+  list<PaxosSyncMetrics::Data> paxos_sync_data;
+  list<LateArrivalMetrics::Data> late_arrival_data;
   list<TxnTimestampMetrics::Data> txn_timestamp_data;
   list<GenericMetrics::Data> generic_data;
   {
@@ -558,6 +703,8 @@ void MetricsRepositoryManager::AggregateAndFlushToDisk(const std::string& dir) {
       forwarder_batch_data.splice(forwarder_batch_data.end(), metrics->forwarder_batch_metrics.data());
       sequencer_batch_data.splice(sequencer_batch_data.end(), metrics->sequencer_batch_metrics.data());
       mhorderer_batch_data.splice(mhorderer_batch_data.end(), metrics->mhorderer_batch_metrics.data());
+      paxos_sync_data.splice(paxos_sync_data.end(), metrics->paxos_sync_metrics.data());
+      late_arrival_data.splice(late_arrival_data.end(), metrics->late_arrival_metrics.data());
       txn_timestamp_data.splice(txn_timestamp_data.end(), metrics->txn_timestamp_metrics.data());
       generic_data.splice(generic_data.end(), metrics->generic_metrics.data());
     }
@@ -577,7 +724,9 @@ void MetricsRepositoryManager::AggregateAndFlushToDisk(const std::string& dir) {
     ClockSyncMetrics::WriteToDisk(dir, clock_sync_data);
     BatchMetrics::WriteToDisk(dir + "/forwarder_batch.csv", forwarder_batch_data);
     BatchMetrics::WriteToDisk(dir + "/sequencer_batch.csv", sequencer_batch_data);
-    BatchMetrics::WriteToDisk(dir + "/mhorderer_batch.csv", mhorderer_batch_data);
+    MHOrdererBatchMetrics::WriteToDisk(dir, mhorderer_batch_data);
+    PaxosSyncMetrics::WriteToDisk(dir, paxos_sync_data);
+    LateArrivalMetrics::WriteToDisk(dir, late_arrival_data);
     TxnTimestampMetrics::WriteToDisk(dir, txn_timestamp_data);
     GenericMetrics::WriteToDisk(dir, generic_data);
     LOG(INFO) << "Metrics written to: \"" << dir << "/\"";
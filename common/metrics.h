@@ -27,7 +27,8 @@ class MetricsRepository {
 
   std::chrono::system_clock::time_point RecordTxnEvent(TxnId txn_id, TransactionEvent event);
   void RecordDeadlockResolverRun(int64_t runtime, size_t unstable_graph_sz, size_t stable_graph_sz,
-                                 size_t deadlocks_resolved, int64_t graph_update_time);
+                                 size_t deadlocks_resolved, int64_t graph_update_time, size_t graph_log_bytes,
+                                 size_t sent_graph_log_bytes);
   void RecordDeadlockResolverDeadlock(int num_vertices, const std::vector<std::pair<uint64_t, uint64_t>>& edges_removed,
                                       const std::vector<std::pair<uint64_t, uint64_t>>& edges_added);
   void RecordLogManagerEntry(uint32_t region, BatchId batch_id, TxnId txn_id, int64_t txn_timestamp,
@@ -35,10 +36,14 @@ class MetricsRepository {
   void RecordForwSequLatency(uint32_t region, int64_t src_time, int64_t dst_time, int64_t src_recv_time,
                              int64_t avg_time);
   void RecordClockSync(uint32_t dst, int64_t src_time, int64_t dst_time, int64_t src_recv_time, int64_t local_slog_time,
-                       int64_t avg_latency, int64_t new_offset);
+                       int64_t avg_latency, int64_t new_offset, int64_t error_bound);
   void RecordForwarderBatch(size_t batch_size, int64_t batch_duration);
-  void RecordSequencerBatch(BatchId batch_id, size_t batch_size, int64_t batch_duration);
-  void RecordMHOrdererBatch(BatchId batch_id, size_t batch_size, int64_t batch_duration);
+  void RecordSequencerBatch(BatchId batch_id, size_t batch_size, int64_t batch_duration, int64_t batch_window);
+  void RecordMHOrdererBatch(BatchId batch_id, size_t batch_size, int64_t batch_duration, int64_t batch_window,
+                            int64_t order_duration);
+  void RecordPaxosSync(Channel group, size_t num_records, size_t num_bytes, int64_t sync_duration,
+                       int64_t added_latency);
+  void RecordLateArrivals(int64_t time, uint32_t from_region, uint64_t num_txns, uint64_t num_late_txns);
   void RecordTxnTimestamp(TxnId txn_id, uint32_t from, int64_t txn_timestamp, int64_t server_time);
   void RecordGeneric(int type, int64_t time, int64_t data);
 
@@ -0,0 +1,97 @@
+#pragma once
+
+#include <glog/logging.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <cstdint>
+#include <utility>
+
+#include "common/spsc_queue.h"
+
+namespace slog {
+
+/**
+ * A multi-producer/single-consumer queue implemented as a lock-free linked list. A push is one
+ * atomic exchange on the head so producers never wait for each other or for the consumer.
+ *
+ * Like SpscQueue, an eventfd is signaled when the consumer may be sleeping, so the consumer can
+ * poll() on notify_fd() once Pop() returns false. A pop that finds the queue empty re-arms the
+ * notification, so the eventfd is written at most once per time the consumer drains the queue.
+ * The consumer must reset the eventfd after waking up and before popping again, which is done
+ * by NetworkedModule for eventfds registered with AddCustomEventFd.
+ */
+template <typename T>
+class MpscQueue {
+  struct Node {
+    T item;
+    std::atomic<Node*> next{nullptr};
+  };
+
+ public:
+  MpscQueue() : tail_(new Node()), notified_(false) {
+    head_.store(tail_, std::memory_order_relaxed);
+    efd_ = eventfd(0, EFD_NONBLOCK);
+    CHECK_GE(efd_, 0) << "Failed to create eventfd";
+  }
+
+  MpscQueue(const MpscQueue&) = delete;
+  MpscQueue& operator=(const MpscQueue&) = delete;
+
+  ~MpscQueue() {
+    while (tail_ != nullptr) {
+      auto next = tail_->next.load(std::memory_order_relaxed);
+      delete tail_;
+      tail_ = next;
+    }
+    close(efd_);
+  }
+
+  /* Producer side */
+
+  void Push(T item) {
+    auto node = new Node();
+    node->item = std::move(item);
+    auto prev = head_.exchange(node, std::memory_order_acq_rel);
+    prev->next.store(node, std::memory_order_seq_cst);
+    if (!notified_.exchange(true, std::memory_order_seq_cst)) {
+      uint64_t one = 1;
+      [[maybe_unused]] auto res = write(efd_, &one, sizeof(one));
+    }
+  }
+
+  /* Consumer side */
+
+  bool Pop(T& item) {
+    auto next = tail_->next.load(std::memory_order_acquire);
+    if (next == nullptr) {
+      // Re-arm the notification, then check again for a push that saw the previous notification
+      // still pending and therefore did not signal the eventfd
+      notified_.store(false, std::memory_order_seq_cst);
+      next = tail_->next.load(std::memory_order_seq_cst);
+      if (next == nullptr) {
+        return false;
+      }
+    }
+    // The popped node becomes the new stub so the head is never touched by the consumer
+    item = std::move(next->item);
+    delete tail_;
+    tail_ = next;
+    return true;
+  }
+
+  int notify_fd() const { return efd_; }
+
+ private:
+  // Written by the producers
+  alignas(kCacheLineSize) std::atomic<Node*> head_;
+
+  // Written by the consumer
+  alignas(kCacheLineSize) Node* tail_;
+
+  std::atomic<bool> notified_;
+  int efd_;
+};
+
+}  // namespace slog
@@ -0,0 +1,72 @@
+#pragma once
+
+#include <memory>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+namespace slog {
+
+/**
+ * A single-threaded pool of objects of the same type. Memory is allocated in chunks and reused
+ * after an object is released so a steady stream of short-lived objects does not allocate.
+ * Objects never move so their addresses stay valid until they are released.
+ *
+ * Objects are handed out as unique pointers that return the object to the pool on release. All
+ * objects must be released before the pool is destroyed.
+ */
+template <typename T>
+class ObjectPool {
+ public:
+  struct Deleter {
+    ObjectPool* pool = nullptr;
+    void operator()(T* obj) const { pool->Release(obj); }
+  };
+  using Ptr = std::unique_ptr<T, Deleter>;
+
+  explicit ObjectPool(size_t chunk_size = 256) : chunk_size_(chunk_size), num_acquired_(0) {}
+
+  ObjectPool(const ObjectPool&) = delete;
+  ObjectPool& operator=(const ObjectPool&) = delete;
+
+  template <typename... Args>
+  Ptr Acquire(Args&&... args) {
+    if (free_.empty()) {
+      Grow();
+    }
+    auto mem = free_.back();
+    free_.pop_back();
+    num_acquired_++;
+    return Ptr(new (mem) T(std::forward<Args>(args)...), Deleter{this});
+  }
+
+  // Number of objects currently handed out
+  size_t num_acquired() const { return num_acquired_; }
+  // Number of objects that the allocated chunks can hold
+  size_t capacity() const { return chunks_.size() * chunk_size_; }
+
+ private:
+  using Storage = std::aligned_storage_t<sizeof(T), alignof(T)>;
+
+  void Release(T* obj) {
+    obj->~T();
+    free_.push_back(obj);
+    num_acquired_--;
+  }
+
+  void Grow() {
+    auto& chunk = chunks_.emplace_back(new Storage[chunk_size_]);
+    free_.reserve(free_.size() + chunk_size_);
+    // Push in reverse so that the objects are handed out in address order
+    for (size_t i = chunk_size_; i > 0; i--) {
+      free_.push_back(&chunk[i - 1]);
+    }
+  }
+
+  size_t chunk_size_;
+  size_t num_acquired_;
+  std::vector<std::unique_ptr<Storage[]>> chunks_;
+  std::vector<void*> free_;
+};
+
+}  // namespace slog
@@ -0,0 +1,56 @@
+#pragma once
+
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+#include <cstdint>
+#include <cstring>
+
+namespace slog {
+
+/**
+ * A hardware performance counter of the thread that creates it. The counter can be read
+ * from any thread. If the counter cannot be opened (e.g. perf events are not permitted
+ * in a container), fd() returns -1 and reads return -1.
+ */
+class PerfCounter {
+ public:
+  PerfCounter(uint32_t type, uint64_t config) {
+    perf_event_attr attr;
+    memset(&attr, 0, sizeof(attr));
+    attr.type = type;
+    attr.size = sizeof(attr);
+    attr.config = config;
+    attr.exclude_kernel = 1;
+    attr.exclude_hv = 1;
+    // Count the calling thread on any cpu
+    fd_ = syscall(__NR_perf_event_open, &attr, 0 /* pid */, -1 /* cpu */, -1 /* group_fd */, 0 /* flags */);
+  }
+
+  PerfCounter(const PerfCounter&) = delete;
+  PerfCounter& operator=(const PerfCounter&) = delete;
+
+  ~PerfCounter() {
+    if (fd_ >= 0) {
+      close(fd_);
+    }
+  }
+
+  int fd() const { return fd_; }
+
+  int64_t Read() const { return Read(fd_); }
+
+  static int64_t Read(int fd) {
+    int64_t count;
+    if (fd < 0 || read(fd, &count, sizeof(count)) != sizeof(count)) {
+      return -1;
+    }
+    return count;
+  }
+
+ private:
+  int fd_;
+};
+
+}  // namespace slog
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <vector>
+
+namespace slog {
+
+/**
+ * A fixed-size array whose elements are stored inline if there are at most N of them,
+ * and on the heap otherwise. The size is set once at construction.
+ */
+template <typename T, size_t N>
+class SmallVector {
+ public:
+  explicit SmallVector(size_t size) : size_(size) {
+    if (size_ > N) {
+      heap_.resize(size_);
+    }
+  }
+
+  size_t size() const { return size_; }
+
+  T* begin() { return data(); }
+  T* end() { return data() + size_; }
+  const T* begin() const { return data(); }
+  const T* end() const { return data() + size_; }
+
+  T& operator[](size_t i) { return data()[i]; }
+  const T& operator[](size_t i) const { return data()[i]; }
+
+ private:
+  T* data() { return size_ > N ? heap_.data() : inline_.data(); }
+  const T* data() const { return size_ > N ? heap_.data() : inline_.data(); }
+
+  size_t size_;
+  std::array<T, N> inline_;
+  std::vector<T> heap_;
+};
+
+}  // namespace slog
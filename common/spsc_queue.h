@@ -0,0 +1,119 @@
+#pragma once
+
+#include <glog/logging.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <utility>
+#include <vector>
+
+namespace slog {
+
+const size_t kCacheLineSize = 64;
+
+/**
+ * A single-producer/single-consumer queue backed by a lock-free ring buffer. The indices
+ * owned by the producer and by the consumer live on separate cache lines so that the two
+ * threads do not invalidate each other's cache lines on every operation.
+ *
+ * Push never blocks. When the ring is full, items are parked in an overflow list owned by
+ * the producer, which must call Flush() until it returns false to move them into the ring.
+ *
+ * An eventfd is signaled whenever the producer finds that the consumer has drained everything
+ * pushed before, so a consumer can sleep in poll() on notify_fd() once Pop() returns false.
+ * The consumer must reset the eventfd after waking up and before popping again, which is
+ * done by NetworkedModule for eventfds registered with AddCustomEventFd.
+ */
+template <typename T>
+class SpscQueue {
+ public:
+  explicit SpscQueue(size_t min_capacity = 4096) : head_(0), cached_tail_(0), tail_(0), cached_head_(0) {
+    size_t capacity = 1;
+    while (capacity < min_capacity) {
+      capacity <<= 1;
+    }
+    ring_.resize(capacity);
+    mask_ = capacity - 1;
+    efd_ = eventfd(0, EFD_NONBLOCK);
+    CHECK_GE(efd_, 0) << "Failed to create eventfd";
+  }
+
+  SpscQueue(const SpscQueue&) = delete;
+  SpscQueue& operator=(const SpscQueue&) = delete;
+
+  ~SpscQueue() { close(efd_); }
+
+  /* Producer side */
+
+  void Push(const T& item) {
+    if (!overflow_.empty() || !TryPushToRing(item)) {
+      overflow_.push_back(item);
+    }
+  }
+
+  // Returns true if there are still items in the overflow list
+  bool Flush() {
+    while (!overflow_.empty() && TryPushToRing(overflow_.front())) {
+      overflow_.pop_front();
+    }
+    return !overflow_.empty();
+  }
+
+  /* Consumer side */
+
+  bool Pop(T& item) {
+    auto head = head_.load(std::memory_order_relaxed);
+    if (head == cached_tail_) {
+      // This load must be ordered after the store to head_ of the previous pop so that a push
+      // that did not see the consumer catch up is visible here
+      cached_tail_ = tail_.load(std::memory_order_seq_cst);
+      if (head == cached_tail_) {
+        return false;
+      }
+    }
+    // Move out of the slot so that it does not keep the item alive until it is overwritten
+    item = std::move(ring_[head & mask_]);
+    head_.store(head + 1, std::memory_order_seq_cst);
+    return true;
+  }
+
+  int notify_fd() const { return efd_; }
+
+ private:
+  bool TryPushToRing(const T& item) {
+    auto tail = tail_.load(std::memory_order_relaxed);
+    if (tail - cached_head_ > mask_) {
+      cached_head_ = head_.load(std::memory_order_acquire);
+      if (tail - cached_head_ > mask_) {
+        return false;
+      }
+    }
+    ring_[tail & mask_] = item;
+    tail_.store(tail + 1, std::memory_order_seq_cst);
+    // The consumer has popped everything before this item so it might be sleeping
+    if (head_.load(std::memory_order_seq_cst) == tail) {
+      uint64_t one = 1;
+      [[maybe_unused]] auto res = write(efd_, &one, sizeof(one));
+    }
+    return true;
+  }
+
+  std::vector<T> ring_;
+  size_t mask_;
+  int efd_;
+
+  // Written by the consumer
+  alignas(kCacheLineSize) std::atomic<size_t> head_;
+  size_t cached_tail_;
+
+  // Written by the producer
+  alignas(kCacheLineSize) std::atomic<size_t> tail_;
+  size_t cached_head_;
+  std::deque<T> overflow_;
+};
+
+}  // namespace slog
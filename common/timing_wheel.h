@@ -0,0 +1,207 @@
+/**
+ * timing_wheel.h
+ *
+ * A hierarchical timing wheel that buffers items until a given tick. Each level has 64 slots and
+ * a slot of level l spans 64^l ticks, so 4 levels cover 2^24 ticks (about 16.7s with microsecond
+ * ticks) past the current tick. Items further out are kept in an overflow list.
+ *
+ * Inserting is O(1). Advancing visits only the occupied slots of the lowest level, found with a
+ * bitmap per level, and moves the items of a higher-level slot down the wheel when the current
+ * tick enters its range. Each item is moved at most once per level.
+ *
+ * The wheel is not thread-safe.
+ */
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <optional>
+#include <utility>
+#include <vector>
+
+namespace slog {
+
+template <typename T>
+class TimingWheel {
+  static constexpr int kSlotBits = 6;
+  static constexpr int kNumSlots = 1 << kSlotBits;
+  static constexpr uint64_t kSlotMask = kNumSlots - 1;
+  static constexpr int kNumLevels = 4;
+
+ public:
+  using Entry = std::pair<uint64_t, T>;
+
+  explicit TimingWheel(uint64_t start_tick = 0) : current_(start_tick), size_(0) { occupied_.fill(0); }
+
+  /**
+   * Buffers an item until the given tick. An item whose tick has already passed is returned by
+   * the next call to Advance.
+   */
+  void Insert(uint64_t tick, T item) {
+    size_++;
+    Place(Entry(tick, std::move(item)));
+  }
+
+  /**
+   * Moves the current tick forward to `now` and appends all items whose tick is before `now`
+   * to `ready`. Items are appended in order of their ticks, and in insertion order for the same
+   * tick, except that items inserted with a passed tick come first.
+   */
+  void Advance(uint64_t now, std::vector<Entry>& ready) {
+    for (auto& entry : expired_) {
+      ready.push_back(std::move(entry));
+    }
+    size_ -= expired_.size();
+    expired_.clear();
+
+    while (current_ < now) {
+      auto idx = current_ & kSlotMask;
+      auto later = occupied_[0] & (~0ULL << idx);
+      if (later == 0) {
+        // Nothing is left in the lowest level so jump to the next slot to move down the wheel
+        auto next = NextCascadeTick();
+        if (!next.has_value() || next.value() > now) {
+          current_ = now;
+          break;
+        }
+        current_ = next.value();
+        Cascade();
+        continue;
+      }
+      auto next = (current_ & ~kSlotMask) + __builtin_ctzll(later);
+      if (next >= now) {
+        current_ = now;
+        break;
+      }
+      current_ = next;
+      Expire(current_ & kSlotMask, ready);
+      current_++;
+      if ((current_ & kSlotMask) == 0) {
+        Cascade();
+      }
+    }
+  }
+
+  /**
+   * @return A lower bound of the earliest tick among the buffered items, which is exact if that
+   *         item is in the lowest level
+   */
+  std::optional<uint64_t> NextTick() const {
+    if (!expired_.empty()) {
+      return current_;
+    }
+    auto later = occupied_[0] & (~0ULL << (current_ & kSlotMask));
+    if (later != 0) {
+      return (current_ & ~kSlotMask) + __builtin_ctzll(later);
+    }
+    return NextCascadeTick();
+  }
+
+  template <typename Function>
+  void ForEach(Function fn) const {
+    for (const auto& entry : expired_) {
+      fn(entry);
+    }
+    for (const auto& level : slots_) {
+      for (const auto& slot : level) {
+        for (const auto& entry : slot) {
+          fn(entry);
+        }
+      }
+    }
+    for (const auto& entry : overflow_) {
+      fn(entry);
+    }
+  }
+
+  uint64_t current_tick() const { return current_; }
+  size_t size() const { return size_; }
+  bool empty() const { return size_ == 0; }
+
+ private:
+  void Place(Entry&& entry) {
+    auto tick = entry.first;
+    if (tick < current_) {
+      expired_.push_back(std::move(entry));
+      return;
+    }
+    // Find the lowest level at which the tick and the current tick are in the same block of slots
+    for (int l = 0; l < kNumLevels; l++) {
+      auto shift = l * kSlotBits;
+      if ((tick >> (shift + kSlotBits)) == (current_ >> (shift + kSlotBits))) {
+        auto idx = (tick >> shift) & kSlotMask;
+        slots_[l][idx].push_back(std::move(entry));
+        occupied_[l] |= 1ULL << idx;
+        return;
+      }
+    }
+    overflow_.push_back(std::move(entry));
+  }
+
+  // Returns the first tick after the current tick that enters an occupied slot above the lowest level
+  std::optional<uint64_t> NextCascadeTick() const {
+    for (int l = 1; l < kNumLevels; l++) {
+      auto shift = l * kSlotBits;
+      auto idx = (current_ >> shift) & kSlotMask;
+      // Slots up to the current one are empty since their items have been moved down
+      auto later = occupied_[l] & ~((2ULL << idx) - 1);
+      if (later != 0) {
+        auto base = (current_ >> (shift + kSlotBits)) << (shift + kSlotBits);
+        return base + (static_cast<uint64_t>(__builtin_ctzll(later)) << shift);
+      }
+    }
+    if (!overflow_.empty()) {
+      constexpr int kWheelBits = kNumLevels * kSlotBits;
+      return ((current_ >> kWheelBits) + 1) << kWheelBits;
+    }
+    return std::nullopt;
+  }
+
+  void Expire(uint64_t idx, std::vector<Entry>& ready) {
+    auto& slot = slots_[0][idx];
+    size_ -= slot.size();
+    for (auto& entry : slot) {
+      ready.push_back(std::move(entry));
+    }
+    slot.clear();
+    occupied_[0] &= ~(1ULL << idx);
+  }
+
+  // Called when the current tick crosses into a new slot of the lowest level. Moves the items of
+  // the slots that the current tick has just entered down the wheel, starting from the highest level
+  void Cascade() {
+    int top = 1;
+    while (top < kNumLevels && ((current_ >> (top * kSlotBits)) & kSlotMask) == 0) {
+      top++;
+    }
+    if (top == kNumLevels) {
+      std::vector<Entry> overflow;
+      overflow.swap(overflow_);
+      for (auto& entry : overflow) {
+        Place(std::move(entry));
+      }
+      top = kNumLevels - 1;
+    }
+    for (int l = top; l > 0; l--) {
+      auto idx = (current_ >> (l * kSlotBits)) & kSlotMask;
+      if ((occupied_[l] & (1ULL << idx)) == 0) {
+        continue;
+      }
+      std::vector<Entry> slot;
+      slot.swap(slots_[l][idx]);
+      occupied_[l] &= ~(1ULL << idx);
+      for (auto& entry : slot) {
+        Place(std::move(entry));
+      }
+    }
+  }
+
+  std::array<std::array<std::vector<Entry>, kNumSlots>, kNumLevels> slots_;
+  std::array<uint64_t, kNumLevels> occupied_;
+  std::vector<Entry> overflow_;
+  std::vector<Entry> expired_;
+  uint64_t current_;
+  size_t size_;
+};
+
+}  // namespace slog
@@ -110,6 +110,19 @@ class BrokerThread : public Module {
       return;
     }
 
+    if (tag_or_chan_id == kCoalescedMessagesTag) {
+      auto handle = [this](zmq::message_t&& split_msg) { HandleIncomingMessage(move(split_msg)); };
+      if (!ForEachCoalescedMessage(msg, handle)) {
+        LOG(ERROR) << "Malformed coalesced messages";
+      }
+      return;
+    }
+
+    if (tag_or_chan_id == kRemoteReadBatchTag) {
+      HandleRemoteReadBatch(move(msg));
+      return;
+    }
+
     auto chan_id = tag_or_chan_id;
 
     // Anything larger than or equal to kMaxChannel is considered a tag
@@ -131,22 +144,43 @@ class BrokerThread : public Module {
     ForwardMessage(chan_it->second.socket, chan_it->second.send_raw, move(msg));
   }
 
-  void ForwardMessage(zmq::socket_t& socket, bool send_raw, zmq::message_t&& msg) {
+  /**
+   * Splits a batch of remote reads into individual messages, each addressed to the tag of
+   * its txn, so that they are redirected to the workers as if they were sent individually
+   */
+  void HandleRemoteReadBatch(zmq::message_t&& msg) {
     MachineId machine_id = -1;
     ParseMachineId(machine_id, msg);
 
-    auto env = std::make_unique<Envelope>();
+    Envelope batch_env;
+    if (!DeserializeProto(batch_env, msg) || !batch_env.request().has_remote_read_result_batch()) {
+      LOG(ERROR) << "Malformed remote read batch";
+      return;
+    }
+
+    for (auto& result : *batch_env.mutable_request()->mutable_remote_read_result_batch()->mutable_results()) {
+      auto tag = Broker::MakeRemoteReadTag(result.txn_id(), result.deadlocked());
+      Envelope env;
+      env.mutable_request()->mutable_remote_read_result()->Swap(&result);
+      // The split messages never leave this machine so they always take the lean format
+      auto split_msg = SerializeProto(env, internal::WireFormat::LEAN);
+      AddressBuffer(split_msg, machine_id, tag);
+      HandleIncomingMessage(move(split_msg));
+    }
+  }
+
+  void ForwardMessage(zmq::socket_t& socket, bool send_raw, zmq::message_t&& msg) {
     if (send_raw) {
-      env->set_raw(msg.to_string());
-    } else {
-      if (!DeserializeProto(*env, msg)) {
-        LOG(ERROR) << "Malformed message";
-        return;
-      }
+      // The receiving module takes the message itself, with the sender in its header
+      SendRawMessage(socket, move(msg));
+      return;
     }
 
-    // This must be set AFTER deserializing otherwise it will be overwritten by the deserialization function
-    env->set_from(machine_id);
+    auto env = DeserializeEnvelope(msg);
+    if (env == nullptr) {
+      LOG(ERROR) << "Malformed message";
+      return;
+    }
     SendEnvelope(socket, move(env));
   }
 
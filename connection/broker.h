@@ -55,6 +55,9 @@ class Broker {
 
   static Channel MakeChannel(int broker_num) { return kBrokerChannel + broker_num; }
 
+  // Tag used by workers to receive the remote reads of a txn run
+  static Channel MakeRemoteReadTag(TxnId txn_id, bool deadlocked) { return txn_id * 10 + deadlocked; }
+
   void StartInNewThreads();
   void Stop();
   struct ChannelOption {
@@ -21,6 +21,9 @@ class Poller {
 
   void PushSocket(zmq::socket_t& socket);
 
+  // Polls a file descriptor alongside the sockets. Returns its position for is_socket_ready
+  size_t PushFd(int fd);
+
   bool is_socket_ready(size_t i) const;
 
   Handle AddTimedCallback(std::chrono::microseconds timeout, std::function<void()>&& cb);
@@ -5,11 +5,14 @@ using std::move;
 namespace slog {
 
 Sender::Sender(const ConfigurationPtr& config, const std::shared_ptr<zmq::context_t>& context, bool is_long)
-    : config_(config), context_(context), is_long_(is_long) {}
+    : config_(config), context_(context), is_long_(is_long), coalescing_bytes_(config->sender_coalescing_bytes()) {}
+
+Sender::~Sender() { Flush(); }
 
 void Sender::Send(const internal::Envelope& envelope, MachineId to_machine_id, Channel to_channel) {
-  auto& socket = GetRemoteSocket(to_machine_id, to_channel);
-  SendSerializedProto(*socket, envelope, config_->local_machine_id(), to_channel);
+  auto msg = SerializeProto(envelope, config_->wire_format());
+  AddressBuffer(msg, config_->local_machine_id(), to_channel);
+  SendRemote(GetRemoteSocket(to_machine_id, to_channel), move(msg));
 }
 
 void Sender::Send(EnvelopePtr&& envelope, MachineId to_machine_id, Channel to_channel) {
@@ -36,34 +39,85 @@ void Sender::Send(EnvelopePtr&& envelope, Channel to_channel) {
 
 void Sender::Send(const internal::Envelope& envelope, const std::vector<MachineId>& to_machine_ids,
                   Channel to_channel) {
-  auto serialized = SerializeProto(envelope);
-  for (auto dest : to_machine_ids) {
-    zmq::message_t copied;
-    copied.copy(serialized);
-    auto& socket = GetRemoteSocket(dest, to_channel);
-    SendAddressedBuffer(*socket, move(copied), config_->local_machine_id(), to_channel);
-  }
+  Send(SerializeProto(envelope, config_->wire_format()), to_machine_ids, to_channel);
 }
 
 void Sender::Send(EnvelopePtr&& envelope, const std::vector<MachineId>& to_machine_ids, Channel to_channel) {
-  auto serialized = SerializeProto(*envelope);
+  std::vector<MachineId> remote_machine_ids;
+  remote_machine_ids.reserve(to_machine_ids.size());
   bool send_local = false;
   for (auto dest : to_machine_ids) {
     if (dest == config_->local_machine_id()) {
       send_local = true;
-      continue;
+    } else {
+      remote_machine_ids.push_back(dest);
     }
-    zmq::message_t copied;
-    copied.copy(serialized);
-    auto& socket = GetRemoteSocket(dest, to_channel);
-    SendAddressedBuffer(*socket, move(copied), config_->local_machine_id(), to_channel);
+  }
+  if (!remote_machine_ids.empty()) {
+    Send(SerializeProto(*envelope, config_->wire_format()), remote_machine_ids, to_channel);
   }
   if (send_local) {
     Send(std::move(envelope), to_channel);
   }
 }
 
-Sender::SocketPtr& Sender::GetRemoteSocket(MachineId machine_id, Channel channel) {
+void Sender::Send(zmq::message_t&& serialized, MachineId to_machine_id, Channel to_channel) {
+  AddressBuffer(serialized, config_->local_machine_id(), to_channel);
+  SendRemote(GetRemoteSocket(to_machine_id, to_channel), move(serialized));
+}
+
+void Sender::Send(zmq::message_t&& serialized, const std::vector<MachineId>& to_machine_ids, Channel to_channel) {
+  // The header is the same for all destinations so it is filled in once, before the buffer is
+  // shared with messages that may already be in flight
+  AddressBuffer(serialized, config_->local_machine_id(), to_channel);
+  for (auto dest : to_machine_ids) {
+    // Copying a zmq message only adds a reference to its buffer
+    zmq::message_t shared;
+    shared.copy(serialized);
+    SendRemote(GetRemoteSocket(dest, to_channel), move(shared));
+  }
+}
+
+void Sender::Flush() {
+  for (auto remote : remotes_to_flush_) {
+    FlushRemote(*remote);
+    remote->flush_scheduled = false;
+  }
+  remotes_to_flush_.clear();
+}
+
+void Sender::SendRemote(RemoteSocket& remote, zmq::message_t&& msg) {
+  if (msg.size() < coalescing_bytes_) {
+    remote.pending_bytes += sizeof(uint32_t) + msg.size();
+    remote.pending_msgs.push_back(move(msg));
+    if (remote.pending_bytes >= coalescing_bytes_) {
+      FlushRemote(remote);
+    } else if (!remote.flush_scheduled) {
+      remote.flush_scheduled = true;
+      remotes_to_flush_.push_back(&remote);
+    }
+    return;
+  }
+  // Send the held back messages first to keep the order of the messages to this socket
+  FlushRemote(remote);
+  remote.socket->send(msg, zmq::send_flags::dontwait);
+}
+
+void Sender::FlushRemote(RemoteSocket& remote) {
+  if (remote.pending_msgs.empty()) {
+    return;
+  }
+  if (remote.pending_msgs.size() == 1) {
+    remote.socket->send(remote.pending_msgs.front(), zmq::send_flags::dontwait);
+  } else {
+    SendAddressedBuffer(*remote.socket, CoalesceMessages(remote.pending_msgs), config_->local_machine_id(),
+                        kCoalescedMessagesTag);
+  }
+  remote.pending_msgs.clear();
+  remote.pending_bytes = 0;
+}
+
+Sender::RemoteSocket& Sender::GetRemoteSocket(MachineId machine_id, Channel channel) {
   uint32_t port;
   if (channel >= kMaxChannel) {
     port = config_->broker_ports(config_->broker_ports_size() - 1);
@@ -85,8 +139,8 @@ Sender::SocketPtr& Sender::GetRemoteSocket(MachineId machine_id, Channel channel
 
   // Lazily establish a new connection when necessary
   auto id = std::make_pair(machine_id, port);
-  auto ins = machine_id_and_port_to_sockets_.try_emplace(id, nullptr);
-  auto& socket = ins.first->second;
+  auto& remote = machine_id_and_port_to_sockets_[id];
+  auto& socket = remote.socket;
   if (socket == nullptr) {
     socket = std::make_unique<zmq::socket_t>(*context_, ZMQ_PUSH);
     socket->set(zmq::sockopt::sndhwm, 0);
@@ -96,7 +150,7 @@ Sender::SocketPtr& Sender::GetRemoteSocket(MachineId machine_id, Channel channel
     auto endpoint = MakeRemoteAddress(config_->protocol(), config_->address(machine_id), port);
     socket->connect(endpoint);
   }
-  return socket;
+  return remote;
 }
 
 }  // namespace slog
\ No newline at end of file
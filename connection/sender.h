@@ -1,6 +1,8 @@
 #pragma once
 
+#include <map>
 #include <unordered_map>
+#include <vector>
 #include <zmq.hpp>
 
 #include "common/types.h"
@@ -16,6 +18,7 @@ namespace slog {
 class Sender {
  public:
   Sender(const ConfigurationPtr& config, const std::shared_ptr<zmq::context_t>& context, bool is_long = false);
+  ~Sender();
 
   /**
    * Send a request or response to a given channel of a given machine
@@ -60,10 +63,45 @@ class Sender {
    */
   void Send(EnvelopePtr&& envelope, const std::vector<MachineId>& to_machine_ids, Channel to_channel);
 
+  /**
+   * Send a pre-serialized message, created by SerializeProto or SerializeForwardBatchData, to a
+   * given channel of a given machine. The local machine is reached over the network like
+   * any other machine
+   * @param serialized Serialized message to be sent. Its header is filled in by this method
+   * @param to_machine_id Id of the machine that this message is sent to
+   * @param to_channel Channel on the machine that this message is sent to
+   */
+  void Send(zmq::message_t&& serialized, MachineId to_machine_id, Channel to_channel);
+
+  /**
+   * Send a pre-serialized message, created by SerializeProto or SerializeForwardBatchData, to a
+   * given channel of a list of machines. All destinations share the same buffer, so sending
+   * to one more machine copies neither the message nor its serialized bytes
+   * @param serialized Serialized message to be sent. Its header is filled in by this method
+   * @param to_machine_ids Ids of the machines that this message is sent to
+   * @param to_channel Channel on the machine that this message is sent to
+   */
+  void Send(zmq::message_t&& serialized, const std::vector<MachineId>& to_machine_ids, Channel to_channel);
+
+  /**
+   * Sends the small messages to other machines that are waiting to be coalesced. Messages are
+   * only held back when sender_coalescing_bytes is set
+   */
+  void Flush();
+
  private:
   using MachineIdWithPort = std::pair<MachineId, int>;
-  using SocketPtr = std::unique_ptr<zmq::socket_t>;
-  SocketPtr& GetRemoteSocket(MachineId machine_id, Channel channel);
+  struct RemoteSocket {
+    std::unique_ptr<zmq::socket_t> socket;
+    // Small messages waiting to be coalesced into one frame
+    std::vector<zmq::message_t> pending_msgs;
+    size_t pending_bytes = 0;
+    bool flush_scheduled = false;
+  };
+  RemoteSocket& GetRemoteSocket(MachineId machine_id, Channel channel);
+  // Sends an addressed buffer, holding it back to be coalesced with others if it is small
+  void SendRemote(RemoteSocket& remote, zmq::message_t&& msg);
+  void FlushRemote(RemoteSocket& remote);
 
   ConfigurationPtr config_;
   // Keep a pointer to context here to make sure that the below sockets
@@ -71,8 +109,10 @@ class Sender {
   std::shared_ptr<zmq::context_t> context_;
   // Sockets of a long sender have a larger kernel buffer size
   bool is_long_;
-  std::map<MachineIdWithPort, SocketPtr> machine_id_and_port_to_sockets_;
+  std::map<MachineIdWithPort, RemoteSocket> machine_id_and_port_to_sockets_;
   std::unordered_map<Channel, zmq::socket_t> local_channel_to_socket_;
+  uint32_t coalescing_bytes_;
+  std::vector<RemoteSocket*> remotes_to_flush_;
 };
 
 }  // namespace slog
\ No newline at end of file
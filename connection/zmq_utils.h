@@ -1,11 +1,19 @@
 #pragma once
 
 #include <google/protobuf/any.pb.h>
+#include <google/protobuf/io/coded_stream.h>
+#include <google/protobuf/io/zero_copy_stream_impl_lite.h>
+#include <google/protobuf/wire_format_lite.h>
 
+#include <cstring>
+#include <optional>
 #include <sstream>
+#include <string_view>
+#include <vector>
 #include <zmq.hpp>
 
 #include "common/types.h"
+#include "proto/configuration.pb.h"
 #include "proto/internal.pb.h"
 
 namespace slog {
@@ -37,36 +45,78 @@ inline void SendEnvelope(zmq::socket_t& socket, EnvelopePtr&& envelope) {
 }
 
 /**
- * Receives a pointer of an envelope
+ * Hands a message received from another machine over to a channel as is, leaving the
+ * deserialization to the receiving module. The message is preceded by an empty frame to tell
+ * it apart from an envelope pointer. An inproc socket passes the content of a message along
+ * without copying it
  */
-inline EnvelopePtr RecvEnvelope(zmq::socket_t& socket, bool dont_wait = false) {
-  zmq::message_t msg;
-  auto flag = dont_wait ? zmq::recv_flags::dontwait : zmq::recv_flags::none;
-  if (!socket.recv(msg, flag)) {
-    return nullptr;
+inline void SendRawMessage(zmq::socket_t& socket, zmq::message_t&& msg) {
+  socket.send(zmq::message_t{}, zmq::send_flags::sndmore);
+  socket.send(msg, zmq::send_flags::dontwait);
+}
+
+/**
+ * After the header, a buffer holds the message in one of the following formats:
+ *   WireFormat::ANY:  a google::protobuf::Any that packs the message
+ *   WireFormat::LEAN: [kLeanFrameMarker][LeanMessageType][message]
+ * A serialized protobuf never starts with a zero byte, so the formats are told apart by the first
+ * byte and a receiver can take either one.
+ */
+constexpr uint8_t kLeanFrameMarker = 0;
+constexpr size_t kLeanFrameHeaderSize = 2;
+
+enum class LeanMessageType : uint8_t { UNKNOWN = 0, ENVELOPE = 1 };
+
+inline LeanMessageType GetLeanMessageType(const google::protobuf::Message& proto) {
+  if (proto.GetDescriptor() == internal::Envelope::descriptor()) {
+    return LeanMessageType::ENVELOPE;
   }
-  return EnvelopePtr(*(msg.data<internal::Envelope*>()));
+  return LeanMessageType::UNKNOWN;
 }
 
-inline zmq::message_t SerializeProto(const google::protobuf::Message& proto) {
+/**
+ * Serializes a message into a new buffer, leaving room for the header. Messages without a lean
+ * message type are always packed into an Any
+ */
+inline zmq::message_t SerializeProto(const google::protobuf::Message& proto,
+                                     internal::WireFormat format = internal::WireFormat::ANY) {
+  auto header_sz = sizeof(MachineId) + sizeof(Channel);
+
+  auto type = GetLeanMessageType(proto);
+  if (format == internal::WireFormat::LEAN && type != LeanMessageType::UNKNOWN) {
+    auto proto_size = proto.ByteSizeLong();
+    zmq::message_t msg(header_sz + kLeanFrameHeaderSize + proto_size);
+    auto frame = msg.data<uint8_t>() + header_sz;
+    frame[0] = kLeanFrameMarker;
+    frame[1] = static_cast<uint8_t>(type);
+    // The sizes are computed by ByteSizeLong above
+    proto.SerializeWithCachedSizesToArray(frame + kLeanFrameHeaderSize);
+    return msg;
+  }
+
   google::protobuf::Any any;
   any.PackFrom(proto);
 
-  auto header_sz = sizeof(MachineId) + sizeof(Channel);
   zmq::message_t msg(header_sz + any.ByteSizeLong());
   any.SerializeToArray(msg.data<char>() + header_sz, any.ByteSizeLong());
 
   return msg;
 }
 
-inline void SendAddressedBuffer(zmq::socket_t& socket, zmq::message_t&& msg, MachineId from_machine_id = -1,
-                                Channel to_chan = 0) {
+/**
+ * Fills the header of a buffer created by SerializeProto
+ */
+inline void AddressBuffer(zmq::message_t& msg, MachineId from_machine_id, Channel to_chan) {
   auto machine_id_data = msg.data<MachineId>();
   *machine_id_data = from_machine_id;
 
   auto channel_data = reinterpret_cast<Channel*>(machine_id_data + 1);
   *channel_data = to_chan;
+}
 
+inline void SendAddressedBuffer(zmq::socket_t& socket, zmq::message_t&& msg, MachineId from_machine_id = -1,
+                                Channel to_chan = 0) {
+  AddressBuffer(msg, from_machine_id, to_chan);
   socket.send(msg, zmq::send_flags::dontwait);
 }
 
@@ -75,8 +125,9 @@ inline void SendAddressedBuffer(zmq::socket_t& socket, zmq::message_t&& msg, Mac
  * <sender machine id> <receiver channel> <proto>
  */
 inline void SendSerializedProto(zmq::socket_t& socket, const google::protobuf::Message& proto,
-                                MachineId from_machine_id = -1, Channel to_chan = 0) {
-  SendAddressedBuffer(socket, SerializeProto(proto), from_machine_id, to_chan);
+                                MachineId from_machine_id = -1, Channel to_chan = 0,
+                                internal::WireFormat format = internal::WireFormat::ANY) {
+  SendAddressedBuffer(socket, SerializeProto(proto, format), from_machine_id, to_chan);
 }
 
 inline void SendSerializedProtoWithEmptyDelim(zmq::socket_t& socket, const google::protobuf::Message& proto) {
@@ -101,6 +152,56 @@ inline bool ParseChannel(Channel& chan, const zmq::message_t& msg) {
   return true;
 }
 
+/**
+ * Builds a frame from addressed buffers to the same socket. The frame is laid out as
+ * <header> (<size of buffer> <buffer>)*
+ * Its header is not filled in so it must be addressed to kCoalescedMessagesTag by the sender
+ */
+inline zmq::message_t CoalesceMessages(const std::vector<zmq::message_t>& msgs) {
+  auto header_sz = sizeof(MachineId) + sizeof(Channel);
+  size_t frame_size = header_sz;
+  for (const auto& msg : msgs) {
+    frame_size += sizeof(uint32_t) + msg.size();
+  }
+  zmq::message_t frame(frame_size);
+  auto data = frame.data<char>() + header_sz;
+  for (const auto& msg : msgs) {
+    uint32_t size = msg.size();
+    memcpy(data, &size, sizeof(size));
+    memcpy(data + sizeof(size), msg.data(), size);
+    data += sizeof(size) + size;
+  }
+  return frame;
+}
+
+/**
+ * Calls fn on a copy of each buffer in a frame built by CoalesceMessages. Returns false if the
+ * frame is malformed, in which case the buffers before the malformed part have been passed to fn
+ */
+template <typename Function>
+inline bool ForEachCoalescedMessage(const zmq::message_t& frame, Function fn) {
+  auto header_sz = sizeof(MachineId) + sizeof(Channel);
+  if (frame.size() < header_sz) {
+    return false;
+  }
+  auto data = frame.data<char>();
+  size_t pos = header_sz;
+  while (pos < frame.size()) {
+    uint32_t size;
+    if (frame.size() - pos < sizeof(size)) {
+      return false;
+    }
+    memcpy(&size, data + pos, sizeof(size));
+    pos += sizeof(size);
+    if (size > frame.size() - pos) {
+      return false;
+    }
+    fn(zmq::message_t(data + pos, size));
+    pos += size;
+  }
+  return true;
+}
+
 template <typename T>
 inline bool DeserializeProto(T& out, const char* data, size_t size) {
   google::protobuf::Any any;
@@ -111,6 +212,14 @@ inline bool DeserializeProto(T& out, const char* data, size_t size) {
   // Skip the machineid and channel part
   auto proto_data = data + header_sz;
   auto proto_size = size - header_sz;
+  if (proto_size > 0 && static_cast<uint8_t>(proto_data[0]) == kLeanFrameMarker) {
+    auto type = GetLeanMessageType(out);
+    if (proto_size < kLeanFrameHeaderSize || type == LeanMessageType::UNKNOWN ||
+        static_cast<uint8_t>(proto_data[1]) != static_cast<uint8_t>(type)) {
+      return false;
+    }
+    return out.ParseFromArray(proto_data + kLeanFrameHeaderSize, proto_size - kLeanFrameHeaderSize);
+  }
   if (!any.ParseFromArray(proto_data, proto_size)) {
     return false;
   }
@@ -151,4 +260,197 @@ inline EnvelopePtr DeserializeEnvelope(const zmq::message_t& msg) {
   return env;
 }
 
-}  // namespace slog
\ No newline at end of file
+/**
+ * Receives either a pointer of an envelope, sent by SendEnvelope, or a raw message, sent by
+ * SendRawMessage. Returns false if there is nothing to receive. Otherwise, `env` is set for
+ * an envelope and left null for a raw message, which is put into `raw`
+ */
+inline bool RecvEnvelopeOrRawMessage(zmq::socket_t& socket, EnvelopePtr& env, zmq::message_t& raw,
+                                     bool dont_wait = false) {
+  zmq::message_t msg;
+  auto flag = dont_wait ? zmq::recv_flags::dontwait : zmq::recv_flags::none;
+  if (!socket.recv(msg, flag)) {
+    return false;
+  }
+  if (!msg.more()) {
+    env.reset(*(msg.data<internal::Envelope*>()));
+    return true;
+  }
+  // The parts of a multipart message are delivered together so this does not block
+  env.reset();
+  return socket.recv(raw).has_value();
+}
+
+/**
+ * Receives a pointer of an envelope. A raw message is deserialized into a new envelope
+ */
+inline EnvelopePtr RecvEnvelope(zmq::socket_t& socket, bool dont_wait = false) {
+  EnvelopePtr env;
+  zmq::message_t raw;
+  if (!RecvEnvelopeOrRawMessage(socket, env, raw, dont_wait)) {
+    return nullptr;
+  }
+  if (env == nullptr) {
+    return DeserializeEnvelope(raw);
+  }
+  return env;
+}
+
+/**
+ * Produces the same buffer as SerializeProto, in the given format, on an envelope holding a
+ * ForwardBatchData request, taking batch partitions that are already serialized. The partitions
+ * are only copied into the buffer so a partition can be serialized once and put into every
+ * message that carries it.
+ */
+inline zmq::message_t SerializeForwardBatchData(const std::vector<std::string_view>& batch_data, uint32_t generator,
+                                                uint32_t generator_position,
+                                                internal::WireFormat format = internal::WireFormat::ANY) {
+  using google::protobuf::io::CodedOutputStream;
+  using google::protobuf::internal::WireFormatLite;
+
+  auto tag = [](int field_number, WireFormatLite::WireType type) {
+    return WireFormatLite::MakeTag(field_number, type);
+  };
+  auto nested_size = [](uint32_t tag, size_t size) {
+    return CodedOutputStream::VarintSize32(tag) + CodedOutputStream::VarintSize32(size) + size;
+  };
+  const auto type_url_tag = tag(google::protobuf::Any::kTypeUrlFieldNumber, WireFormatLite::WIRETYPE_LENGTH_DELIMITED);
+  const auto value_tag = tag(google::protobuf::Any::kValueFieldNumber, WireFormatLite::WIRETYPE_LENGTH_DELIMITED);
+  const auto request_tag = tag(internal::Envelope::kRequestFieldNumber, WireFormatLite::WIRETYPE_LENGTH_DELIMITED);
+  const auto forward_batch_data_tag =
+      tag(internal::Request::kForwardBatchDataFieldNumber, WireFormatLite::WIRETYPE_LENGTH_DELIMITED);
+  const auto batch_data_tag =
+      tag(internal::ForwardBatchData::kBatchDataFieldNumber, WireFormatLite::WIRETYPE_LENGTH_DELIMITED);
+  const auto generator_tag = tag(internal::ForwardBatchData::kGeneratorFieldNumber, WireFormatLite::WIRETYPE_VARINT);
+  const auto generator_position_tag =
+      tag(internal::ForwardBatchData::kGeneratorPositionFieldNumber, WireFormatLite::WIRETYPE_VARINT);
+
+  // Sizes of the nested messages, from the innermost to the outermost
+  size_t forward_batch_data_size = 0;
+  for (auto batch : batch_data) {
+    forward_batch_data_size += nested_size(batch_data_tag, batch.size());
+  }
+  if (generator != 0) {
+    forward_batch_data_size +=
+        CodedOutputStream::VarintSize32(generator_tag) + CodedOutputStream::VarintSize32(generator);
+  }
+  if (generator_position != 0) {
+    forward_batch_data_size +=
+        CodedOutputStream::VarintSize32(generator_position_tag) + CodedOutputStream::VarintSize32(generator_position);
+  }
+  auto request_size = nested_size(forward_batch_data_tag, forward_batch_data_size);
+  auto envelope_size = nested_size(request_tag, request_size);
+  bool lean = format == internal::WireFormat::LEAN;
+  std::string type_url = lean ? "" : "type.googleapis.com/" + internal::Envelope::descriptor()->full_name();
+  auto frame_size = lean ? kLeanFrameHeaderSize + envelope_size
+                         : nested_size(type_url_tag, type_url.size()) + nested_size(value_tag, envelope_size);
+
+  auto header_sz = sizeof(MachineId) + sizeof(Channel);
+  zmq::message_t msg(header_sz + frame_size);
+  google::protobuf::io::ArrayOutputStream array(msg.data<char>() + header_sz, frame_size);
+  CodedOutputStream out(&array);
+  if (lean) {
+    const uint8_t lean_frame_header[kLeanFrameHeaderSize] = {kLeanFrameMarker,
+                                                             static_cast<uint8_t>(LeanMessageType::ENVELOPE)};
+    out.WriteRaw(lean_frame_header, kLeanFrameHeaderSize);
+  } else {
+    out.WriteTag(type_url_tag);
+    out.WriteVarint32(type_url.size());
+    out.WriteString(type_url);
+    out.WriteTag(value_tag);
+    out.WriteVarint32(envelope_size);
+  }
+  out.WriteTag(request_tag);
+  out.WriteVarint32(request_size);
+  out.WriteTag(forward_batch_data_tag);
+  out.WriteVarint32(forward_batch_data_size);
+  for (auto batch : batch_data) {
+    out.WriteTag(batch_data_tag);
+    out.WriteVarint32(batch.size());
+    out.WriteRaw(batch.data(), batch.size());
+  }
+  if (generator != 0) {
+    out.WriteTag(generator_tag);
+    out.WriteVarint32(generator);
+  }
+  if (generator_position != 0) {
+    out.WriteTag(generator_position_tag);
+    out.WriteVarint32(generator_position);
+  }
+  return msg;
+}
+
+/**
+ * Calls fn on the content of every length-delimited field with the given number in a serialized
+ * message without parsing the content. Returns false if the message is malformed
+ */
+template <typename Function>
+inline bool ForEachSerializedField(std::string_view msg, int field_number, Function fn) {
+  using google::protobuf::internal::WireFormatLite;
+
+  google::protobuf::io::CodedInputStream in(reinterpret_cast<const uint8_t*>(msg.data()), msg.size());
+  while (auto tag = in.ReadTag()) {
+    if (WireFormatLite::GetTagFieldNumber(tag) == field_number &&
+        WireFormatLite::GetTagWireType(tag) == WireFormatLite::WIRETYPE_LENGTH_DELIMITED) {
+      uint32_t size;
+      if (!in.ReadVarint32(&size)) {
+        return false;
+      }
+      size_t pos = in.CurrentPosition();
+      if (size > msg.size() - pos) {
+        return false;
+      }
+      fn(msg.substr(pos, size));
+      in.Skip(size);
+    } else if (!WireFormatLite::SkipField(&in, tag)) {
+      return false;
+    }
+  }
+  return static_cast<size_t>(in.CurrentPosition()) == msg.size();
+}
+
+/**
+ * Finds the serialized batch partitions in a buffer that holds a ForwardBatchData request, as
+ * produced by SerializeProto or SerializeForwardBatchData, so that they can be forwarded
+ * without being serialized again
+ */
+inline bool FindSerializedBatchData(std::string_view serialized, std::vector<std::string_view>& batch_data) {
+  auto header_sz = sizeof(MachineId) + sizeof(Channel);
+  if (serialized.size() < header_sz) {
+    return false;
+  }
+  // Singular message fields are taken from their last occurrence, as in a parser
+  auto find_last = [](std::string_view msg, int field_number) {
+    std::optional<std::string_view> found;
+    if (!ForEachSerializedField(msg, field_number, [&found](std::string_view field) { found = field; })) {
+      found.reset();
+    }
+    return found;
+  };
+  auto frame = serialized.substr(header_sz);
+  std::optional<std::string_view> envelope;
+  if (!frame.empty() && static_cast<uint8_t>(frame[0]) == kLeanFrameMarker) {
+    if (frame.size() >= kLeanFrameHeaderSize &&
+        static_cast<uint8_t>(frame[1]) == static_cast<uint8_t>(LeanMessageType::ENVELOPE)) {
+      envelope = frame.substr(kLeanFrameHeaderSize);
+    }
+  } else {
+    envelope = find_last(frame, google::protobuf::Any::kValueFieldNumber);
+  }
+  if (!envelope.has_value()) {
+    return false;
+  }
+  auto request = find_last(envelope.value(), internal::Envelope::kRequestFieldNumber);
+  if (!request.has_value()) {
+    return false;
+  }
+  auto forward_batch_data = find_last(request.value(), internal::Request::kForwardBatchDataFieldNumber);
+  if (!forward_batch_data.has_value()) {
+    return false;
+  }
+  batch_data.clear();
+  return ForEachSerializedField(forward_batch_data.value(), internal::ForwardBatchData::kBatchDataFieldNumber,
+                                [&batch_data](std::string_view batch) { batch_data.push_back(batch); });
+}
+
+}  // namespace slog
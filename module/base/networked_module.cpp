@@ -1,6 +1,7 @@
 #include "module/base/networked_module.h"
 
 #include <glog/logging.h>
+#include <unistd.h>
 
 #include <sstream>
 
@@ -56,6 +57,8 @@ void NetworkedModule::AddCustomSocket(zmq::socket_t&& new_socket) {
 
 zmq::socket_t& NetworkedModule::GetCustomSocket(size_t i) { return custom_sockets_.at(i); }
 
+void NetworkedModule::AddCustomEventFd(int fd) { custom_event_fds_.emplace_back(poller_.PushFd(fd), fd); }
+
 void NetworkedModule::SetUp() {
   VLOG(1) << "Thread info (" << name() << "): " << debug_info_;
 
@@ -83,19 +86,47 @@ void NetworkedModule::SetUp() {
 }
 
 bool NetworkedModule::Loop() {
-  if (!poller_.NextEvent(recv_retries_ > 0 /* dont_wait */)) {
-    return false;
+  ProcessEvents();
+  // Small messages sent in this iteration are coalesced until here, before the module waits again
+  sender_.Flush();
+  return false;
+}
+
+void NetworkedModule::ProcessEvents() {
+  bool dont_wait = recv_retries_ > 0;
+  if (!poller_.NextEvent(dont_wait)) {
+    return;
   }
 
-  if (OnEnvelopeReceived(RecvEnvelope(inproc_socket_, true /* dont_wait */))) {
+  // The readiness of the poll items is only updated when the poller actually polls
+  if (!dont_wait) {
+    for (auto [i, fd] : custom_event_fds_) {
+      if (poller_.is_socket_ready(i)) {
+        uint64_t val;
+        [[maybe_unused]] auto res = read(fd, &val, sizeof(val));
+      }
+    }
+  }
+
+  zmq::message_t raw;
+  if (EnvelopePtr env; RecvEnvelopeOrRawMessage(inproc_socket_, env, raw, true /* dont_wait */)) {
     recv_retries_ = kRecvRetries;
+    if (env != nullptr) {
+      OnEnvelopeReceived(move(env));
+    } else {
+      OnRawMessage(raw);
+    }
   }
 
   if (outproc_socket_.handle() != ZMQ_NULLPTR) {
-    if (zmq::message_t msg; outproc_socket_.recv(msg, zmq::recv_flags::dontwait)) {
-      auto env = DeserializeEnvelope(msg);
-      if (OnEnvelopeReceived(move(env))) {
-        recv_retries_ = kRecvRetries;
+    if (outproc_socket_.recv(raw, zmq::recv_flags::dontwait)) {
+      recv_retries_ = kRecvRetries;
+      if (Channel chan; ParseChannel(chan, raw) && chan == kCoalescedMessagesTag) {
+        if (!ForEachCoalescedMessage(raw, [this](zmq::message_t&& msg) { OnRawMessage(msg); })) {
+          LOG(ERROR) << "Malformed coalesced messages";
+        }
+      } else {
+        OnRawMessage(raw);
       }
     }
   }
@@ -107,23 +138,24 @@ bool NetworkedModule::Loop() {
   if (recv_retries_ > 0) {
     recv_retries_--;
   }
+}
 
-  return false;
+void NetworkedModule::OnRawMessage(const zmq::message_t& msg) {
+  if (OnRawMessageReceived(msg)) {
+    return;
+  }
+  auto env = DeserializeEnvelope(msg);
+  if (env == nullptr) {
+    LOG(ERROR) << "Malformed message";
+    return;
+  }
+  OnEnvelopeReceived(move(env));
 }
 
-bool NetworkedModule::OnEnvelopeReceived(EnvelopePtr&& wrapped_env) {
-  if (wrapped_env == nullptr) {
+bool NetworkedModule::OnEnvelopeReceived(EnvelopePtr&& env) {
+  if (env == nullptr) {
     return false;
   }
-  EnvelopePtr env;
-  if (wrapped_env->type_case() == Envelope::TypeCase::kRaw) {
-    env.reset(new Envelope());
-    if (DeserializeProto(*env, wrapped_env->raw().data(), wrapped_env->raw().size())) {
-      env->set_from(wrapped_env->from());
-    }
-  } else {
-    env = move(wrapped_env);
-  }
 
   if (env->has_request()) {
     OnInternalRequestReceived(move(env));
@@ -152,6 +184,15 @@ void NetworkedModule::Send(EnvelopePtr&& env, const std::vector<MachineId>& to_m
   sender_.Send(move(env), to_machine_ids, to_channel);
 }
 
+void NetworkedModule::Send(zmq::message_t&& serialized, MachineId to_machine_id, Channel to_channel) {
+  sender_.Send(move(serialized), to_machine_id, to_channel);
+}
+
+void NetworkedModule::Send(zmq::message_t&& serialized, const std::vector<MachineId>& to_machine_ids,
+                           Channel to_channel) {
+  sender_.Send(move(serialized), to_machine_ids, to_channel);
+}
+
 Poller::Handle NetworkedModule::NewTimedCallback(std::chrono::microseconds timeout, std::function<void()>&& cb) {
   return poller_.AddTimedCallback(timeout, std::move(cb));
 }
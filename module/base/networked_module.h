@@ -53,18 +53,33 @@ class NetworkedModule : public Module {
 
   virtual void OnInternalResponseReceived(EnvelopePtr&& /* env */) {}
 
+  /**
+   * Lets a module deserialize a message from another machine by itself, e.g. into an arena. The
+   * message is the one received by the broker, starting with the header that holds the sender.
+   * Returns false to let the message be deserialized on the heap and passed to the handlers above
+   */
+  virtual bool OnRawMessageReceived(const zmq::message_t& /* msg */) { return false; }
+
   // Returns true if useful work was done
   virtual bool OnCustomSocket() { return false; }
 
   void AddCustomSocket(zmq::socket_t&& new_socket);
   zmq::socket_t& GetCustomSocket(size_t i);
 
+  /**
+   * Wakes up the module when the given eventfd is signaled. The eventfd is reset
+   * right after the wake-up, before OnCustomSocket is called
+   */
+  void AddCustomEventFd(int fd);
+
   inline static EnvelopePtr NewEnvelope() { return std::make_unique<internal::Envelope>(); }
   void Send(const internal::Envelope& env, MachineId to_machine_id, Channel to_channel);
   void Send(EnvelopePtr&& env, MachineId to_machine_id, Channel to_channel);
   void Send(EnvelopePtr&& env, Channel to_channel);
   void Send(const internal::Envelope& env, const std::vector<MachineId>& to_machine_ids, Channel to_channel);
   void Send(EnvelopePtr&& env, const std::vector<MachineId>& to_machine_ids, Channel to_channel);
+  void Send(zmq::message_t&& serialized, MachineId to_machine_id, Channel to_channel);
+  void Send(zmq::message_t&& serialized, const std::vector<MachineId>& to_machine_ids, Channel to_channel);
 
   // Returns the callback's id
   Poller::Handle NewTimedCallback(std::chrono::microseconds timeout, std::function<void()>&& cb);
@@ -78,8 +93,10 @@ class NetworkedModule : public Module {
  private:
   void SetUp() final;
   bool Loop() final;
+  void ProcessEvents();
 
-  bool OnEnvelopeReceived(EnvelopePtr&& wrapped_env);
+  void OnRawMessage(const zmq::message_t& msg);
+  bool OnEnvelopeReceived(EnvelopePtr&& env);
 
   std::shared_ptr<zmq::context_t> context_;
   ConfigurationPtr config_;
@@ -89,6 +106,8 @@ class NetworkedModule : public Module {
   zmq::socket_t inproc_socket_;
   zmq::socket_t outproc_socket_;
   std::vector<zmq::socket_t> custom_sockets_;
+  // Pairs of (position in the poller, eventfd)
+  std::vector<std::pair<size_t, int>> custom_event_fds_;
   Sender sender_;
   Poller poller_;
   int recv_retries_;
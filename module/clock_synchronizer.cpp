@@ -5,24 +5,35 @@
 
 namespace slog {
 
+namespace {
+
+// How often the clock is slewed toward the estimated offset
+const std::chrono::milliseconds kAdjustmentInterval(1);
+// Corrections larger than this are applied at once instead of being slewed
+const std::chrono::milliseconds kStepThreshold(128);
+
+}  // namespace
+
 ClockSynchronizer::ClockSynchronizer(const std::shared_ptr<zmq::context_t>& context, const ConfigurationPtr& config,
                                      const MetricsRepositoryManagerPtr& metrics_manager,
                                      std::chrono::milliseconds poll_timeout_ms)
     : NetworkedModule(context, config, config->clock_synchronizer_port(), kClockSynchronizerChannel, metrics_manager,
-                      poll_timeout_ms) {
+                      poll_timeout_ms),
+      synced_(false) {
   CHECK_NE(config->clock_synchronizer_port(), 0) << "Cannot initialize clock synchronizer with port 0";
 
-  size_t avg_window;
+  // The sample with the lowest round-trip time is selected from the last second of samples
+  size_t filter_window;
   if (config->clock_sync_interval().count() == 0) {
-    avg_window = 1;
+    filter_window = 1;
   } else {
-    avg_window = std::max(2, 1000 / static_cast<int>(config->clock_sync_interval().count()));
+    filter_window = std::max(2, 1000 / static_cast<int>(config->clock_sync_interval().count()));
   }
 
   for (int p = 0; p < config->num_partitions(); p++) {
     auto m = MakeMachineId(config->local_region(), config->local_replica(), p);
     if (m != config->local_machine_id()) {
-      latencies_ns_.emplace(m, avg_window);
+      estimators_.emplace(m, filter_window);
     }
   }
 
@@ -31,7 +42,7 @@ ClockSynchronizer::ClockSynchronizer(const std::shared_ptr<zmq::context_t>& cont
     for (int r = 0; r < config->num_regions(); r++) {
       auto m = MakeMachineId(r, 0, leader_partition);
       if (m != config->local_machine_id()) {
-        latencies_ns_.emplace(m, avg_window);
+        estimators_.emplace(m, filter_window);
       }
     }
   }
@@ -40,12 +51,14 @@ ClockSynchronizer::ClockSynchronizer(const std::shared_ptr<zmq::context_t>& cont
 void ClockSynchronizer::Initialize() {
   if (config()->clock_sync_interval() > std::chrono::milliseconds(0)) {
     ScheduleNextSync();
+    last_adjustment_time_ = std::chrono::steady_clock::now();
+    ScheduleNextAdjustment();
   }
 }
 
 void ClockSynchronizer::ScheduleNextSync() {
   NewTimedCallback(config()->clock_sync_interval(), [this] {
-    for (auto kv : latencies_ns_) {
+    for (auto& kv : estimators_) {
       internal::Envelope env;
       auto ping = env.mutable_request()->mutable_ping();
       ping->set_src_time(std::chrono::steady_clock::now().time_since_epoch().count());
@@ -56,6 +69,13 @@ void ClockSynchronizer::ScheduleNextSync() {
   });
 }
 
+void ClockSynchronizer::ScheduleNextAdjustment() {
+  NewTimedCallback(kAdjustmentInterval, [this] {
+    AdjustClock();
+    ScheduleNextAdjustment();
+  });
+}
+
 void ClockSynchronizer::OnInternalRequestReceived(EnvelopePtr&& env) {
   if (!env->request().has_ping()) {
     LOG(ERROR) << "Unexpected request type received: \"" << CASE_NAME(env->request().type_case(), internal::Request)
@@ -72,28 +92,70 @@ void ClockSynchronizer::OnInternalRequestReceived(EnvelopePtr&& env) {
 
 void ClockSynchronizer::OnInternalResponseReceived(EnvelopePtr&& env) {
   auto now = std::chrono::steady_clock::now().time_since_epoch().count();
-  auto slog_now = slog_clock::now().time_since_epoch().count();
+  // The offsets are estimated against the unadjusted local clock so that the corrections made
+  // here are not mistaken for drift
+  auto system_now = std::chrono::system_clock::now().time_since_epoch().count();
 
   const auto& pong = env->response().pong();
-  auto it = latencies_ns_.find(pong.dst());
-  if (it == latencies_ns_.end()) {
+  auto it = estimators_.find(pong.dst());
+  if (it == estimators_.end()) {
     LOG(ERROR) << "Invalid clock sync peer: " << MACHINE_ID_STR(pong.dst());
     return;
   }
 
-  auto& latency_ns = it->second;
-  latency_ns.Add((now - pong.src_time()) / 2);
+  auto& estimator = it->second;
+  auto rtt = now - pong.src_time();
+  estimator.AddSample(system_now - rtt / 2, pong.dst_time(), rtt);
 
-  auto avg_latency_ns = static_cast<int64_t>(latency_ns.avg());
-  auto estimated_remote_clock = pong.dst_time() + avg_latency_ns;
-  if (estimated_remote_clock > slog_now) {
-    slog_clock::offset_ += estimated_remote_clock - slog_now;
-  }
+  AdjustClock();
 
   if (per_thread_metrics_repo != nullptr) {
-    per_thread_metrics_repo->RecordClockSync(pong.dst(), pong.src_time(), pong.dst_time(), now, slog_now,
-                                             avg_latency_ns, slog_clock::offset_.load());
+    per_thread_metrics_repo->RecordClockSync(pong.dst(), pong.src_time(), pong.dst_time(), now,
+                                             slog_clock::now().time_since_epoch().count(), estimator.min_rtt() / 2,
+                                             slog_clock::offset_.load(), estimator.ErrorBoundAt(system_now));
+  }
+}
+
+void ClockSynchronizer::AdjustClock() {
+  auto now = std::chrono::steady_clock::now();
+  auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(now - last_adjustment_time_);
+  last_adjustment_time_ = now;
+
+  auto system_now = std::chrono::system_clock::now().time_since_epoch().count();
+  auto offset = slog_clock::offset_.load();
+
+  // Follow the peer clock that is furthest ahead
+  bool has_estimate = false;
+  int64_t target_offset = offset;
+  for (const auto& kv : estimators_) {
+    if (kv.second.has_estimate()) {
+      has_estimate = true;
+      target_offset = std::max(target_offset, kv.second.OffsetAt(system_now));
+    }
+  }
+  if (!has_estimate) {
+    return;
+  }
+
+  auto correction = target_offset - offset;
+  if (!synced_ || correction > std::chrono::nanoseconds(kStepThreshold).count()) {
+    offset = target_offset;
+    synced_ = true;
+  } else {
+    auto max_slew = elapsed.count() * static_cast<int64_t>(config()->clock_max_slew_ppm()) / 1000000;
+    offset += std::min(correction, max_slew);
+  }
+  slog_clock::offset_ = offset;
+
+  // The bound covers the peer clocks that are behind and the part of the correction not applied yet
+  int64_t error_bound = 0;
+  for (const auto& kv : estimators_) {
+    if (kv.second.has_estimate()) {
+      auto error = std::abs(kv.second.OffsetAt(system_now) - offset) + kv.second.ErrorBoundAt(system_now);
+      error_bound = std::max(error_bound, error);
+    }
   }
+  slog_clock::error_bound_ = error_bound;
 }
 
-}  // namespace slog
\ No newline at end of file
+}  // namespace slog
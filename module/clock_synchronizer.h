@@ -3,11 +3,20 @@
 #include <unordered_map>
 
 #include "common/clock.h"
-#include "common/rolling_window.h"
+#include "common/clock_offset_estimator.h"
 #include "module/base/networked_module.h"
 
 namespace slog {
 
+/**
+ * Synchronizes the slog clock with the clocks of the other partitions in the same replica and,
+ * at the leader partition for multi-home ordering, with the leader partitions of other regions.
+ *
+ * The offset of each peer clock is estimated from periodic pings with ClockOffsetEstimator. The
+ * local clock follows the furthest ahead peer clock, including its predicted drift, and is never
+ * moved backward. It is stepped when it is first synchronized or is off by a lot, and is otherwise
+ * slewed at a bounded rate so that the gaps between timestamps taken close together stay accurate.
+ */
 class ClockSynchronizer : public NetworkedModule {
  public:
   ClockSynchronizer(const std::shared_ptr<zmq::context_t>& context, const ConfigurationPtr& config,
@@ -23,8 +32,12 @@ class ClockSynchronizer : public NetworkedModule {
 
  private:
   void ScheduleNextSync();
+  void ScheduleNextAdjustment();
+  void AdjustClock();
 
-  std::unordered_map<MachineId, RollingWindow<int64_t>> latencies_ns_;
+  std::unordered_map<MachineId, ClockOffsetEstimator> estimators_;
+  bool synced_;
+  std::chrono::steady_clock::time_point last_adjustment_time_;
 };
 
-}  // namespace slog
\ No newline at end of file
+}  // namespace slog
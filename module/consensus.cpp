@@ -52,9 +52,10 @@ Members GetMembers(const ConfigurationPtr& config) {
 
 }  // namespace
 
-GlobalPaxos::GlobalPaxos(const shared_ptr<Broker>& broker, std::chrono::milliseconds poll_timeout)
+GlobalPaxos::GlobalPaxos(const shared_ptr<Broker>& broker, const MetricsRepositoryManagerPtr& metrics_manager,
+                         std::chrono::milliseconds poll_timeout)
     : SimulatedMultiPaxos(kGlobalPaxos, broker, GetMembers(broker->config()), broker->config()->local_machine_id(),
-                          poll_timeout),
+                          poll_timeout, broker->config()->global_paxos_durability(), metrics_manager),
       local_machine_id_(broker->config()->local_machine_id()) {
   auto& config = broker->config();
   auto part = config->leader_partition_for_multi_home_ordering();
@@ -74,9 +75,10 @@ void GlobalPaxos::OnCommit(uint32_t slot, int64_t value, MachineId leader) {
   Send(std::move(env), multihome_orderers_, kMultiHomeOrdererChannel);
 }
 
-LocalPaxos::LocalPaxos(const shared_ptr<Broker>& broker, std::chrono::milliseconds poll_timeout)
+LocalPaxos::LocalPaxos(const shared_ptr<Broker>& broker, const MetricsRepositoryManagerPtr& metrics_manager,
+                       std::chrono::milliseconds poll_timeout)
     : SimulatedMultiPaxos(kLocalPaxos, broker, GetMembers(broker->config()), broker->config()->local_machine_id(),
-                          poll_timeout),
+                          poll_timeout, broker->config()->local_paxos_durability(), metrics_manager),
       local_log_channel_(kLogManagerChannel + broker->config()->local_region() % broker->config()->num_log_managers()) {
 }
 
@@ -6,7 +6,8 @@ namespace slog {
 
 class GlobalPaxos : public SimulatedMultiPaxos {
  public:
-  GlobalPaxos(const std::shared_ptr<Broker>& broker, std::chrono::milliseconds poll_timeout = kModuleTimeout);
+  GlobalPaxos(const std::shared_ptr<Broker>& broker, const MetricsRepositoryManagerPtr& metrics_manager,
+              std::chrono::milliseconds poll_timeout = kModuleTimeout);
 
  protected:
   void OnCommit(uint32_t slot, int64_t value, MachineId leader) final;
@@ -18,7 +19,8 @@ class GlobalPaxos : public SimulatedMultiPaxos {
 
 class LocalPaxos : public SimulatedMultiPaxos {
  public:
-  LocalPaxos(const std::shared_ptr<Broker>& broker, std::chrono::milliseconds poll_timeout = kModuleTimeout);
+  LocalPaxos(const std::shared_ptr<Broker>& broker, const MetricsRepositoryManagerPtr& metrics_manager,
+             std::chrono::milliseconds poll_timeout = kModuleTimeout);
 
  protected:
   void OnCommit(uint32_t slot, int64_t value, MachineId leader) final;
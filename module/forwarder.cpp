@@ -39,11 +39,12 @@ Forwarder::Forwarder(const std::shared_ptr<zmq::context_t>& context, const Confi
       sharder_(Sharder::MakeSharder(config)),
       lookup_master_index_(lookup_master_index),
       metadata_initializer_(metadata_initializer),
+      metadata_cache_(config->forwarder_metadata_cache_size()),
       partitioned_lookup_request_(config->num_partitions()),
       batch_size_(0),
       rg_(std::random_device{}()) {
   for (int i = 0; i < config->num_regions(); i++) {
-    latencies_ns_.emplace_back(config->avg_latency_window_size());
+    latencies_ns_.emplace_back(config->avg_latency_window_size(), config->mh_timestamp_latency_percentile());
   }
 }
 
@@ -76,6 +77,9 @@ void Forwarder::OnInternalRequestReceived(EnvelopePtr&& env) {
     case Request::kLookupMaster:
       ProcessLookUpMasterRequest(move(env));
       break;
+    case Request::kMasterUpdate:
+      ProcessMasterUpdate(env->request().master_update());
+      break;
     case Request::kStats:
       ProcessStatsRequest(env->request().stats());
       break;
@@ -118,6 +122,11 @@ void Forwarder::ProcessForwardTxn(EnvelopePtr&& env) {
         value->mutable_metadata()->set_counter(new_metadata.counter);
       }
     }
+    // Otherwise, use the cached master info if any. A stale entry is caught by the master check at the workers
+    else if (Metadata metadata; metadata_cache_.Get(key, metadata)) {
+      value->mutable_metadata()->set_master(metadata.master);
+      value->mutable_metadata()->set_counter(metadata.counter);
+    }
     // Otherwise, add the key to the appropriate remote lookup master request
     else {
       partitioned_lookup_request_[partition].mutable_request()->mutable_lookup_master()->add_keys(key);
@@ -201,6 +210,12 @@ void Forwarder::ProcessLookUpMasterRequest(EnvelopePtr&& env) {
   Send(lookup_env, env->from(), kForwarderChannel);
 }
 
+void Forwarder::ProcessMasterUpdate(const internal::MasterUpdate& master_update) {
+  for (const auto& update : master_update.updates()) {
+    metadata_cache_.Update(update.key(), Metadata(update.metadata()));
+  }
+}
+
 void Forwarder::OnInternalResponseReceived(EnvelopePtr&& env) {
   switch (env->response().type_case()) {
     case Response::kLookupMaster:
@@ -218,7 +233,9 @@ void Forwarder::UpdateMasterInfo(EnvelopePtr&& env) {
   const auto& lookup_master = env->response().lookup_master();
   std::unordered_map<std::string, int> index;
   for (int i = 0; i < lookup_master.lookup_results_size(); i++) {
-    index[lookup_master.lookup_results(i).key()] = i;
+    const auto& result = lookup_master.lookup_results(i);
+    index[result.key()] = i;
+    metadata_cache_.Put(result.key(), Metadata(result.metadata()));
   }
 
   for (auto txn_id : lookup_master.txn_ids()) {
@@ -301,18 +318,24 @@ void Forwarder::Forward(EnvelopePtr&& env) {
       auto part = config()->leader_partition_for_multi_home_ordering();
 
       if (config()->synchronized_batching()) {
-        // If synchronized batching is on, compute the batching delay based on latency between the current
-        // region to the involved regions
+        // If synchronized batching is on, compute the batching delay based on the predicted latency between
+        // the current region and the involved regions
         std::vector<MachineId> destinations;
-        int64_t max_avg_latency_ns = 0;
+        int64_t max_latency_ns = 0;
         for (auto reg : txn_internal->involved_regions()) {
-          max_avg_latency_ns = std::max(max_avg_latency_ns, static_cast<int64_t>(latencies_ns_[reg].avg()));
+          max_latency_ns = std::max(max_latency_ns, latencies_ns_[reg].estimate());
           destinations.push_back(MakeMachineId(reg, 0, part));
         }
 
+        // The buffer covers the error of the clocks, so the synchronizer's estimate replaces the static
+        // buffer once it is known
+        std::chrono::nanoseconds timestamp_buffer = std::chrono::microseconds(config()->timestamp_buffer_us());
+        if (auto error_bound = slog_clock::error_bound(); config()->dynamic_timestamp_buffer() && error_bound) {
+          timestamp_buffer = 2 * error_bound.value();
+        }
+
         auto now = slog_clock::now();
-        auto timestamp = now + std::chrono::nanoseconds(max_avg_latency_ns) +
-                         std::chrono::microseconds(config()->timestamp_buffer_us());
+        auto timestamp = now + std::chrono::nanoseconds(max_latency_ns) + timestamp_buffer;
 
         auto txn = env->mutable_request()->mutable_forward_txn()->mutable_txn();
         txn->mutable_internal()->set_timestamp(timestamp.time_since_epoch().count());
@@ -344,7 +367,11 @@ void Forwarder::Forward(EnvelopePtr&& env) {
  * {
  *    forw_batch_size:    int,
  *    forw_pending_txns:  [uint64],
- *    forw_num_pending_txns: int
+ *    forw_num_pending_txns: int,
+ *    forw_metadata_cache_size: int,
+ *    forw_metadata_cache_hits: uint64,
+ *    forw_metadata_cache_misses: uint64,
+ *    forw_metadata_cache_hit_rate: double
  * }
  */
 void Forwarder::ProcessStatsRequest(const internal::StatsRequest& stats_request) {
@@ -363,6 +390,13 @@ void Forwarder::ProcessStatsRequest(const internal::StatsRequest& stats_request)
 
   stats.AddMember(StringRef(FORW_BATCH_SIZE), batch_size_, alloc);
   stats.AddMember(StringRef(FORW_NUM_PENDING_TXNS), pending_transactions_.size(), alloc);
+  auto cache_hits = metadata_cache_.num_hits();
+  auto cache_lookups = cache_hits + metadata_cache_.num_misses();
+  stats.AddMember(StringRef(FORW_METADATA_CACHE_SIZE), metadata_cache_.size(), alloc);
+  stats.AddMember(StringRef(FORW_METADATA_CACHE_HITS), cache_hits, alloc);
+  stats.AddMember(StringRef(FORW_METADATA_CACHE_MISSES), metadata_cache_.num_misses(), alloc);
+  stats.AddMember(StringRef(FORW_METADATA_CACHE_HIT_RATE),
+                  cache_lookups == 0 ? 0.0 : static_cast<double>(cache_hits) / cache_lookups, alloc);
   if (level > 0) {
     stats.AddMember(StringRef(FORW_PENDING_TXNS),
                     ToJsonArray(
@@ -5,11 +5,12 @@
 
 #include "common/configuration.h"
 #include "common/metrics.h"
-#include "common/rolling_window.h"
 #include "common/sharder.h"
 #include "common/types.h"
 #include "connection/broker.h"
 #include "module/base/networked_module.h"
+#include "module/forwarder_components/latency_estimator.h"
+#include "module/forwarder_components/metadata_cache.h"
 #include "proto/transaction.pb.h"
 #include "storage/lookup_master_index.h"
 #include "storage/metadata_initializer.h"
@@ -21,9 +22,10 @@ namespace slog {
  * then forwards it to the appropriate module.
  *
  * To determine the type of a txn, it sends LookupMasterRequests to other Forwarder
- * modules in the same region and aggregates the responses.
+ * modules in the same region and aggregates the responses. The looked up metadata
+ * is cached so that later txns on the same keys can skip the lookup.
  *
- * INPUT:  ForwardTransaction and LookUpMasterRequest
+ * INPUT:  ForwardTransaction, LookUpMasterRequest and MasterUpdate
  *
  * OUTPUT: If the txn is single-home, forward to the Sequencer in its home region.
  *         If the txn is multi-home, forward to the MultiHomeOrderer for ordering;
@@ -52,6 +54,7 @@ class Forwarder : public NetworkedModule {
   void ScheduleNextLatencyProbe();
   void ProcessForwardTxn(EnvelopePtr&& env);
   void ProcessLookUpMasterRequest(EnvelopePtr&& env);
+  void ProcessMasterUpdate(const internal::MasterUpdate& master_update);
   void ProcessStatsRequest(const internal::StatsRequest& stats_request);
 
   void SendLookupMasterRequestBatch();
@@ -67,10 +70,11 @@ class Forwarder : public NetworkedModule {
   const SharderPtr sharder_;
   std::shared_ptr<LookupMasterIndex> lookup_master_index_;
   std::shared_ptr<MetadataInitializer> metadata_initializer_;
+  MetadataCache metadata_cache_;
   std::unordered_map<TxnId, EnvelopePtr> pending_transactions_;
   std::vector<internal::Envelope> partitioned_lookup_request_;
   int batch_size_;
-  std::vector<RollingWindow<int64_t>> latencies_ns_;
+  std::vector<LatencyEstimator> latencies_ns_;
   std::chrono::steady_clock::time_point batch_starting_time_;
 
   std::mt19937 rg_;
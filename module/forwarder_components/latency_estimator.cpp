@@ -0,0 +1,39 @@
+#include "module/forwarder_components/latency_estimator.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace slog {
+
+LatencyEstimator::LatencyEstimator(size_t window_size, double percentile)
+    : window_size_(std::max<size_t>(window_size, 1)),
+      percentile_(std::clamp(percentile, 0.0, 100.0)),
+      next_(0),
+      sum_(0),
+      estimate_(0) {
+  samples_.reserve(window_size_);
+}
+
+void LatencyEstimator::Add(int64_t latency) {
+  if (samples_.size() < window_size_) {
+    samples_.push_back(latency);
+  } else {
+    sum_ -= samples_[next_];
+    samples_[next_] = latency;
+    next_ = (next_ + 1) % window_size_;
+  }
+  sum_ += latency;
+
+  if (percentile_ == 0) {
+    estimate_ = static_cast<int64_t>(avg());
+    return;
+  }
+  // Nearest-rank percentile
+  scratch_.assign(samples_.begin(), samples_.end());
+  auto rank = static_cast<size_t>(std::ceil(percentile_ / 100 * scratch_.size()));
+  auto nth = scratch_.begin() + std::max<size_t>(rank, 1) - 1;
+  std::nth_element(scratch_.begin(), nth, scratch_.end());
+  estimate_ = *nth;
+}
+
+}  // namespace slog
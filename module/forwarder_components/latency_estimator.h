@@ -0,0 +1,41 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace slog {
+
+/**
+ * Predicts the latency to a region from the most recent latency probes. The prediction is the
+ * given percentile of the probes in the window, so that a high percentile covers the jitter that
+ * an average hides. With a percentile of 0, the prediction is the average of the window.
+ *
+ * The percentile is recomputed when a probe is added rather than when it is read, since probes
+ * are much less frequent than predictions.
+ */
+class LatencyEstimator {
+ public:
+  /**
+   * @param window_size Number of recent probes kept
+   * @param percentile  Target percentile in (0, 100], or 0 for the average
+   */
+  LatencyEstimator(size_t window_size, double percentile);
+
+  void Add(int64_t latency);
+
+  int64_t estimate() const { return estimate_; }
+  double avg() const { return samples_.empty() ? 0 : static_cast<double>(sum_) / samples_.size(); }
+
+ private:
+  size_t window_size_;
+  double percentile_;
+  // A ring of the samples in the window, the oldest at next_ once it is full
+  std::vector<int64_t> samples_;
+  size_t next_;
+  int64_t sum_;
+  int64_t estimate_;
+  std::vector<int64_t> scratch_;
+};
+
+}  // namespace slog
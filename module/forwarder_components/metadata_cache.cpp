@@ -0,0 +1,47 @@
+#include "module/forwarder_components/metadata_cache.h"
+
+namespace slog {
+
+MetadataCache::MetadataCache(size_t capacity) : capacity_(capacity), num_hits_(0), num_misses_(0) {
+  entries_.reserve(capacity);
+}
+
+bool MetadataCache::Get(const Key& key, Metadata& metadata) {
+  auto it = entries_.find(key);
+  if (it == entries_.end()) {
+    num_misses_++;
+    return false;
+  }
+  num_hits_++;
+  lru_.splice(lru_.begin(), lru_, it->second.lru_it);
+  metadata = it->second.metadata;
+  return true;
+}
+
+void MetadataCache::Put(const Key& key, const Metadata& metadata) {
+  if (capacity_ == 0) {
+    return;
+  }
+  if (auto it = entries_.find(key); it != entries_.end()) {
+    if (metadata.counter >= it->second.metadata.counter) {
+      it->second.metadata = metadata;
+    }
+    lru_.splice(lru_.begin(), lru_, it->second.lru_it);
+    return;
+  }
+  if (entries_.size() >= capacity_) {
+    entries_.erase(lru_.back());
+    lru_.pop_back();
+  }
+  lru_.push_front(key);
+  entries_.emplace(key, Entry{.metadata = metadata, .lru_it = lru_.begin()});
+}
+
+void MetadataCache::Update(const Key& key, const Metadata& metadata) {
+  auto it = entries_.find(key);
+  if (it != entries_.end() && metadata.counter >= it->second.metadata.counter) {
+    it->second.metadata = metadata;
+  }
+}
+
+}  // namespace slog
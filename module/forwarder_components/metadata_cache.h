@@ -0,0 +1,57 @@
+#pragma once
+
+#include <list>
+#include <unordered_map>
+
+#include "common/types.h"
+
+namespace slog {
+
+/**
+ * Caches the master metadata of keys owned by other partitions so that the forwarder does not
+ * need to look them up remotely again. A cached entry may be stale after a remaster, in which
+ * case the txn carrying it fails the master check at the workers and is aborted, the same as
+ * when the master of a key changes while the txn is in flight.
+ *
+ * Entries are kept up to date by the new metadata that the schedulers send after each remaster.
+ * Since a remaster always increments the counter of a key, an update with a counter lower than
+ * the cached one is outdated and ignored.
+ *
+ * When the cache is full, the least recently used entry is evicted.
+ */
+class MetadataCache {
+ public:
+  /**
+   * @param capacity Max number of cached keys. 0 disables the cache
+   */
+  explicit MetadataCache(size_t capacity);
+
+  bool Get(const Key& key, Metadata& metadata);
+  void Put(const Key& key, const Metadata& metadata);
+
+  /**
+   * Updates the entry of a key if it is cached. Unlike Put, this does not add the key to the
+   * cache nor count as a use of the entry
+   */
+  void Update(const Key& key, const Metadata& metadata);
+
+  size_t size() const { return entries_.size(); }
+  size_t capacity() const { return capacity_; }
+  uint64_t num_hits() const { return num_hits_; }
+  uint64_t num_misses() const { return num_misses_; }
+
+ private:
+  struct Entry {
+    Metadata metadata;
+    std::list<Key>::iterator lru_it;
+  };
+
+  size_t capacity_;
+  std::unordered_map<Key, Entry> entries_;
+  // Most recently used keys are at the front
+  std::list<Key> lru_;
+  uint64_t num_hits_;
+  uint64_t num_misses_;
+};
+
+}  // namespace slog
@@ -318,7 +318,7 @@ std::unordered_set<TxnId> Scheduler::FindAndResolveSCCs(Vertex& v, vector<TxnId>
 
   if (per_thread_metrics_repo != nullptr) {
     per_thread_metrics_repo->RecordDeadlockResolverRun(v.txn_id, result.unready.size(), ready_txns.size(),
-                                                       result.sccs.size(), result.missing_deps.size());
+                                                       result.sccs.size(), result.missing_deps.size(), 0, 0);
   }
 
   return result.unready;
@@ -2,6 +2,8 @@
 
 #include <glog/logging.h>
 
+#include <algorithm>
+
 #include "common/configuration.h"
 #include "common/constants.h"
 #include "common/json_utils.h"
@@ -64,9 +66,12 @@ void LocalLog::UpdateReadyBatches() {
 }
 
 LogManager::LogManager(int id, const std::vector<RegionId>& regions, const shared_ptr<Broker>& broker,
-                       const MetricsRepositoryManagerPtr& metrics_manager, std::chrono::milliseconds poll_timeout)
+                       const MetricsRepositoryManagerPtr& metrics_manager, std::chrono::milliseconds poll_timeout,
+                       const shared_ptr<TxnQueue>& txn_queue, const shared_ptr<LogManagerBacklog>& backlog)
     : NetworkedModule(broker, Broker::ChannelOption(kLogManagerChannel + id, true, RegionsToTags(regions)),
-                      metrics_manager, poll_timeout, true /* is_long_sender */) {
+                      metrics_manager, poll_timeout, true /* is_long_sender */),
+      txn_queue_(txn_queue),
+      backlog_(backlog) {
   auto local_region = config()->local_region();
   auto local_replica = config()->local_replica();
   auto local_partition = config()->local_partition();
@@ -91,17 +96,45 @@ LogManager::LogManager(int id, const std::vector<RegionId>& regions, const share
   }
 }
 
-void LogManager::OnInternalRequestReceived(EnvelopePtr&& env) {
+void LogManager::OnInternalRequestReceived(EnvelopePtr&& env) { ProcessRequest(SharedEnvelope(move(env))); }
+
+bool LogManager::OnRawMessageReceived(const zmq::message_t& msg) {
+  std::string_view raw(msg.data<char>(), msg.size());
+  google::protobuf::ArenaOptions options;
+  // The deserialized messages take a few times the size of the serialized data. Starting with a
+  // large enough block makes the whole envelope fit in one or two allocations
+  options.start_block_size = std::max<size_t>(kMinArenaBlockSize, 4 * raw.size());
+  options.max_block_size = std::max(options.start_block_size, options.max_block_size);
+  auto arena = std::make_shared<google::protobuf::Arena>(options);
+  auto env = google::protobuf::Arena::CreateMessage<Envelope>(arena.get());
+  if (!DeserializeProto(*env, raw.data(), raw.size())) {
+    LOG(ERROR) << "Malformed message";
+    return true;
+  }
+  MachineId from = -1;
+  ParseMachineId(from, msg);
+  env->set_from(from);
+  // The envelope is owned by the arena so the shared pointer keeps the arena alive instead
+  ProcessRequest(SharedEnvelope(arena, env), raw);
+  return true;
+}
+
+bool LogManager::OnCustomSocket() {
+  // Keep polling while there are txns not yet handed to the scheduler
+  return txn_queue_ != nullptr && txn_queue_->Flush();
+}
+
+void LogManager::ProcessRequest(const SharedEnvelope& env, std::string_view serialized) {
   auto request = env->mutable_request();
   switch (request->type_case()) {
     case Request::kBatchReplicationAck:
-      ProcessBatchReplicationAck(std::move(env));
+      ProcessBatchReplicationAck(env);
       break;
     case Request::kForwardBatchData:
-      ProcessForwardBatchData(std::move(env));
+      ProcessForwardBatchData(env, serialized);
       break;
     case Request::kForwardBatchOrder:
-      ProcessForwardBatchOrder(std::move(env));
+      ProcessForwardBatchOrder(env);
       break;
     default:
       LOG(ERROR) << "Unexpected request type received: \"" << CASE_NAME(request->type_case(), Request) << "\"";
@@ -110,7 +143,7 @@ void LogManager::OnInternalRequestReceived(EnvelopePtr&& env) {
   AdvanceLog();
 }
 
-void LogManager::ProcessBatchReplicationAck(EnvelopePtr&& env) {
+void LogManager::ProcessBatchReplicationAck(const SharedEnvelope& env) {
   auto [from_region, from_replica, _] = UnpackMachineId(env->from());
   auto local_region = config()->local_region();
   auto local_replica = config()->local_replica();
@@ -132,7 +165,7 @@ void LogManager::ProcessBatchReplicationAck(EnvelopePtr&& env) {
   single_home_logs_[local_region].AckReplication(batch_id);
 }
 
-void LogManager::ProcessForwardBatchData(EnvelopePtr&& env) {
+void LogManager::ProcessForwardBatchData(const SharedEnvelope& env, std::string_view serialized) {
   auto local_region = config()->local_region();
   auto local_replica = config()->local_replica();
   auto local_partition = config()->local_partition();
@@ -145,8 +178,13 @@ void LogManager::ProcessForwardBatchData(EnvelopePtr&& env) {
   bool first_time_replica = first_time_region || from_replica != local_replica;
 
   if (first_time_region) {
-    // If this batch comes from a different region, distribute it to other local replicas
-    Send(*env, other_replicas_, MakeLogChannel(generator_home));
+    // If this batch comes from a different region, distribute it to other local replicas.
+    // The received buffer is forwarded as is if available
+    if (!serialized.empty()) {
+      Send(zmq::message_t(serialized.data(), serialized.size()), other_replicas_, MakeLogChannel(generator_home));
+    } else {
+      Send(*env, other_replicas_, MakeLogChannel(generator_home));
+    }
   }
 
   BatchPtr my_batch;
@@ -155,24 +193,38 @@ void LogManager::ProcessForwardBatchData(EnvelopePtr&& env) {
     // to the local partitions
 
     CHECK_EQ(forward_batch_data->batch_data_size(), config()->num_partitions());
-    PartitionId p = config()->num_partitions() - 1;
-    while (!forward_batch_data->mutable_batch_data()->empty()) {
-      auto batch_partition = forward_batch_data->mutable_batch_data()->ReleaseLast();
-      if (p == local_partition) {
-        my_batch = BatchPtr(batch_partition);
+
+    // Find the batch partitions in the received buffer so that they are forwarded without
+    // being serialized again
+    std::vector<std::string_view> serialized_batch_data;
+    bool has_serialized_batch_data =
+        !serialized.empty() && FindSerializedBatchData(serialized, serialized_batch_data) &&
+        serialized_batch_data.size() == static_cast<size_t>(config()->num_partitions());
+
+    for (int p = config()->num_partitions() - 1; p >= 0; p--) {
+      auto batch_partition = forward_batch_data->mutable_batch_data(p);
+      if (static_cast<PartitionId>(p) == local_partition) {
+        // The batch stays in the envelope, which is kept alive as long as the batch is
+        my_batch = BatchPtr(env, batch_partition);
+      } else if (has_serialized_batch_data) {
+        Send(SerializeForwardBatchData({serialized_batch_data[p]}, generator, generator_position,
+                                       config()->wire_format()),
+             MakeMachineId(local_region, local_replica, p), MakeLogChannel(generator_home));
       } else {
-        auto new_env = NewEnvelope();
-        auto new_forward_batch = new_env->mutable_request()->mutable_forward_batch_data();
+        Envelope new_env;
+        auto new_forward_batch = new_env.mutable_request()->mutable_forward_batch_data();
         new_forward_batch->set_generator(generator);
         new_forward_batch->set_generator_position(generator_position);
-        new_forward_batch->mutable_batch_data()->AddAllocated(batch_partition);
-        Send(*new_env, MakeMachineId(local_region, local_replica, p), MakeLogChannel(generator_home));
+        // Only lend the batch partition to the new envelope for serialization. It still
+        // belongs to the received envelope so it must be taken back before new_env is destroyed
+        new_forward_batch->mutable_batch_data()->UnsafeArenaAddAllocated(batch_partition);
+        Send(new_env, MakeMachineId(local_region, local_replica, p), MakeLogChannel(generator_home));
+        new_forward_batch->mutable_batch_data()->UnsafeArenaReleaseLast();
       }
-      p--;
     }
   } else {
     // If the batch comes from the same region and replica, no need to distribute further
-    my_batch = BatchPtr(forward_batch_data->mutable_batch_data()->ReleaseLast());
+    my_batch = BatchPtr(env, forward_batch_data->mutable_batch_data(forward_batch_data->batch_data_size() - 1));
   }
 
   RECORD(my_batch.get(), TransactionEvent::ENTER_LOG_MANAGER_IN_BATCH);
@@ -187,10 +239,14 @@ void LogManager::ProcessForwardBatchData(EnvelopePtr&& env) {
     local_log_.AddBatchId(generator, generator_position, my_batch->id());
   }
 
+  if (backlog_ != nullptr) {
+    backlog_->fetch_add(my_batch->transactions_size(), std::memory_order_relaxed);
+  }
+
   single_home_logs_[generator_home].AddBatch(move(my_batch));
 }
 
-void LogManager::ProcessForwardBatchOrder(EnvelopePtr&& env) {
+void LogManager::ProcessForwardBatchOrder(const SharedEnvelope& env) {
   auto forward_batch_order = env->mutable_request()->mutable_forward_batch_order();
   auto [from_region, from_replica, from_partition] = UnpackMachineId(env->from());
   auto local_region = config()->local_region();
@@ -321,13 +377,31 @@ void LogManager::AdvanceLog() {
 void LogManager::EmitBatch(BatchPtr&& batch) {
   VLOG(1) << "Processing batch " << TXN_ID_STR(batch->id()) << " from global log";
 
-  auto transactions = Unbatch(batch.get());
-  for (auto txn : transactions) {
-    RECORD(txn->mutable_internal(), TransactionEvent::EXIT_LOG_MANAGER);
-    auto env = NewEnvelope();
-    auto forward_txn = env->mutable_request()->mutable_forward_txn();
-    forward_txn->set_allocated_txn(txn);
-    Send(move(env), kSchedulerChannel);
+  if (backlog_ != nullptr) {
+    backlog_->fetch_sub(batch->transactions_size(), std::memory_order_relaxed);
+  }
+
+  for (auto& txn : *batch->mutable_transactions()) {
+    auto txn_internal = txn.mutable_internal();
+
+    // Transfer recorded events from batch to each txn in the batch
+    txn_internal->mutable_events()->MergeFrom(batch->events());
+
+    RECORD(txn_internal, TransactionEvent::EXIT_LOG_MANAGER);
+
+    if (txn_queue_ != nullptr) {
+      // Each txn shares the ownership of the batch, which is freed once the scheduler
+      // and the workers release the last txn of the batch
+      txn_queue_->Push(TxnPtr(batch, &txn));
+    } else {
+      auto env = NewEnvelope();
+      env->mutable_request()->mutable_forward_txn()->mutable_txn()->CopyFrom(txn);
+      Send(move(env), kSchedulerChannel);
+    }
+  }
+
+  if (txn_queue_ != nullptr) {
+    txn_queue_->Flush();
   }
 }
 
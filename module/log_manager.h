@@ -1,6 +1,8 @@
 #pragma once
 
+#include <atomic>
 #include <queue>
+#include <string_view>
 #include <unordered_map>
 
 #include "common/batch_log.h"
@@ -12,6 +14,9 @@
 
 namespace slog {
 
+// Number of txns received by the log managers of a machine but not yet handed to the scheduler
+using LogManagerBacklog = std::atomic<int64_t>;
+
 /**
  * A LocalLog buffers batch data from local partitions and outputs
  * the next local batch in the order given by the local Paxos process
@@ -51,22 +56,47 @@ class LogManager : public NetworkedModule {
  public:
   static uint64_t MakeLogChannel(RegionId region) { return kMaxChannel + region; }
 
+  /**
+   * @param txn_queue Queue to hand the txns to the scheduler. If null, the txns are
+   *                  copied into envelopes and sent to the scheduler channel
+   * @param backlog   Counter of buffered txns shared by the log managers of this machine. Can be null
+   */
   LogManager(int id, const std::vector<RegionId>& regions, const std::shared_ptr<Broker>& broker,
              const MetricsRepositoryManagerPtr& metrics_manager,
-             std::chrono::milliseconds poll_timeout = kModuleTimeout);
+             std::chrono::milliseconds poll_timeout = kModuleTimeout,
+             const std::shared_ptr<TxnQueue>& txn_queue = nullptr,
+             const std::shared_ptr<LogManagerBacklog>& backlog = nullptr);
 
   std::string name() const override { return "LogManager"; }
 
  protected:
   void OnInternalRequestReceived(EnvelopePtr&& env) final;
 
+  /**
+   * Deserializes envelopes from other machines into an arena per envelope so that
+   * a batch and its txns are allocated and freed together
+   */
+  bool OnRawMessageReceived(const zmq::message_t& msg) final;
+
+  bool OnCustomSocket() final;
+
  private:
-  void ProcessBatchReplicationAck(EnvelopePtr&& env);
-  void ProcessForwardBatchData(EnvelopePtr&& env);
-  void ProcessForwardBatchOrder(EnvelopePtr&& env);
+  using SharedEnvelope = std::shared_ptr<internal::Envelope>;
+
+  /**
+   * @param serialized The buffer that the envelope was deserialized from, if any. Used to
+   *                   forward the envelope without serializing it again
+   */
+  void ProcessRequest(const SharedEnvelope& env, std::string_view serialized = {});
+  void ProcessBatchReplicationAck(const SharedEnvelope& env);
+  void ProcessForwardBatchData(const SharedEnvelope& env, std::string_view serialized);
+  void ProcessForwardBatchOrder(const SharedEnvelope& env);
   void AdvanceLog();
   void EmitBatch(BatchPtr&& batch);
 
+  std::shared_ptr<TxnQueue> txn_queue_;
+  std::shared_ptr<LogManagerBacklog> backlog_;
+
   std::unordered_map<RegionId, BatchLog> single_home_logs_;
   LocalLog local_log_;
   std::vector<MachineId> other_partitions_;
@@ -20,9 +20,26 @@ MultiHomeOrderer::MultiHomeOrderer(const shared_ptr<Broker>& broker, const Metri
     : NetworkedModule(broker, kMultiHomeOrdererChannel, metrics_manager, poll_timeout, true /* is_long_sender */),
       batch_id_counter_(0) {
   batch_per_reg_.resize(config()->num_regions());
+  if (config()->adaptive_mh_orderer_batching()) {
+    // The window follows the batches waiting for their global order, which the global paxos only sends
+    // to the orderers on the leader partition of replica 0. Every batch must be formed on one of them
+    CHECK(config()->shrink_mh_orderer()) << "Adaptive mh orderer batching requires shrink_mh_orderer";
+    adaptive_batch_window_.emplace(config()->mh_orderer_min_batch_duration(), config()->mh_orderer_max_batch_duration(),
+                                   config()->mh_orderer_target_backlog(), config()->mh_orderer_batch_size());
+  }
+  // The global order is only sent to the orderers that receive the batch data
+  receives_own_order_ = config()->local_replica() == 0 &&
+                        config()->local_partition() == config()->leader_partition_for_multi_home_ordering();
   NewBatch();
 }
 
+std::chrono::microseconds MultiHomeOrderer::batch_window() const {
+  if (adaptive_batch_window_.has_value()) {
+    return adaptive_batch_window_->window();
+  }
+  return config()->mh_orderer_batch_duration();
+}
+
 void MultiHomeOrderer::NewBatch() {
   ++batch_id_counter_;
   batch_size_ = 0;
@@ -80,6 +97,17 @@ void MultiHomeOrderer::ProcessForwardBatchOrder(EnvelopePtr&& env) {
   VLOG(1) << "Received order for batch " << TXN_ID_STR(batch_order.batch_id()) << " from "
           << MACHINE_ID_STR(env->from()) << ". Slot: " << batch_order.slot();
 
+  if (auto it = batches_waiting_for_order_.find(batch_order.batch_id()); it != batches_waiting_for_order_.end()) {
+    if (per_thread_metrics_repo != nullptr) {
+      const auto& sent_batch = it->second;
+      auto order_duration = std::chrono::steady_clock::now() - sent_batch.sent_time;
+      per_thread_metrics_repo->RecordMHOrdererBatch(batch_order.batch_id(), sent_batch.batch_size,
+                                                    sent_batch.batch_duration.count(),
+                                                    sent_batch.batch_window.count() * 1000, order_duration.count());
+    }
+    batches_waiting_for_order_.erase(it);
+  }
+
   multi_home_batch_log_.AddSlot(batch_order.slot(), batch_order.batch_id());
 
   AdvanceLog();
@@ -119,23 +147,55 @@ void MultiHomeOrderer::AddToBatch(Transaction* txn) {
 
   // If this is the first txn in the batch, schedule to send the batch at a later time
   if (batch_size_ == 1) {
-    NewTimedCallback(config()->mh_orderer_batch_duration(), [this]() {
+    send_batch_callback_handle_ = NewTimedCallback(batch_window(), [this]() {
+      send_batch_callback_handle_.reset();
       SendBatch();
       NewBatch();
     });
 
     batch_starting_time_ = std::chrono::steady_clock::now();
   }
+
+  // Send a full batch right away instead of waiting for the window to close
+  auto max_batch_size = config()->mh_orderer_batch_size();
+  if (max_batch_size > 0 && batch_size_ >= max_batch_size) {
+    if (send_batch_callback_handle_.has_value()) {
+      RemoveTimedCallback(send_batch_callback_handle_.value());
+      send_batch_callback_handle_.reset();
+    }
+    SendBatch();
+    NewBatch();
+  }
 }
 
 void MultiHomeOrderer::SendBatch() {
   VLOG(1) << "Finished multi-home batch " << TXN_ID_STR(batch_id()) << " of size " << batch_size_;
 
-  if (per_thread_metrics_repo != nullptr) {
-    per_thread_metrics_repo->RecordMHOrdererBatch(batch_id(), batch_size_,
-                                                  (std::chrono::steady_clock::now() - batch_starting_time_).count());
+  auto now = std::chrono::steady_clock::now();
+  auto elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(now - batch_starting_time_);
+  auto window = batch_window();
+  if (receives_own_order_) {
+    // The batch is recorded once its global order comes back
+    batches_waiting_for_order_.emplace(
+        batch_id(),
+        SentBatch{.batch_size = static_cast<size_t>(batch_size_), .batch_duration = elapsed, .batch_window = window,
+                  .sent_time = now});
+  } else if (per_thread_metrics_repo != nullptr) {
+    per_thread_metrics_repo->RecordMHOrdererBatch(batch_id(), batch_size_, elapsed.count(),
+                                                  std::chrono::nanoseconds(window).count(), -1);
+  }
+
+  if (adaptive_batch_window_.has_value()) {
+    // The batches waiting for their global order play the role of the log manager backlog of the sequencer
+    int64_t backlog = batches_waiting_for_order_.size();
+    adaptive_batch_window_->Update(batch_size_, elapsed, backlog);
+
+    VLOG(1) << "MH batch window: " << adaptive_batch_window_->window().count()
+            << " us. Arrival rate: " << adaptive_batch_window_->arrival_rate() << " txn/s. Backlog: " << backlog;
   }
 
+  // The order proposal and the batch data are sent out together, so the data reaches the regions while
+  // the batch is being ordered
   auto paxos_env = NewEnvelope();
   auto paxos_propose = paxos_env->mutable_request()->mutable_paxos_propose();
   paxos_propose->set_value(batch_id());
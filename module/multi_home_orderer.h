@@ -1,10 +1,14 @@
 #pragma once
 
+#include <optional>
+#include <unordered_map>
+
 #include "common/batch_log.h"
 #include "common/configuration.h"
 #include "common/metrics.h"
 #include "connection/broker.h"
 #include "module/base/networked_module.h"
+#include "module/sequencer_components/adaptive_batch_window.h"
 
 namespace slog {
 
@@ -17,7 +21,12 @@ namespace slog {
  * OUTPUT: For ForwardTxn, it has to contains a MULTI_HOME txn, which is put
  *         into a batch. The ID of this batch is sent to the global paxos
  *         process for ordering, and simultaneously, this batch is sent to
- *         the MultiHomeOrderer of all regions.
+ *         the MultiHomeOrderer of all regions. A batch is sent when its window
+ *         closes or when it reaches mh_orderer_batch_size. With adaptive batching,
+ *         the window shrinks while few batches wait for their global order and
+ *         grows when the global Paxos falls behind. Adaptive batching requires
+ *         shrink_mh_orderer so that every batch is formed by an orderer that
+ *         receives its global order.
  *
  *         ForwardBatch'es are serialized into a log according to
  *         their globally orderred IDs and then forwarded to the Sequencer.
@@ -40,12 +49,26 @@ class MultiHomeOrderer : public NetworkedModule {
 
   void NewBatch();
   BatchId batch_id() const { return (batch_id_counter_ << kMachineIdBits) | config()->local_machine_id(); }
+  std::chrono::microseconds batch_window() const;
   void AddToBatch(Transaction* txn);
   void SendBatch();
 
   std::vector<std::unique_ptr<internal::Batch>> batch_per_reg_;
   BatchId batch_id_counter_;
   int batch_size_;
+  std::optional<Poller::Handle> send_batch_callback_handle_;
+  std::optional<AdaptiveBatchWindow> adaptive_batch_window_;
+
+  struct SentBatch {
+    size_t batch_size;
+    std::chrono::nanoseconds batch_duration;
+    std::chrono::microseconds batch_window;
+    std::chrono::steady_clock::time_point sent_time;
+  };
+  // Whether the global order of the batches sent by this orderer comes back to it
+  bool receives_own_order_;
+  // Batches sent by this orderer that are waiting for their global order
+  std::unordered_map<BatchId, SentBatch> batches_waiting_for_order_;
 
   BatchLog multi_home_batch_log_;
 
@@ -29,6 +29,9 @@
 #include "common/json_utils.h"
 #include "common/proto_utils.h"
 #include "common/types.h"
+#include "module/scheduler_components/ddr_lock_manager.h"
+#include "module/scheduler_components/old_lock_manager.h"
+#include "module/scheduler_components/rma_lock_manager.h"
 #include "proto/internal.pb.h"
 
 using std::make_shared;
@@ -42,29 +45,59 @@ using internal::Request;
 using internal::Response;
 
 Scheduler::Scheduler(const shared_ptr<Broker>& broker, const shared_ptr<Storage>& storage,
-                     const MetricsRepositoryManagerPtr& metrics_manager, std::chrono::milliseconds poll_timeout)
+                     const MetricsRepositoryManagerPtr& metrics_manager, std::chrono::milliseconds poll_timeout,
+                     const std::vector<shared_ptr<TxnQueue>>& txn_queues)
     : NetworkedModule(broker, {kSchedulerChannel, false /* is_raw */}, metrics_manager, poll_timeout),
+      ddr_lock_manager_(nullptr),
+      txn_queues_(txn_queues),
+      ready_txn_seq_(0),
       current_worker_(0),
+      num_affinity_dispatches_(0),
+      num_affinity_fallbacks_(0),
+      num_speculations_(0),
+      num_committed_speculations_(0),
       global_log_counter_(0) {
+  if (config()->remote_read_batch_duration().count() > 0) {
+    remote_read_coalescer_ = std::make_shared<RemoteReadCoalescer>();
+  }
   for (int i = 0; i < config()->num_workers(); i++) {
-    workers_.push_back(MakeRunnerFor<Worker>(i, broker, storage, metrics_manager, poll_timeout));
+    auto& queues = worker_queues_.emplace_back(std::make_shared<SchedulerWorkerQueues>());
+    workers_.push_back(
+        MakeRunnerFor<Worker>(i, queues, broker, storage, metrics_manager, remote_read_coalescer_, poll_timeout));
   }
+  worker_loads_.resize(workers_.size(), 0);
 
 #if defined(REMASTER_PROTOCOL_SIMPLE) || defined(REMASTER_PROTOCOL_PER_KEY)
   remaster_manager_.SetStorage(storage);
 #endif
 
-#ifdef LOCK_MANAGER_DDR
-  if (config()->ddr_interval() > milliseconds(0)) {
-    lock_manager_.InitializeDeadlockResolver(broker, metrics_manager, kSchedulerChannel, poll_timeout);
+  switch (config()->lock_manager()) {
+    case internal::LockManagerType::OLD:
+      lock_manager_ = std::make_unique<OldLockManager>();
+      break;
+    case internal::LockManagerType::RMA:
+      lock_manager_ = std::make_unique<RMALockManager>();
+      break;
+    default: {
+      auto ddr_lock_manager = std::make_unique<DDRLockManager>();
+      if (config()->ddr_interval() > milliseconds(0)) {
+        ddr_lock_manager->InitializeDeadlockResolver(broker, metrics_manager, kSchedulerChannel, poll_timeout);
+      }
+      ddr_lock_manager_ = ddr_lock_manager.get();
+      lock_manager_ = move(ddr_lock_manager);
+      break;
+    }
   }
-#endif
 }
 
 void Scheduler::Initialize() {
-#ifdef LOCK_MANAGER_DDR
-  lock_manager_.StartDeadlockResolver();
-#endif
+  if (ddr_lock_manager_ != nullptr) {
+    ddr_lock_manager_->StartDeadlockResolver();
+  }
+
+  for (auto& txn_queue : txn_queues_) {
+    AddCustomEventFd(txn_queue->notify_fd());
+  }
 
   auto cpus = config()->cpu_pinnings(ModuleId::WORKER);
   size_t i = 0;
@@ -75,12 +108,7 @@ void Scheduler::Initialize() {
     }
     worker->StartInNewThread(cpu);
 
-    zmq::socket_t worker_socket(*context(), ZMQ_PAIR);
-    worker_socket.set(zmq::sockopt::rcvhwm, 0);
-    worker_socket.set(zmq::sockopt::sndhwm, 0);
-    worker_socket.bind(kSchedWorkerAddress + std::to_string(i));
-
-    AddCustomSocket(move(worker_socket));
+    AddCustomEventFd(worker_queues_[i]->to_scheduler.notify_fd());
 
     i++;
   }
@@ -89,11 +117,11 @@ void Scheduler::Initialize() {
 void Scheduler::OnInternalRequestReceived(EnvelopePtr&& env) {
   switch (env->request().type_case()) {
     case Request::kForwardTxn:
-      ProcessTransaction(move(env));
+      ProcessTransaction(TxnPtr(env->mutable_request()->mutable_forward_txn()->release_txn()));
       break;
-#ifdef LOCK_MANAGER_DDR
     case Request::kSignal: {
-      auto ready_txns = lock_manager_.GetReadyTxns();
+      CHECK(ddr_lock_manager_ != nullptr) << "Only the deadlock resolver sends signals";
+      auto ready_txns = ddr_lock_manager_->GetReadyTxns();
       for (auto ready_txn : ready_txns) {
         auto it = active_txns_.find(ready_txn);
         DCHECK(it != active_txns_.end());
@@ -105,7 +133,6 @@ void Scheduler::OnInternalRequestReceived(EnvelopePtr&& env) {
       }
       break;
     }
-#endif
     case Request::kStats:
       ProcessStatsRequest(env->request().stats());
       break;
@@ -115,44 +142,58 @@ void Scheduler::OnInternalRequestReceived(EnvelopePtr&& env) {
   }
 }
 
-// Handle responses from the workers
+// Handle txns from the log managers and responses from the workers
 bool Scheduler::OnCustomSocket() {
   bool has_msg = false;
   bool stop = false;
+  for (auto& txn_queue : txn_queues_) {
+    for (TxnPtr txn; txn_queue->Pop(txn);) {
+      has_msg = true;
+      ProcessTransaction(move(txn));
+    }
+  }
+  // Keep polling while there are txns not yet handed to the workers
+  for (auto& queues : worker_queues_) {
+    has_msg |= queues->to_worker.Flush();
+  }
   while (!stop) {
     stop = true;
     for (size_t i = 0; i < workers_.size(); i++) {
-      if (zmq::message_t msg; GetCustomSocket(i).recv(msg, zmq::recv_flags::dontwait)) {
+      if (TxnId txn_id; worker_queues_[i]->to_scheduler.Pop(txn_id)) {
         stop = false;
         has_msg = true;
-        auto txn_id = *msg.data<TxnId>();
+        worker_loads_[i]--;
         // Release locks held by this txn then dispatch the txns that become ready thanks to this release.
-        auto unblocked_txns = lock_manager_.ReleaseLocks(txn_id);
+        auto unblocked_txns = lock_manager_->ReleaseLocks(txn_id);
         VLOG(3) << "Released locks of txn " << TXN_ID_STR(txn_id);
 
         for (auto unblocked_txn : unblocked_txns) {
-#ifdef LOCK_MANAGER_DDR
-          auto it = active_txns_.find(unblocked_txn.first);
-          DCHECK(it != active_txns_.end());
-          Dispatch(unblocked_txn.first, unblocked_txn.second /* deadlocked */, false /* is_fast */);
-#else
-          Dispatch(unblocked_txn, false /* deadlocked */, false /* is_fast */);
-#endif
+          DCHECK(active_txns_.find(unblocked_txn.first) != active_txns_.end());
+          DispatchUnblocked(unblocked_txn.first, unblocked_txn.second /* deadlocked */);
         }
 
         auto it = active_txns_.find(txn_id);
         CHECK(it != active_txns_.end());
-        auto& txn_holder = it->second;
+        auto& txn_holder = *it->second;
 
 #if defined(REMASTER_PROTOCOL_SIMPLE) || defined(REMASTER_PROTOCOL_PER_KEY)
-        auto remaster_result = txn_holder.remaster_result();
+        const auto& remaster_result = txn_holder.remaster_result();
         // If a remaster transaction, trigger any unblocked txns
         if (remaster_result.has_value()) {
-          ProcessRemasterResult(remaster_manager_.RemasterOccured(remaster_result->first, remaster_result->second));
+          ProcessRemasterResult(remaster_manager_.RemasterOccured(remaster_result->key, remaster_result->counter));
         }
 #endif /* defined(REMASTER_PROTOCOL_SIMPLE) || \
           defined(REMASTER_PROTOCOL_PER_KEY) */
 
+        // The txn was already released by the worker so only the result kept in the holder can be used here
+        if (txn_holder.remaster_result().has_value() && config()->forwarder_metadata_cache_size() > 0) {
+          SendMasterUpdate(txn_holder.remaster_result().value());
+        }
+
+        if (auto speculation = txn_holder.speculation(); speculation != nullptr && speculation->committed) {
+          num_committed_speculations_++;
+        }
+
         txn_holder.SetDone();
 
         if (txn_holder.is_ready_for_gc()) {
@@ -162,26 +203,33 @@ bool Scheduler::OnCustomSocket() {
     }
   };
 
+  DispatchReadyTxns();
+
   return has_msg;
 }
 
-void Scheduler::ProcessTransaction(EnvelopePtr&& env) {
-  auto txn = env->mutable_request()->mutable_forward_txn()->release_txn();
+void Scheduler::ProcessTransaction(TxnPtr&& txn_ptr) {
+  // The holder takes over the ownership of the txn
+  auto txn = txn_ptr.get();
   auto txn_id = txn->internal().id();
-  auto ins = active_txns_.try_emplace(txn_id, config(), txn);
-  auto holder_it = ins.first;
-  auto& holder = holder_it->second;
+  auto holder_it = active_txns_.find(txn_id);
+  bool is_new = holder_it == active_txns_.end();
+  if (is_new) {
+    holder_it = active_txns_.try_emplace(txn_id, txn_holder_pool_.Acquire(config(), move(txn_ptr))).first;
+  }
+  auto& holder = *holder_it->second;
 
   global_log_counter_++;
 
-  if (ins.second) {
+  if (is_new) {
     RECORD(holder.txn().mutable_internal(), TransactionEvent::ENTER_SCHEDULER);
 
     VLOG(3) << "Accepted " << ENUM_NAME(txn->internal().type(), TransactionType) << " transaction ("
             << TXN_ID_STR(txn_id) << ", " << txn->internal().home() << ")";
   } else {
-    if (!holder.AddLockOnlyTxn(txn)) {
-      LOG(ERROR) << "Already received txn: (" << TXN_ID_STR(txn_id) << ", " << txn->internal().home() << ")";
+    auto home = txn->internal().home();
+    if (!holder.AddLockOnlyTxn(move(txn_ptr))) {
+      LOG(ERROR) << "Already received txn: (" << TXN_ID_STR(txn_id) << ", " << home << ")";
       return;
     }
 
@@ -253,6 +301,25 @@ void Scheduler::ProcessRemasterResult(RemasterOccurredResult result) {
 #endif /* defined(REMASTER_PROTOCOL_SIMPLE) || \
           defined(REMASTER_PROTOCOL_PER_KEY) */
 
+void Scheduler::SendMasterUpdate(const RemasterResult& remaster_result) {
+  auto env = NewEnvelope();
+  auto update = env->mutable_request()->mutable_master_update()->add_updates();
+  update->set_key(remaster_result.key);
+  update->mutable_metadata()->set_master(remaster_result.new_master);
+  update->mutable_metadata()->set_counter(remaster_result.counter);
+
+  // The forwarders of the other partitions in this replica look up this key from this partition
+  std::vector<MachineId> forwarders;
+  for (int p = 0; p < config()->num_partitions(); p++) {
+    if (p != config()->local_partition()) {
+      forwarders.push_back(MakeMachineId(config()->local_region(), config()->local_replica(), p));
+    }
+  }
+  if (!forwarders.empty()) {
+    Send(move(env), forwarders, kForwarderChannel);
+  }
+}
+
 void Scheduler::SendToLockManager(Transaction& txn) {
   auto txn_id = txn.internal().id();
 
@@ -260,7 +327,7 @@ void Scheduler::SendToLockManager(Transaction& txn) {
 
   RECORD(txn.mutable_internal(), TransactionEvent::ENTER_LOCK_MANAGER);
 
-  switch (lock_manager_.AcquireLocks(txn)) {
+  switch (lock_manager_->AcquireLocks(txn)) {
     case AcquireLocksResult::ACQUIRED:
       Dispatch(txn_id, false /* deadlocked */, true /* is_fast */);
       break;
@@ -269,6 +336,9 @@ void Scheduler::SendToLockManager(Transaction& txn) {
       break;
     case AcquireLocksResult::WAITING:
       VLOG(3) << "Txn " << TXN_ID_STR(txn_id) << " cannot be dispatched yet";
+      if (config()->speculative_multi_home()) {
+        MaybeSpeculate(txn_id);
+      }
       break;
     default:
       LOG(ERROR) << "Unknown lock result type";
@@ -279,7 +349,7 @@ void Scheduler::SendToLockManager(Transaction& txn) {
 void Scheduler::Dispatch(TxnId txn_id, bool deadlocked, bool is_fast) {
   auto it = active_txns_.find(txn_id);
   CHECK(it != active_txns_.end()) << "Txn " << txn_id << " does not exist for dispatching";
-  auto& txn_holder = it->second;
+  auto& txn_holder = *it->second;
 
   CHECK(txn_holder.dispatchable()) << "Can no longer dispatch txn " << txn_holder.txn_id()
                                    << " (deadlocked = " << deadlocked << ")";
@@ -300,31 +370,114 @@ void Scheduler::Dispatch(TxnId txn_id, bool deadlocked, bool is_fast) {
       RECORD(txn_holder.txn().mutable_internal(), TransactionEvent::DISPATCHED_SLOW);
     }
   }
-  auto data = std::make_pair(&txn_holder, deadlocked);
-  zmq::message_t msg(sizeof(data));
-  *msg.data<decltype(data)>() = data;
+  auto worker = AssignWorker(txn_holder);
+  worker_queues_[worker]->to_worker.Push({&txn_holder, deadlocked, false /* speculative */});
+
+  VLOG(3) << "Dispatched txn " << TXN_ID_STR(txn_id) << " (deadlocked = " << deadlocked << ")";
+}
+
+void Scheduler::DispatchUnblocked(TxnId txn_id, bool deadlocked) {
+  if (!config()->priority_dispatch()) {
+    Dispatch(txn_id, deadlocked, false /* is_fast */);
+    return;
+  }
+  ready_txns_.push({lock_manager_->NumWaiters(txn_id), ready_txn_seq_++, txn_id, deadlocked});
+}
 
-  int worker = current_worker_;
-  current_worker_ = (current_worker_ + 1) % workers_.size();
-  // If this txn was dispatched to a worker before, dispatch to the same worker again
+void Scheduler::DispatchReadyTxns() {
+  while (!ready_txns_.empty()) {
+    const auto& ready_txn = ready_txns_.top();
+    VLOG(3) << "Txn " << TXN_ID_STR(ready_txn.txn_id) << " has " << ready_txn.num_waiters << " waiters";
+    Dispatch(ready_txn.txn_id, ready_txn.deadlocked, false /* is_fast */);
+    ready_txns_.pop();
+  }
+}
+
+void Scheduler::MaybeSpeculate(TxnId txn_id) {
+  auto it = active_txns_.find(txn_id);
+  CHECK(it != active_txns_.end()) << "Txn " << txn_id << " does not exist for speculating";
+  auto& txn_holder = *it->second;
+  const auto& txn = txn_holder.txn();
+
+  // Txns with remote reads or remaster txns are never speculated
+  if (txn_holder.speculation() != nullptr || txn_holder.is_aborting() ||
+      txn.status() == TransactionStatus::ABORTED || txn.program_case() != Transaction::kCode ||
+      txn.internal().involved_partitions_size() > 1 ||
+      txn_holder.num_lock_only_txns() == txn_holder.expected_num_lock_only_txns() ||
+      !lock_manager_->HoldsArrivedLocks(txn_id)) {
+    return;
+  }
+
+  // The worker runs on a copy of the txn so the scheduler can keep adding the lock-only txns
+  // to the holder. The regular dispatch later goes to the same worker, after the speculative run
+  txn_holder.StartSpeculation();
+  auto worker = AssignWorker(txn_holder);
+  worker_queues_[worker]->to_worker.Push({&txn_holder, false /* deadlocked */, true /* speculative */});
+  num_speculations_++;
+
+  VLOG(3) << "Speculating txn " << TXN_ID_STR(txn_id) << " while waiting for "
+          << txn_holder.expected_num_lock_only_txns() - txn_holder.num_lock_only_txns() << " lock-only txns";
+}
+
+int Scheduler::AssignWorker(TxnHolder& txn_holder) {
+  // If this txn was sent to a worker before, send it to the same worker again since that worker
+  // holds the state and the remote read redirection of the previous run. A worker reports back only once
+  // per txn so the txn is only counted towards the load of its worker the first time
   if (txn_holder.worker().has_value()) {
-    worker = txn_holder.worker().value();
+    return txn_holder.worker().value();
+  }
+  int worker;
+  if (config()->worker_key_affinity()) {
+    worker = SelectWorkerByKeyAffinity(txn_holder.txn());
+  } else {
+    worker = SelectLeastLoadedWorker();
   }
+  worker_loads_[worker]++;
   txn_holder.SetWorker(worker);
-  GetCustomSocket(worker).send(msg, zmq::send_flags::none);
+  return worker;
+}
 
-  VLOG(3) << "Dispatched txn " << TXN_ID_STR(txn_id) << " (deadlocked = " << deadlocked << ")";
+int Scheduler::SelectLeastLoadedWorker() {
+  int selected = current_worker_;
+  for (size_t i = 1; i < workers_.size(); i++) {
+    int w = (current_worker_ + i) % workers_.size();
+    if (worker_loads_[w] < worker_loads_[selected]) {
+      selected = w;
+    }
+  }
+  current_worker_ = (selected + 1) % workers_.size();
+  return selected;
+}
+
+int Scheduler::SelectWorkerByKeyAffinity(const Transaction& txn) {
+  if (txn.keys().empty()) {
+    return SelectLeastLoadedWorker();
+  }
+  const Key* dominant_key = &txn.keys(0).key();
+  for (const auto& kv : txn.keys()) {
+    if (kv.value_entry().type() == KeyType::WRITE) {
+      dominant_key = &kv.key();
+      break;
+    }
+  }
+  int preferred = std::hash<Key>{}(*dominant_key) % workers_.size();
+  if (worker_loads_[preferred] < config()->worker_affinity_max_load()) {
+    num_affinity_dispatches_++;
+    return preferred;
+  }
+  num_affinity_fallbacks_++;
+  return SelectLeastLoadedWorker();
 }
 
-// Disable pre-dispatch abort when DDR is used. Removing this method is sufficient to disable the
-// whole mechanism
-#ifdef LOCK_MANAGER_DDR
-void Scheduler::TriggerPreDispatchAbort(TxnId, const std::string&) {}
-#else
 void Scheduler::TriggerPreDispatchAbort(TxnId txn_id, const std::string& abort_reason) {
+  // Disable pre-dispatch abort when DDR is used
+  if (ddr_lock_manager_ != nullptr) {
+    return;
+  }
+
   auto active_txn_it = active_txns_.find(txn_id);
   CHECK(active_txn_it != active_txns_.end());
-  auto& txn_holder = active_txn_it->second;
+  auto& txn_holder = *active_txn_it->second;
 
   if (txn_holder.is_aborting()) {
     return;
@@ -349,9 +502,9 @@ void Scheduler::TriggerPreDispatchAbort(TxnId txn_id, const std::string& abort_r
 
   // Release locks held by this txn. Enqueue the txns that
   // become ready thanks to this release.
-  auto unblocked_txns = lock_manager_.ReleaseLocks(txn_id);
+  auto unblocked_txns = lock_manager_->ReleaseLocks(txn_id);
   for (auto unblocked_txn : unblocked_txns) {
-    Dispatch(unblocked_txn, false, false);
+    Dispatch(unblocked_txn.first, false, false);
   }
 
   // Let a worker handle notifying other partitions and send back to the server.
@@ -359,7 +512,6 @@ void Scheduler::TriggerPreDispatchAbort(TxnId txn_id, const std::string& abort_r
   txn.set_abort_reason(abort_reason);
   Dispatch(txn_id, false, false);
 }
-#endif /* LOCK_MANAGER_DDR */
 
 /**
  * {
@@ -375,6 +527,12 @@ void Scheduler::TriggerPreDispatchAbort(TxnId txn_id, const std::string& abort_r
  *      },
  *      ...
  *    ],
+ *    worker_loads: [<number of outstanding txns of each worker>, ...],
+ *    worker_cache_misses: [<cache misses of each worker thread, -1 if unavailable>, ...],
+ *    num_affinity_dispatches: <number of txns dispatched to their preferred worker>,
+ *    num_affinity_fallbacks: <number of txns whose preferred worker was too loaded>,
+ *    num_speculations: <number of multi-home txns run speculatively>,
+ *    num_committed_speculations: <number of speculative runs that passed validation>,
  *    ...<stats from lock manager>...
  * }
  */
@@ -401,21 +559,37 @@ void Scheduler::ProcessStatsRequest(const internal::StatsRequest& stats_request)
     for (const auto& [txn_id, txn_holder] : active_txns_) {
       rapidjson::Value txn_obj(rapidjson::kObjectType);
       txn_obj.AddMember(StringRef(TXN_ID), txn_id, alloc)
-          .AddMember(StringRef(TXN_DONE), txn_holder.is_done(), alloc)
-          .AddMember(StringRef(TXN_ABORTING), txn_holder.is_aborting(), alloc)
-          .AddMember(StringRef(TXN_NUM_LO), txn_holder.num_lock_only_txns(), alloc)
-          .AddMember(StringRef(TXN_EXPECTED_NUM_LO), txn_holder.expected_num_lock_only_txns(), alloc)
-          .AddMember(StringRef(TXN_NUM_DISPATCHES), txn_holder.num_dispatches(), alloc)
+          .AddMember(StringRef(TXN_DONE), txn_holder->is_done(), alloc)
+          .AddMember(StringRef(TXN_ABORTING), txn_holder->is_aborting(), alloc)
+          .AddMember(StringRef(TXN_NUM_LO), txn_holder->num_lock_only_txns(), alloc)
+          .AddMember(StringRef(TXN_EXPECTED_NUM_LO), txn_holder->expected_num_lock_only_txns(), alloc)
+          .AddMember(StringRef(TXN_NUM_DISPATCHES), txn_holder->num_dispatches(), alloc)
           .AddMember(StringRef(TXN_MULTI_HOME),
-                     txn_holder.txn().internal().type() == TransactionType::MULTI_HOME_OR_LOCK_ONLY, alloc)
-          .AddMember(StringRef(TXN_MULTI_PARTITION), txn_holder.txn().internal().involved_partitions_size() > 1, alloc);
+                     txn_holder->txn().internal().type() == TransactionType::MULTI_HOME_OR_LOCK_ONLY, alloc)
+          .AddMember(StringRef(TXN_MULTI_PARTITION), txn_holder->txn().internal().involved_partitions_size() > 1, alloc);
       txns.PushBack(txn_obj, alloc);
     }
     stats.AddMember(StringRef(ALL_TXNS), txns, alloc);
   }
 
+  stats.AddMember(StringRef(WORKER_LOADS), ToJsonArray(worker_loads_, alloc), alloc);
+  stats.AddMember(StringRef(WORKER_CACHE_MISSES),
+                  ToJsonArray(
+                      worker_queues_, [](const auto& q) { return PerfCounter::Read(q->cache_misses_fd); }, alloc),
+                  alloc);
+  stats.AddMember(StringRef(NUM_AFFINITY_DISPATCHES), num_affinity_dispatches_, alloc);
+  stats.AddMember(StringRef(NUM_AFFINITY_FALLBACKS), num_affinity_fallbacks_, alloc);
+  if (config()->speculative_multi_home()) {
+    stats.AddMember(StringRef(NUM_SPECULATIONS), num_speculations_, alloc);
+    stats.AddMember(StringRef(NUM_COMMITTED_SPECULATIONS), num_committed_speculations_, alloc);
+  }
+  if (remote_read_coalescer_ != nullptr) {
+    stats.AddMember(StringRef(NUM_REMOTE_READ_BATCHES), remote_read_coalescer_->num_batches(), alloc);
+    stats.AddMember(StringRef(NUM_COALESCED_REMOTE_READS), remote_read_coalescer_->num_results(), alloc);
+  }
+
   // Add stats from the lock manager
-  lock_manager_.GetStats(stats, level);
+  lock_manager_->GetStats(stats, level);
 
   // Write JSON object to a buffer and send back to the server
   rapidjson::StringBuffer buf;
@@ -2,13 +2,16 @@
 
 #include <glog/logging.h>
 
+#include <queue>
 #include <unordered_map>
 #include <unordered_set>
 #include <vector>
 
 #include "common/batch_log.h"
 #include "common/configuration.h"
+#include "common/flat_hash_map.h"
 #include "common/metrics.h"
+#include "common/object_pool.h"
 #include "common/types.h"
 #include "connection/broker.h"
 #include "connection/sender.h"
@@ -16,35 +19,27 @@
 #include "module/scheduler_components/worker.h"
 #include "storage/storage.h"
 
+#include "module/scheduler_components/lock_manager.h"
+
 #if defined(REMASTER_PROTOCOL_SIMPLE)
 #include "module/scheduler_components/simple_remaster_manager.h"
-#if !defined(LOCK_MANAGER_OLD)
-#error "SIMPLE remaster protocol is only compatible with OLD lock manager"
-#endif
 #elif defined(REMASTER_PROTOCOL_PER_KEY)
 #include "module/scheduler_components/per_key_remaster_manager.h"
-#if !defined(LOCK_MANAGER_OLD)
-#error "PER_KEY remaster protocol is only compatible with OLD lock manager"
-#endif
-#elif defined(REMASTER_PROTOCOL_COUNTERLESS) && defined(LOCK_MANAGER_OLD)
-#error "COUNTERLESS remaster protocol is not compatible with OLD lock manager"
-#endif
-
-#if defined(LOCK_MANAGER_OLD)
-#include "module/scheduler_components/old_lock_manager.h"
-#elif defined(LOCK_MANAGER_DDR)
-#include "module/scheduler_components/ddr_lock_manager.h"
-#else
-#include "module/scheduler_components/rma_lock_manager.h"
 #endif
 
 namespace slog {
 
+class DDRLockManager;
+
 class Scheduler : public NetworkedModule {
  public:
+  /**
+   * @param txn_queues Queues through which the log managers hand over the txns
+   */
   Scheduler(const std::shared_ptr<Broker>& broker, const std::shared_ptr<Storage>& storage,
             const MetricsRepositoryManagerPtr& metrics_manager,
-            std::chrono::milliseconds poll_timeout = kModuleTimeout);
+            std::chrono::milliseconds poll_timeout = kModuleTimeout,
+            const std::vector<std::shared_ptr<TxnQueue>>& txn_queues = {});
 
   std::string name() const override { return "Scheduler"; }
 
@@ -53,11 +48,11 @@ class Scheduler : public NetworkedModule {
 
   void OnInternalRequestReceived(EnvelopePtr&& env) final;
 
-  // Handle responses from the workers
+  // Handle txns from the log managers and responses from the workers
   bool OnCustomSocket() final;
 
  private:
-  void ProcessTransaction(EnvelopePtr&& env);
+  void ProcessTransaction(TxnPtr&& txn);
   void ProcessStatsRequest(const internal::StatsRequest& stats_request);
 
 #if defined(REMASTER_PROTOCOL_SIMPLE) || defined(REMASTER_PROTOCOL_PER_KEY)
@@ -67,6 +62,9 @@ class Scheduler : public NetworkedModule {
   void ProcessRemasterResult(RemasterOccurredResult result);
 #endif
 
+  // Sends the new master of a remastered key to the forwarders that may have cached the old one
+  void SendMasterUpdate(const RemasterResult& remaster_result);
+
   // Send all transactions for locks
   void SendToLockManager(Transaction& txn);
 
@@ -78,6 +76,39 @@ class Scheduler : public NetworkedModule {
    */
   void Dispatch(TxnId txn_id, bool deadlocked, bool is_fast);
 
+  /**
+   * Dispatches a txn unblocked by a lock release. With priority dispatch, the txn is queued up
+   * and dispatched by DispatchReadyTxns together with the other txns unblocked in the same round
+   */
+  void DispatchUnblocked(TxnId txn_id, bool deadlocked);
+
+  /**
+   * Dispatches the queued up unblocked txns, starting from the txns with the most waiters
+   */
+  void DispatchReadyTxns();
+
+  /**
+   * Sends a multi-home txn to a worker for a speculative run if it is eligible, i.e. it only
+   * involves this partition and holds the locks requested by its arrived lock-only txns
+   */
+  void MaybeSpeculate(TxnId txn_id);
+
+  /**
+   * Returns the worker of a txn, assigning one if the txn has not been sent to any worker yet
+   */
+  int AssignWorker(TxnHolder& txn_holder);
+
+  /**
+   * Returns the worker with the fewest outstanding txns. Ties are broken in a round-robin manner
+   */
+  int SelectLeastLoadedWorker();
+
+  /**
+   * Returns the worker assigned to the first write key (or first key if read-only) of a txn.
+   * Falls back to the least-loaded worker if that worker has too many outstanding txns
+   */
+  int SelectWorkerByKeyAffinity(const Transaction& txn);
+
   /**
    * Aborts
    *
@@ -98,21 +129,42 @@ class Scheduler : public NetworkedModule {
   PerKeyRemasterManager remaster_manager_;
 #endif
 
-#if defined(REMASTER_PROTOCOL_SIMPLE) || defined(REMASTER_PROTOCOL_PER_KEY) || \
-    (defined(LOCK_MANAGER_OLD) && !defined(REMASTER_PROTOCOL_COUNTERLESS))
-  OldLockManager lock_manager_;
-#elif defined(LOCK_MANAGER_DDR)
-  DDRLockManager lock_manager_;
-#else
-  RMALockManager lock_manager_;
-#endif
+  std::unique_ptr<LockManager> lock_manager_;
+  // Points to lock_manager_ if the DDR lock manager is used, otherwise is null
+  DDRLockManager* ddr_lock_manager_;
+
+  // The holders are pooled since the workers keep pointers to them
+  ObjectPool<TxnHolder> txn_holder_pool_;
+  FlatHashMap<TxnId, ObjectPool<TxnHolder>::Ptr> active_txns_;
+  std::vector<std::shared_ptr<TxnQueue>> txn_queues_;
+
+  struct ReadyTxn {
+    int num_waiters;
+    uint64_t seq;
+    TxnId txn_id;
+    bool deadlocked;
+
+    // The top of the queue is the txn with the most waiters, then the earliest unblocked one
+    bool operator<(const ReadyTxn& other) const {
+      return num_waiters != other.num_waiters ? num_waiters < other.num_waiters : seq > other.seq;
+    }
+  };
+  std::priority_queue<ReadyTxn> ready_txns_;
+  uint64_t ready_txn_seq_;
 
-  std::unordered_map<TxnId, TxnHolder> active_txns_;
+  // Number of txns dispatched to each worker that have not finished yet
+  std::vector<int> worker_loads_;
 
   // This must be defined at the end so that the workers exit before any resources
   // in the scheduler is destroyed
+  std::vector<std::shared_ptr<SchedulerWorkerQueues>> worker_queues_;
+  std::shared_ptr<RemoteReadCoalescer> remote_read_coalescer_;
   std::vector<std::unique_ptr<ModuleRunner>> workers_;
   int current_worker_;
+  int num_affinity_dispatches_;
+  int num_affinity_fallbacks_;
+  int num_speculations_;
+  int num_committed_speculations_;
 
   int64_t global_log_counter_;
 };
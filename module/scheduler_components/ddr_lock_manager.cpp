@@ -46,6 +46,10 @@ class DeadlockResolver : public NetworkedModule {
         signal_chan_(signal_chan) {}
 
   void OnInternalRequestReceived(EnvelopePtr&& env) final {
+    if (env->request().type_case() == internal::Request::kCompactGraphLog) {
+      UpdateGraphFromCompactLog(env->request().compact_graph_log());
+      return;
+    }
     for (const auto& e : env->request().graph_log().entries()) {
       UpdateGraph(e);
     }
@@ -69,7 +73,8 @@ class DeadlockResolver : public NetworkedModule {
     if (per_thread_metrics_repo != nullptr) {
       auto runtime = (std::chrono::steady_clock::now() - start_time).count();
       per_thread_metrics_repo->RecordDeadlockResolverRun(runtime, unstable_graph_sz_, stable_graph_sz_,
-                                                         deadlocks_resolved_, graph_update_time_);
+                                                         deadlocks_resolved_, graph_update_time_, graph_log_bytes_,
+                                                         sent_graph_log_bytes_);
     }
   }
 
@@ -95,6 +100,18 @@ class DeadlockResolver : public NetworkedModule {
   size_t stable_graph_sz_;
   size_t deadlocks_resolved_;
   uint64_t graph_update_time_;
+  size_t graph_log_bytes_ = 0;
+  size_t sent_graph_log_bytes_ = 0;
+
+  // Log entries of the current run, coalesced by txn id, waiting to be encoded into a CompactGraphLog
+  struct CoalescedEntry {
+    TxnId txn_id;
+    int num_partitions;
+    bool is_complete;
+    vector<TxnId> incoming_edges;
+  };
+  vector<CoalescedEntry> coalesced_log_;
+  unordered_map<TxnId, size_t> coalesced_index_;
 
   struct Node {
     explicit Node(TxnId id, int num_partitions)
@@ -123,6 +140,10 @@ class DeadlockResolver : public NetworkedModule {
 
   void UpdateGraphAndBroadcastChanges() {
     internal::Envelope graph_log_env;
+    internal::GraphLog graph_log;
+    const bool compact = config_->ddr_compact_graph_log();
+    // The plain log is still built in compact mode when metrics are on to measure the bytes saved
+    const bool build_plain_log = !compact || per_thread_metrics_repo != nullptr;
     int log_index = 0;
     // Make the other log active so that we can read from current log without conflict
     {
@@ -137,14 +158,29 @@ class DeadlockResolver : public NetworkedModule {
 
       UpdateGraph(entry);
 
-      auto new_entry = graph_log_env.mutable_request()->mutable_graph_log()->add_entries();
-      new_entry->set_txn_id(entry.txn_id());
-      new_entry->set_num_partitions(entry.num_partitions());
-      new_entry->set_is_complete(entry.is_complete());
-      new_entry->mutable_incoming_edges()->Add(entry.incoming_edges().begin(), entry.incoming_edges().end());
+      if (compact) {
+        CoalesceEntry(entry);
+      }
+      if (build_plain_log) {
+        auto new_entry = graph_log.add_entries();
+        new_entry->set_txn_id(entry.txn_id());
+        new_entry->set_num_partitions(entry.num_partitions());
+        new_entry->set_is_complete(entry.is_complete());
+        new_entry->mutable_incoming_edges()->Add(entry.incoming_edges().begin(), entry.incoming_edges().end());
+      }
     }
     log.clear();
 
+    graph_log_bytes_ = build_plain_log ? graph_log.ByteSizeLong() : 0;
+    if (compact) {
+      auto compact_graph_log = graph_log_env.mutable_request()->mutable_compact_graph_log();
+      EncodeCoalescedLog(*compact_graph_log);
+      sent_graph_log_bytes_ = compact_graph_log->ByteSizeLong();
+    } else {
+      graph_log_env.mutable_request()->mutable_graph_log()->Swap(&graph_log);
+      sent_graph_log_bytes_ = graph_log_bytes_;
+    }
+
     vector<MachineId> other_partitions;
     other_partitions.reserve(config_->num_partitions());
     for (int p = 0; p < config_->num_partitions(); p++) {
@@ -203,6 +239,76 @@ class DeadlockResolver : public NetworkedModule {
     }
   }
 
+  /**
+   * Merges an entry into the entry of the same txn seen earlier in the current run. Applying the
+   * merged entry to a graph yields the same nodes and edges as applying the original entries one by one
+   */
+  void CoalesceEntry(const DDRLockManager::LogEntry& entry) {
+    auto ins = coalesced_index_.try_emplace(entry.txn_id(), coalesced_log_.size());
+    if (ins.second) {
+      coalesced_log_.push_back({.txn_id = entry.txn_id(),
+                                .num_partitions = entry.num_partitions(),
+                                .is_complete = entry.is_complete(),
+                                .incoming_edges = entry.incoming_edges()});
+      return;
+    }
+    auto& coalesced = coalesced_log_[ins.first->second];
+    coalesced.is_complete |= entry.is_complete();
+    coalesced.incoming_edges.insert(coalesced.incoming_edges.end(), entry.incoming_edges().begin(),
+                                    entry.incoming_edges().end());
+  }
+
+  void EncodeCoalescedLog(internal::CompactGraphLog& compact_log) {
+    TxnId prev_txn_id = 0;
+    for (auto& entry : coalesced_log_) {
+      // Txn ids and edges are mostly close to each other so their differences fit in fewer varint bytes
+      compact_log.add_txn_id_deltas(static_cast<int64_t>(entry.txn_id - prev_txn_id));
+      compact_log.add_num_partitions(entry.num_partitions);
+      compact_log.add_is_complete(entry.is_complete);
+      auto& edges = entry.incoming_edges;
+      std::sort(edges.begin(), edges.end());
+      edges.erase(std::unique(edges.begin(), edges.end()), edges.end());
+      compact_log.add_num_edges(edges.size());
+      for (auto v : edges) {
+        compact_log.add_edge_offsets(static_cast<int64_t>(v - entry.txn_id));
+      }
+      prev_txn_id = entry.txn_id;
+    }
+    coalesced_log_.clear();
+    coalesced_index_.clear();
+  }
+
+  void UpdateGraphFromCompactLog(const internal::CompactGraphLog& compact_log) {
+    auto num_entries = compact_log.txn_id_deltas_size();
+    CHECK_EQ(compact_log.num_partitions_size(), num_entries);
+    CHECK_EQ(compact_log.is_complete_size(), num_entries);
+    CHECK_EQ(compact_log.num_edges_size(), num_entries);
+
+    vector<DDRLockManager::LogEntry> entries;
+    entries.reserve(num_entries);
+    TxnId txn_id = 0;
+    int edge_index = 0;
+    for (int i = 0; i < num_entries; i++) {
+      txn_id += static_cast<TxnId>(compact_log.txn_id_deltas(i));
+      vector<TxnId> incoming_edges;
+      incoming_edges.reserve(compact_log.num_edges(i));
+      for (uint32_t j = 0; j < compact_log.num_edges(i); j++) {
+        CHECK_LT(edge_index, compact_log.edge_offsets_size());
+        incoming_edges.push_back(txn_id + static_cast<TxnId>(compact_log.edge_offsets(edge_index++)));
+      }
+      entries.emplace_back(txn_id, compact_log.num_partitions(i), compact_log.is_complete(i), incoming_edges);
+    }
+
+    // Coalescing may move an entry ahead of the entries of its incoming edges, so all nodes are
+    // created first to make sure that no outgoing edge is dropped
+    for (const auto& entry : entries) {
+      graph_.try_emplace(entry.txn_id(), entry.txn_id(), entry.num_partitions());
+    }
+    for (const auto& entry : entries) {
+      UpdateGraph(entry);
+    }
+  }
+
   template <typename LogEntry>
   void UpdateGraph(const LogEntry& entry) {
     // Create a new node if not exists
@@ -636,6 +742,25 @@ vector<pair<TxnId, bool>> DDRLockManager::ReleaseLocks(TxnId txn_id) {
   return result;
 }
 
+bool DDRLockManager::HoldsArrivedLocks(TxnId txn_id) const {
+  lock_guard<SpinLatch> guard(txn_info_latch_);
+  auto it = txn_info_.find(txn_id);
+  if (it == txn_info_.end()) {
+    return false;
+  }
+  return it->second.num_waiting_for == 0 && it->second.unarrived_lock_requests > 0;
+}
+
+int DDRLockManager::NumWaiters(TxnId txn_id) const {
+  lock_guard<SpinLatch> guard(txn_info_latch_);
+  auto it = txn_info_.find(txn_id);
+  if (it == txn_info_.end()) {
+    return 0;
+  }
+  const auto& waited_by = it->second.waited_by;
+  return std::count_if(waited_by.begin(), waited_by.end(), [](TxnId id) { return id != kSentinelTxnId; });
+}
+
 /**
  * {
  *    lock_manager_type: 1,
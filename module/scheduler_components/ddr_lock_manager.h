@@ -1,11 +1,5 @@
 #pragma once
 
-// Prevent mixing with other versions
-#ifdef LOCK_MANAGER
-#error "Only one lock manager can be included"
-#endif
-#define LOCK_MANAGER
-
 #include <atomic>
 #include <list>
 #include <optional>
@@ -21,6 +15,7 @@
 #include "common/spin_latch.h"
 #include "common/types.h"
 #include "module/base/networked_module.h"
+#include "module/scheduler_components/lock_manager.h"
 #include "module/scheduler_components/txn_holder.h"
 
 namespace slog {
@@ -71,7 +66,7 @@ class DeadlockResolver;
  * incorrect master and will be aborted. Remaster transactions request the
  * locks for both <key, old region> and <key, new region>.
  */
-class DDRLockManager {
+class DDRLockManager : public LockManager {
  public:
   DDRLockManager();
 
@@ -111,7 +106,7 @@ class DDRLockManager {
    * @return    true if all locks are acquired, false if not and
    *            the transaction is queued up.
    */
-  AcquireLocksResult AcquireLocks(const Transaction& txn);
+  AcquireLocksResult AcquireLocks(const Transaction& txn) final;
 
   /**
    * Releases all locks that a transaction is holding or waiting for.
@@ -122,14 +117,18 @@ class DDRLockManager {
    *            the txn being unblocked and deadlocked indicates whether
    *            the txn was in a deadlock.
    */
-  std::vector<std::pair<TxnId, bool>> ReleaseLocks(TxnId txn_id);
+  std::vector<std::pair<TxnId, bool>> ReleaseLocks(TxnId txn_id) final;
+
+  bool HoldsArrivedLocks(TxnId txn_id) const final;
+
+  int NumWaiters(TxnId txn_id) const final;
 
   /**
    * Gets current statistics of the lock manager
    *
    * @param stats A JSON object where the statistics are stored into
    */
-  void GetStats(rapidjson::Document& stats, uint32_t level) const;
+  void GetStats(rapidjson::Document& stats, uint32_t level) const final;
 
  private:
   friend class DeadlockResolver;
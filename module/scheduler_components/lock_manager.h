@@ -0,0 +1,71 @@
+#pragma once
+
+#include <utility>
+#include <vector>
+
+#include "common/json_utils.h"
+#include "common/types.h"
+#include "proto/transaction.pb.h"
+
+namespace slog {
+
+/**
+ * Common interface of the lock managers. The implementation used by the
+ * scheduler is selected by the lock_manager option in the configuration.
+ */
+class LockManager {
+ public:
+  virtual ~LockManager() = default;
+
+  /**
+   * Tries to acquire all locks for a given transaction. If not
+   * all locks are acquired, the transaction is queued up to wait
+   * for the current lock holders to release.
+   *
+   * @param txn The transaction whose locks are acquired.
+   * @return    ACQUIRED if all locks are acquired, WAITING if not and
+   *            the transaction is queued up, ABORT if the transaction
+   *            must be aborted.
+   */
+  virtual AcquireLocksResult AcquireLocks(const Transaction& txn) = 0;
+
+  /**
+   * Releases all locks that a transaction is holding or waiting for.
+   *
+   * @param txn_id Id of transaction whose locks are released.
+   *               LockOnly txn is not accepted.
+   * @return       A list of <txn_id, deadlocked>, where txn_id is the id of
+   *               a txn that obtains all of its locks thanks to this release
+   *               and deadlocked indicates whether the txn was in a deadlock.
+   *               Only lock managers that resolve deadlocks set deadlocked.
+   */
+  virtual std::vector<std::pair<TxnId, bool>> ReleaseLocks(TxnId txn_id) = 0;
+
+  /**
+   * Checks whether a txn holds all locks that it has requested so far while
+   * some of its lock requests have not arrived yet, which is the case for a
+   * multi-home txn whose lock-only txns are still in flight.
+   *
+   * @param txn_id Id of the txn to check.
+   * @return       false if the lock manager does not track this information.
+   */
+  virtual bool HoldsArrivedLocks(TxnId /* txn_id */) const { return false; }
+
+  /**
+   * Gets the number of txns waiting for the locks of a txn, which approximates
+   * how much work is unblocked when the txn releases its locks.
+   *
+   * @param txn_id Id of the txn to check.
+   * @return       0 if the lock manager does not track this information.
+   */
+  virtual int NumWaiters(TxnId /* txn_id */) const { return 0; }
+
+  /**
+   * Gets current statistics of the lock manager
+   *
+   * @param stats A JSON object where the statistics are stored into
+   */
+  virtual void GetStats(rapidjson::Document& stats, uint32_t level) const = 0;
+};
+
+}  // namespace slog
@@ -148,8 +148,8 @@ AcquireLocksResult OldLockManager::AcquireLocks(const Transaction& txn) {
   return AcquireLocksResult::WAITING;
 }
 
-vector<TxnId> OldLockManager::ReleaseLocks(TxnId txn_id) {
-  vector<TxnId> result;
+vector<pair<TxnId, bool>> OldLockManager::ReleaseLocks(TxnId txn_id) {
+  vector<pair<TxnId, bool>> result;
   auto info_it = txn_info_.find(txn_id);
   if (info_it == txn_info_.end()) {
     return result;
@@ -178,7 +178,7 @@ vector<TxnId> OldLockManager::ReleaseLocks(TxnId txn_id) {
       DCHECK(it != txn_info_.end());
       it->second.num_waiting_for--;
       if (it->second.is_ready()) {
-        result.push_back(new_txn);
+        result.emplace_back(new_txn, false);
       }
     }
   }
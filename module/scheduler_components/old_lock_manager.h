@@ -1,10 +1,5 @@
 #pragma once
 
-#ifdef LOCK_MANAGER
-#error "Only one lock manager can be included"
-#endif
-#define LOCK_MANAGER
-
 #include <list>
 #include <unordered_map>
 #include <unordered_set>
@@ -14,6 +9,7 @@
 #include "common/constants.h"
 #include "common/json_utils.h"
 #include "common/types.h"
+#include "module/scheduler_components/lock_manager.h"
 #include "module/scheduler_components/txn_holder.h"
 
 using std::list;
@@ -56,7 +52,7 @@ class OldLockState {
  * in the order that they request. If transaction X, appears before
  * transaction Y in the log, X always gets all locks before Y.
  */
-class OldLockManager {
+class OldLockManager : public LockManager {
  public:
   /**
    * Tries to acquire all locks for a given transaction. If not
@@ -67,24 +63,24 @@ class OldLockManager {
    * @return    true if all locks are acquired, false if not and
    *            the transaction is queued up.
    */
-  AcquireLocksResult AcquireLocks(const Transaction& txn);
+  AcquireLocksResult AcquireLocks(const Transaction& txn) final;
 
   /**
    * Releases all locks that a transaction is holding or waiting for.
    *
    * @param txn_id Id of transaction whose locks are released.
    *               LockOnly txn is not accepted.
-   * @return    A set of IDs of transactions that are able to obtain
-   *            all of their locks thanks to this release.
+   * @return    A list of <txn_id, false> where txn_id is the id of a
+   *            txn that is able to obtain all of its locks thanks to this release.
    */
-  vector<TxnId> ReleaseLocks(TxnId txn_id);
+  vector<pair<TxnId, bool>> ReleaseLocks(TxnId txn_id) final;
 
   /**
    * Gets current statistics of the lock manager
    *
    * @param stats A JSON object where the statistics are stored into
    */
-  void GetStats(rapidjson::Document& stats, uint32_t level) const;
+  void GetStats(rapidjson::Document& stats, uint32_t level) const final;
 
  private:
   struct TxnInfo {
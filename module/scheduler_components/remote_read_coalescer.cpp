@@ -0,0 +1,34 @@
+#include "module/scheduler_components/remote_read_coalescer.h"
+
+namespace slog {
+
+bool RemoteReadCoalescer::Add(const internal::RemoteReadResult& result, const std::vector<MachineId>& destinations) {
+  std::lock_guard<std::mutex> guard(mut_);
+  bool new_round = batches_.empty();
+  for (auto dest : destinations) {
+    auto& env = batches_[dest];
+    if (env == nullptr) {
+      env = std::make_unique<internal::Envelope>();
+    }
+    env->mutable_request()->mutable_remote_read_result_batch()->add_results()->CopyFrom(result);
+  }
+  num_results_.fetch_add(destinations.size(), std::memory_order_relaxed);
+  return new_round;
+}
+
+std::vector<std::pair<MachineId, EnvelopePtr>> RemoteReadCoalescer::Flush() {
+  std::unordered_map<MachineId, EnvelopePtr> batches;
+  {
+    std::lock_guard<std::mutex> guard(mut_);
+    batches.swap(batches_);
+  }
+  std::vector<std::pair<MachineId, EnvelopePtr>> res;
+  res.reserve(batches.size());
+  for (auto& [dest, env] : batches) {
+    res.emplace_back(dest, std::move(env));
+  }
+  num_batches_.fetch_add(res.size(), std::memory_order_relaxed);
+  return res;
+}
+
+}  // namespace slog
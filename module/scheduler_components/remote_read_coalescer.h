@@ -0,0 +1,51 @@
+#pragma once
+
+#include <atomic>
+#include <mutex>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+#include "common/types.h"
+#include "connection/zmq_utils.h"
+#include "proto/internal.pb.h"
+
+namespace slog {
+
+/**
+ * Packs the remote reads sent by all workers of a machine into one message per
+ * destination machine. The first result added after a flush starts a new round and
+ * the worker that added it is responsible for flushing the round later.
+ */
+class RemoteReadCoalescer {
+ public:
+  RemoteReadCoalescer() : num_batches_(0), num_results_(0) {}
+
+  /**
+   * Adds a remote read result to the batches of the given machines
+   *
+   * @param result       The remote read result
+   * @param destinations Machines to send the result to
+   * @return             true if this result starts a new round of batches
+   */
+  bool Add(const internal::RemoteReadResult& result, const std::vector<MachineId>& destinations);
+
+  /**
+   * Takes out the batches of the current round
+   *
+   * @return Pairs of <destination, envelope containing a RemoteReadResultBatch>
+   */
+  std::vector<std::pair<MachineId, EnvelopePtr>> Flush();
+
+  uint64_t num_batches() const { return num_batches_.load(std::memory_order_relaxed); }
+  uint64_t num_results() const { return num_results_.load(std::memory_order_relaxed); }
+
+ private:
+  std::mutex mut_;
+  std::unordered_map<MachineId, EnvelopePtr> batches_;
+
+  std::atomic<uint64_t> num_batches_;
+  std::atomic<uint64_t> num_results_;
+};
+
+}  // namespace slog
@@ -156,8 +156,8 @@ AcquireLocksResult RMALockManager::AcquireLocks(const Transaction& txn) {
   return AcquireLocksResult::WAITING;
 }
 
-vector<TxnId> RMALockManager::ReleaseLocks(TxnId txn_id) {
-  vector<TxnId> result;
+vector<pair<TxnId, bool>> RMALockManager::ReleaseLocks(TxnId txn_id) {
+  vector<pair<TxnId, bool>> result;
   auto info_it = txn_info_.find(txn_id);
   if (info_it == txn_info_.end()) {
     return result;
@@ -184,7 +184,7 @@ vector<TxnId> RMALockManager::ReleaseLocks(TxnId txn_id) {
       DCHECK(it != txn_info_.end());
       it->second.num_waiting_for--;
       if (it->second.is_ready()) {
-        result.push_back(new_txn);
+        result.emplace_back(new_txn, false);
       }
     }
   }
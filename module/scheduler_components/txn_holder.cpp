@@ -2,7 +2,7 @@
 
 namespace slog {
 
-TxnHolder::TxnHolder(const ConfigurationPtr& config, Transaction* txn)
+TxnHolder::TxnHolder(const ConfigurationPtr& config, TxnPtr txn)
     : txn_id_(txn->internal().id()),
       main_txn_idx_(txn->internal().home()),
       lo_txns_(config->num_regions()),
@@ -14,11 +14,11 @@ TxnHolder::TxnHolder(const ConfigurationPtr& config, Transaction* txn)
       expected_num_lo_txns_(txn->internal().involved_regions_size()),
       num_dispatches_(0),
       worker_(std::nullopt) {
-  lo_txns_[main_txn_idx_].reset(txn);
+  lo_txns_[main_txn_idx_] = std::move(txn);
   ++num_lo_txns_;
 }
 
-bool TxnHolder::AddLockOnlyTxn(Transaction* txn) {
+bool TxnHolder::AddLockOnlyTxn(TxnPtr txn) {
   auto home = txn->internal().home();
   CHECK_LT(home, static_cast<int>(lo_txns_.size()));
 
@@ -26,14 +26,14 @@ bool TxnHolder::AddLockOnlyTxn(Transaction* txn) {
     return false;
   }
 
-  lo_txns_[home].reset(txn);
+  lo_txns_[home] = std::move(txn);
 
   ++num_lo_txns_;
 
   return true;
 }
 
-Transaction* TxnHolder::FinalizeAndRelease() {
+TxnPtr TxnHolder::FinalizeAndRelease() {
   auto& main_txn = lo_txns_[main_txn_idx_];
   auto main_internal = main_txn->mutable_internal();
   int cutoff = main_internal->events_size();
@@ -61,19 +61,21 @@ Transaction* TxnHolder::FinalizeAndRelease() {
   for (auto& lo_txn : lo_txns_) {
     if (lo_txn != nullptr && lo_txn != main_txn) {
       auto internal = lo_txn->mutable_internal();
-      // Only transfer the events after the cutoff point to the main txn
+      // Only transfer the events after the cutoff point to the main txn. AddAllocated takes over
+      // the events if both txns are on the heap and copies them if the txns are in different arenas.
+      // Either way, the original pointers must be dropped without copying or freeing them
       for (int i = cutoff; i < internal->events_size(); i++) {
         main_internal->mutable_events()->AddAllocated(internal->mutable_events(i));
       }
       while (internal->events_size() > cutoff) {
-        internal->mutable_events()->ReleaseLast();
+        internal->mutable_events()->UnsafeArenaReleaseLast();
       }
       lo_txn.reset();
     }
   }
 
   // Do not use clear() here because lo_txns_ must never change in size
-  return lo_txns_[main_txn_idx_].release();
+  return std::move(lo_txns_[main_txn_idx_]);
 }
 
 }  // namespace slog
\ No newline at end of file
@@ -2,11 +2,15 @@
 
 #include <glog/logging.h>
 
+#include <memory>
 #include <optional>
+#include <string>
 #include <vector>
 
+#include "common/batch_log.h"
 #include "common/configuration.h"
 #include "common/proto_utils.h"
+#include "common/small_vector.h"
 #include "common/types.h"
 #include "proto/transaction.pb.h"
 
@@ -14,13 +18,49 @@ namespace slog {
 
 using EnvelopePtr = std::unique_ptr<internal::Envelope>;
 
+/**
+ * A speculative run of a multi-home txn that started before all of its lock-only txns
+ * arrived. It is created by the scheduler and only accessed by the worker of the txn
+ * afterwards, until the worker reports the txn as finished.
+ */
+struct Speculation {
+  explicit Speculation(const Transaction& txn) : txn(txn), executed(false), committed(false) {}
+
+  // Private copy of the txn. The writes of the speculative run are buffered in this copy
+  Transaction txn;
+  // Values read by the speculative run, in the order of the keys. Empty if the key did not exist
+  std::vector<std::string> reads;
+  bool executed;
+  // Whether the result of the speculative run was validated and committed
+  bool committed;
+};
+
+/**
+ * The new metadata of the key of a committed remaster txn. It is kept in the holder since the
+ * txn itself is released by the worker before the scheduler learns that it finished
+ */
+struct RemasterResult {
+  Key key;
+  uint32_t new_master;
+  uint32_t counter;
+};
+
 class TxnHolder {
  public:
-  TxnHolder(const ConfigurationPtr& config, Transaction* txn);
+  // Number of lock-only txns that are stored inline in the holder
+  static constexpr size_t kNumInlineLockOnlyTxns = 4;
 
-  bool AddLockOnlyTxn(Transaction* txn);
+  /**
+   * The txns may be owned by the batch that they came in, in which case they
+   * keep the batch alive until released
+   */
+  TxnHolder(const ConfigurationPtr& config, TxnPtr txn);
+  TxnHolder(const ConfigurationPtr& config, Transaction* txn) : TxnHolder(config, TxnPtr(txn)) {}
 
-  Transaction* FinalizeAndRelease();
+  bool AddLockOnlyTxn(TxnPtr txn);
+  bool AddLockOnlyTxn(Transaction* txn) { return AddLockOnlyTxn(TxnPtr(txn)); }
+
+  TxnPtr FinalizeAndRelease();
 
   TxnId txn_id() const { return txn_id_; }
   Transaction& txn() const {
@@ -29,8 +69,10 @@ class TxnHolder {
   }
   Transaction& lock_only_txn(size_t i) const { return *lo_txns_[i]; }
 
-  void SetRemasterResult(const Key& key, uint32_t counter) { remaster_result_.emplace(key, counter); }
-  std::optional<pair<Key, uint32_t>> remaster_result() const { return remaster_result_; }
+  void SetRemasterResult(const Key& key, uint32_t new_master, uint32_t counter) {
+    remaster_result_.emplace(RemasterResult{key, new_master, counter});
+  }
+  const std::optional<RemasterResult>& remaster_result() const { return remaster_result_; }
 
   void SetUndispatchable() { dispatchable_ = false; }
   bool dispatchable() const { return dispatchable_; }
@@ -51,11 +93,14 @@ class TxnHolder {
   void SetWorker(int worker) { worker_ = worker; }
   std::optional<int> worker() const { return worker_; }
 
+  void StartSpeculation() { speculation_ = std::make_unique<Speculation>(txn()); }
+  Speculation* speculation() const { return speculation_.get(); }
+
  private:
   TxnId txn_id_;
   size_t main_txn_idx_;
-  std::vector<std::unique_ptr<Transaction>> lo_txns_;
-  std::optional<pair<Key, uint32_t>> remaster_result_;
+  SmallVector<TxnPtr, kNumInlineLockOnlyTxns> lo_txns_;
+  std::optional<RemasterResult> remaster_result_;
   bool dispatchable_;
   bool aborting_;
   bool done_;
@@ -63,6 +108,7 @@ class TxnHolder {
   int expected_num_lo_txns_;
   int num_dispatches_;
   std::optional<int> worker_;
+  std::unique_ptr<Speculation> speculation_;
 };
 
 }  // namespace slog
\ No newline at end of file
@@ -15,12 +15,41 @@ using std::make_pair;
 namespace slog {
 
 namespace {
-uint64_t MakeTag(const RunId& run_id) { return run_id.first * 10 + run_id.second; }
+Channel MakeTag(const RunId& run_id) { return Broker::MakeRemoteReadTag(run_id.first, run_id.second); }
 
 inline std::ostream& operator<<(std::ostream& os, const RunId& run_id) {
   os << "(" << TXN_ID_STR(run_id.first) << ", " << run_id.second << ")";
   return os;
 }
+
+// Storage given to the execution of speculative runs. The writes are dropped because they
+// are already buffered in the private copy of the txn, which is applied once validated
+class SpeculativeStorage : public Storage {
+ public:
+  SpeculativeStorage(const std::shared_ptr<Storage>& storage) : storage_(storage) {}
+  bool Read(const Key& key, Record& result) const final { return storage_->Read(key, result); }
+  bool Write(const Key&, const Record&) final { return false; }
+  bool Delete(const Key&) final { return false; }
+
+ private:
+  std::shared_ptr<Storage> storage_;
+};
+
+std::unique_ptr<Execution> MakeExecution(internal::ExecutionType type, const SharderPtr& sharder,
+                                         const std::shared_ptr<Storage>& storage) {
+  switch (type) {
+    case internal::ExecutionType::KEY_VALUE:
+      return std::make_unique<KeyValueExecution>(sharder, storage);
+    case internal::ExecutionType::TPC_C:
+      return std::make_unique<TPCCExecution>(sharder, storage);
+    case internal::ExecutionType::PPS:
+      return std::make_unique<PPSExecution>(sharder, storage);
+    case internal::ExecutionType::small_bank:
+      return std::make_unique<SmallBankExecution>(sharder, storage);
+    default:
+      return std::make_unique<NoopExecution>();
+  }
+}
 }  // namespace
 
 using internal::Envelope;
@@ -28,35 +57,31 @@ using internal::Request;
 using internal::Response;
 using std::make_unique;
 
-Worker::Worker(int id, const std::shared_ptr<Broker>& broker, const std::shared_ptr<Storage>& storage,
-               const MetricsRepositoryManagerPtr& metrics_manager, std::chrono::milliseconds poll_timeout)
-    : NetworkedModule(broker, kWorkerChannel + id, metrics_manager, poll_timeout), id_(id), storage_(storage) {
-  switch (config()->execution_type()) {
-    case internal::ExecutionType::KEY_VALUE:
-      execution_ = make_unique<KeyValueExecution>(Sharder::MakeSharder(config()), storage);
-      break;
-    case internal::ExecutionType::TPC_C:
-      execution_ = make_unique<TPCCExecution>(Sharder::MakeSharder(config()), storage);
-      break;
-    case internal::ExecutionType::PPS:
-      execution_ = make_unique<PPSExecution>(Sharder::MakeSharder(config()), storage);
-      break;
-    case internal::ExecutionType::small_bank:
-      execution_ = make_unique<SmallBankExecution>(Sharder::MakeSharder(config()), storage);
-      break;
-    default:
-      execution_ = make_unique<NoopExecution>();
-      break;
+Worker::Worker(int id, const std::shared_ptr<SchedulerWorkerQueues>& queues, const std::shared_ptr<Broker>& broker,
+               const std::shared_ptr<Storage>& storage, const MetricsRepositoryManagerPtr& metrics_manager,
+               const std::shared_ptr<RemoteReadCoalescer>& remote_read_coalescer, std::chrono::milliseconds poll_timeout)
+    : NetworkedModule(broker, kWorkerChannel + id, metrics_manager, poll_timeout),
+      id_(id),
+      queues_(queues),
+      storage_(storage),
+      sharder_(Sharder::MakeSharder(config())),
+      remote_read_coalescer_(remote_read_coalescer) {
+  execution_ = MakeExecution(config()->execution_type(), sharder_, storage);
+  if (config()->speculative_multi_home()) {
+    speculative_execution_ =
+        MakeExecution(config()->execution_type(), sharder_, std::make_shared<SpeculativeStorage>(storage));
   }
 }
 
 void Worker::Initialize() {
-  zmq::socket_t sched_socket(*context(), ZMQ_PAIR);
-  sched_socket.set(zmq::sockopt::rcvhwm, 0);
-  sched_socket.set(zmq::sockopt::sndhwm, 0);
-  sched_socket.connect(kSchedWorkerAddress + std::to_string(id_));
+  AddCustomEventFd(queues_->to_worker.notify_fd());
 
-  AddCustomSocket(std::move(sched_socket));
+  // The counter must be created in the worker thread to count the events of this thread
+  cache_misses_ = make_unique<PerfCounter>(PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES);
+  if (cache_misses_->fd() < 0) {
+    LOG(WARNING) << "Cannot open the cache-miss counter of " << name();
+  }
+  queues_->cache_misses_fd = cache_misses_->fd();
 }
 
 void Worker::OnInternalRequestReceived(EnvelopePtr&& env) {
@@ -65,7 +90,9 @@ void Worker::OnInternalRequestReceived(EnvelopePtr&& env) {
   auto run_id = make_pair(read_result.txn_id(), read_result.deadlocked());
   auto state_it = txn_states_.find(run_id);
   if (state_it == txn_states_.end()) {
-    LOG(WARNING) << "Transaction " << run_id << " does not exist for remote read result";
+    if (!AbsorbLateRemoteRead(run_id)) {
+      LOG(WARNING) << "Transaction " << run_id << " does not exist for remote read result";
+    }
     return;
   }
 
@@ -82,8 +109,6 @@ void Worker::OnInternalRequestReceived(EnvelopePtr&& env) {
 
   if (txn.status() != TransactionStatus::ABORTED) {
     if (read_result.will_abort()) {
-      // TODO: optimize by returning an aborting transaction to the scheduler immediately.
-      // later remote reads will need to be garbage collected.
       txn.set_status(TransactionStatus::ABORTED);
       txn.set_abort_code(read_result.abort_code());
       txn.set_abort_reason(read_result.abort_reason());
@@ -97,8 +122,17 @@ void Worker::OnInternalRequestReceived(EnvelopePtr&& env) {
 
   state.remote_reads_waiting_on--;
 
-  // Move the transaction to a new phase if all remote reads arrive
-  if (state.remote_reads_waiting_on == 0) {
+  if (txn.status() == TransactionStatus::ABORTED && state.remote_reads_waiting_on > 0 && CanAbortEarly()) {
+    // The outcome is already known so return the txn to the scheduler immediately to
+    // release its locks. The remaining remote reads are absorbed by a tombstone
+    CHECK(state.phase == TransactionState::Phase::WAIT_REMOTE_READ) << "Invalid phase";
+    AddTombstone(run_id, state.remote_reads_waiting_on);
+    state.phase = TransactionState::Phase::FINISH;
+
+    VLOG(3) << "Abort txn " << run_id << " early, still waiting for " << state.remote_reads_waiting_on
+            << " remote reads";
+  } else if (state.remote_reads_waiting_on == 0) {
+    // Move the transaction to a new phase if all remote reads arrive
     if (state.phase == TransactionState::Phase::WAIT_REMOTE_READ) {
       state.phase = TransactionState::Phase::EXECUTE;
 
@@ -115,20 +149,26 @@ void Worker::OnInternalRequestReceived(EnvelopePtr&& env) {
 }
 
 bool Worker::OnCustomSocket() {
-  auto& sched_socket = GetCustomSocket(0);
+  // Keep polling while there are finished txns not yet handed to the scheduler
+  bool has_pending = queues_->to_scheduler.Flush();
 
-  zmq::message_t msg;
-  if (!sched_socket.recv(msg, zmq::recv_flags::dontwait)) {
-    return false;
+  WorkerDispatch msg;
+  if (!queues_->to_worker.Pop(msg)) {
+    return has_pending;
+  }
+
+  auto [txn_holder, deadlocked, speculative] = msg;
+  if (speculative) {
+    Speculate(txn_holder);
+    return true;
   }
 
-  auto [txn_holder, deadlocked] = *msg.data<std::pair<TxnHolder*, bool>>();
   auto& txn = txn_holder->txn();
   auto run_id = std::make_pair(txn.internal().id(), deadlocked);
   if (deadlocked) {
     auto old_run_id = std::make_pair(txn.internal().id(), false);
     // Clean up any transaction state created before the deadlock was detected
-    if (txn_states_.erase(old_run_id)) {
+    if (txn_states_.erase(old_run_id) || tombstones_.erase(old_run_id)) {
       StopRedirection(old_run_id);
     }
   }
@@ -229,12 +269,10 @@ void Worker::ReadLocalStorage(const RunId& run_id) {
   // Set the number of remote reads that this partition needs to wait for
   state.remote_reads_waiting_on = 0;
 
-#ifdef LOCK_MANAGER_DDR
   // If DDR is used, all partitions have to wait
-  const auto& waiting_partitions = txn.internal().involved_partitions();
-#else
-  const auto& waiting_partitions = txn.internal().active_partitions();
-#endif
+  const auto& waiting_partitions = config()->lock_manager() == internal::LockManagerType::DDR
+                                       ? txn.internal().involved_partitions()
+                                       : txn.internal().active_partitions();
   if (std::find(waiting_partitions.begin(), waiting_partitions.end(), config()->local_partition()) !=
       waiting_partitions.end()) {
     // Waiting partition needs remote reads from all partitions
@@ -243,6 +281,14 @@ void Worker::ReadLocalStorage(const RunId& run_id) {
   if (state.remote_reads_waiting_on == 0) {
     VLOG(3) << "Execute txn " << run_id << " without remote reads";
     state.phase = TransactionState::Phase::EXECUTE;
+  } else if (txn.status() == TransactionStatus::ABORTED && CanAbortEarly()) {
+    // The other partitions are told about the abort above so there is no need to wait
+    // for their reads. The redirection is still needed for the tombstone to absorb them
+    StartRedirection(run_id);
+    AddTombstone(run_id, state.remote_reads_waiting_on);
+
+    VLOG(3) << "Abort txn " << run_id << " without waiting for remote reads";
+    state.phase = TransactionState::Phase::FINISH;
   } else {
     // Establish a redirection at broker for this txn so that we can receive remote reads
     StartRedirection(run_id);
@@ -258,7 +304,7 @@ void Worker::Execute(const RunId& run_id) {
 
   switch (txn.program_case()) {
     case Transaction::kCode: {
-      if (txn.status() != TransactionStatus::ABORTED) {
+      if (txn.status() != TransactionStatus::ABORTED && !CommitSpeculation(state.txn_holder)) {
         execution_->Execute(txn);
       }
 
@@ -270,6 +316,11 @@ void Worker::Execute(const RunId& run_id) {
       break;
     }
     case Transaction::kRemaster: {
+      // The key keeps its metadata if the remaster is aborted
+      if (txn.status() == TransactionStatus::ABORTED) {
+        VLOG(3) << "Remaster txn " << run_id << " aborted with reason: " << txn.abort_reason();
+        break;
+      }
       txn.set_status(TransactionStatus::COMMITTED);
       auto it = txn.keys().begin();
       const auto& key = it->key();
@@ -279,7 +330,7 @@ void Worker::Execute(const RunId& run_id) {
       record.SetMetadata(Metadata(txn.remaster().new_master(), new_counter));
       storage_->Write(key, record);
 
-      state.txn_holder->SetRemasterResult(key, new_counter);
+      state.txn_holder->SetRemasterResult(key, txn.remaster().new_master(), new_counter);
       break;
     }
     default:
@@ -288,6 +339,69 @@ void Worker::Execute(const RunId& run_id) {
   state.phase = TransactionState::Phase::FINISH;
 }
 
+void Worker::Speculate(TxnHolder* txn_holder) {
+  auto speculation = txn_holder->speculation();
+  CHECK(speculation != nullptr) << "No speculation to run";
+  auto& txn = speculation->txn;
+
+  speculation->reads.reserve(txn.keys_size());
+  for (auto& kv : *(txn.mutable_keys())) {
+    auto value = kv.mutable_value_entry();
+    if (Record record; storage_->Read(kv.key(), record)) {
+      // Leave it to the regular run to abort the txn
+      if (value->metadata().master() != record.metadata().master) {
+        VLOG(3) << "Skip speculating txn " << TXN_ID_STR(txn.internal().id()) << " due to outdated master";
+        return;
+      }
+      value->set_value(record.to_string());
+    }
+    speculation->reads.push_back(value->value());
+  }
+
+  speculative_execution_->Execute(txn);
+  speculation->executed = true;
+
+  VLOG(3) << "Speculatively executed txn " << TXN_ID_STR(txn.internal().id());
+}
+
+bool Worker::CommitSpeculation(TxnHolder* txn_holder) {
+  auto speculation = txn_holder->speculation();
+  if (speculation == nullptr || !speculation->executed) {
+    return false;
+  }
+  // Run the speculation at most once
+  speculation->executed = false;
+
+  auto& txn = txn_holder->txn();
+  auto& spec_txn = speculation->txn;
+  if (txn.keys_size() != spec_txn.keys_size()) {
+    return false;
+  }
+  // The execution is deterministic so the speculative result is valid if it read the same values
+  for (int i = 0; i < txn.keys_size(); i++) {
+    if (txn.keys(i).value_entry().value() != speculation->reads[i]) {
+      VLOG(3) << "Re-execute txn " << TXN_ID_STR(txn.internal().id()) << " after failing validation";
+      return false;
+    }
+  }
+
+  txn.set_status(spec_txn.status());
+  txn.set_abort_code(spec_txn.abort_code());
+  txn.set_abort_reason(spec_txn.abort_reason());
+  if (txn.status() == TransactionStatus::COMMITTED) {
+    for (int i = 0; i < txn.keys_size(); i++) {
+      txn.mutable_keys(i)->mutable_value_entry()->set_new_value(spec_txn.keys(i).value_entry().new_value());
+    }
+    txn.mutable_deleted_keys()->CopyFrom(spec_txn.deleted_keys());
+    Execution::ApplyWrites(txn, sharder_, storage_);
+  }
+  speculation->committed = true;
+
+  VLOG(3) << "Committed speculative result of txn " << TXN_ID_STR(txn.internal().id());
+
+  return true;
+}
+
 void Worker::Finish(const RunId& run_id) {
   auto& state = TxnState(run_id);
   auto txn = state.txn_holder->FinalizeAndRelease();
@@ -304,16 +418,16 @@ void Worker::Finish(const RunId& run_id) {
     Envelope env;
     auto finished_sub_txn = env.mutable_request()->mutable_finished_subtxn();
     finished_sub_txn->set_partition(config()->local_partition());
-    finished_sub_txn->set_allocated_txn(txn);
+    // The txn may be owned by the arena of its batch so it is only lent to the envelope for serialization
+    finished_sub_txn->unsafe_arena_set_allocated_txn(txn.get());
     Send(env, txn->internal().coordinating_server(), kServerChannel);
-  } else {
-    delete txn;
+    finished_sub_txn->unsafe_arena_release_txn();
   }
+  // Releasing the txn frees its batch if this is the last txn of the batch
+  txn.reset();
 
   // Notify the scheduler that we're done
-  zmq::message_t msg(sizeof(TxnId));
-  *msg.data<TxnId>() = run_id.first;
-  GetCustomSocket(0).send(msg, zmq::send_flags::none);
+  queues_->to_scheduler.Push(run_id.first);
 
   // Done with this txn. Remove it from the state map
   txn_states_.erase(run_id);
@@ -326,12 +440,10 @@ void Worker::BroadcastReads(const RunId& run_id) {
   auto txn_holder = state.txn_holder;
   auto& txn = txn_holder->txn();
 
-#ifdef LOCK_MANAGER_DDR
   // If DDR is used, all partitions have to wait
-  const auto& waiting_partitions = txn.internal().involved_partitions();
-#else
-  const auto& waiting_partitions = txn.internal().active_partitions();
-#endif
+  const auto& waiting_partitions = config()->lock_manager() == internal::LockManagerType::DDR
+                                       ? txn.internal().involved_partitions()
+                                       : txn.internal().active_partitions();
 
   auto local_region = config()->local_region();
   auto local_replica = config()->local_replica();
@@ -366,9 +478,23 @@ void Worker::BroadcastReads(const RunId& run_id) {
     }
   }
 
+  if (remote_read_coalescer_ != nullptr) {
+    // The worker starting a new round of batches is the one that flushes it
+    if (remote_read_coalescer_->Add(*rrr, destinations)) {
+      NewTimedCallback(config()->remote_read_batch_duration(), [this] { FlushRemoteReads(); });
+    }
+    return;
+  }
+
   Send(env, destinations, MakeTag(run_id));
 }
 
+void Worker::FlushRemoteReads() {
+  for (auto& [dest, env] : remote_read_coalescer_->Flush()) {
+    Send(move(env), dest, kRemoteReadBatchTag);
+  }
+}
+
 TransactionState& Worker::TxnState(const RunId& run_id) {
   auto state_it = txn_states_.find(run_id);
   CHECK(state_it != txn_states_.end());
@@ -389,4 +515,33 @@ void Worker::StopRedirection(const RunId& run_id) {
   Send(move(redirect_env), Broker::MakeChannel(config()->broker_ports_size() - 1));
 }
 
+void Worker::AddTombstone(const RunId& run_id, uint32_t remote_reads_waiting_on) {
+  tombstones_.emplace(run_id, remote_reads_waiting_on);
+  tombstone_order_.push_back(run_id);
+  while (tombstone_order_.size() > kWorkerTombstoneLimit) {
+    // Tombstones that were already cleared by their last remote read are skipped
+    auto& oldest = tombstone_order_.front();
+    if (tombstones_.erase(oldest)) {
+      VLOG(2) << "Evicted tombstone of txn " << oldest;
+      StopRedirection(oldest);
+    }
+    tombstone_order_.pop_front();
+  }
+}
+
+bool Worker::AbsorbLateRemoteRead(const RunId& run_id) {
+  auto it = tombstones_.find(run_id);
+  if (it == tombstones_.end()) {
+    return false;
+  }
+
+  VLOG(3) << "Absorbed late remote read result for txn " << run_id;
+
+  if (--it->second == 0) {
+    tombstones_.erase(it);
+    StopRedirection(run_id);
+  }
+  return true;
+}
+
 }  // namespace slog
\ No newline at end of file
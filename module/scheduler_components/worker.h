@@ -1,5 +1,6 @@
 #pragma once
 
+#include <deque>
 #include <functional>
 #include <optional>
 #include <unordered_map>
@@ -7,10 +8,14 @@
 #include <zmq.hpp>
 
 #include "common/configuration.h"
+#include "common/flat_hash_map.h"
 #include "common/metrics.h"
+#include "common/perf_counter.h"
+#include "common/spsc_queue.h"
 #include "common/types.h"
 #include "execution/execution.h"
 #include "module/base/networked_module.h"
+#include "module/scheduler_components/remote_read_coalescer.h"
 #include "module/scheduler_components/txn_holder.h"
 #include "proto/internal.pb.h"
 #include "proto/transaction.pb.h"
@@ -20,7 +25,30 @@ namespace slog {
 
 using RunId = pair<TxnId, bool>;
 
-const std::string kSchedWorkerAddress = "inproc://sched_worker";
+struct RunIdHash {
+  size_t operator()(const RunId& run_id) const { return (run_id.first << 1) | run_id.second; }
+};
+
+/**
+ * A txn sent by the scheduler to a worker. A speculative dispatch only runs the speculation
+ * of the txn and is followed by a regular dispatch once the txn acquires all of its locks
+ */
+struct WorkerDispatch {
+  TxnHolder* txn_holder;
+  bool deadlocked;
+  bool speculative;
+};
+
+/**
+ * Hand-off queues between the scheduler and a worker. The scheduler sends the txns
+ * to run and the worker sends back the ids of the finished txns
+ */
+struct SchedulerWorkerQueues {
+  SpscQueue<WorkerDispatch> to_worker;
+  SpscQueue<TxnId> to_scheduler;
+  // Fd of the cache-miss counter of the worker thread, which the scheduler reads for stats
+  std::atomic<int> cache_misses_fd = -1;
+};
 
 struct TransactionState {
   enum class Phase { READ_LOCAL_STORAGE, WAIT_REMOTE_READ, EXECUTE, FINISH };
@@ -40,8 +68,13 @@ struct TransactionState {
  */
 class Worker : public NetworkedModule {
  public:
-  Worker(int id, const std::shared_ptr<Broker>& broker, const std::shared_ptr<Storage>& storage,
-         const MetricsRepositoryManagerPtr& metrics_manager,
+  /**
+   * @param remote_read_coalescer Coalescer shared by all workers of the scheduler. If null,
+   *                              remote reads are sent individually
+   */
+  Worker(int id, const std::shared_ptr<SchedulerWorkerQueues>& queues, const std::shared_ptr<Broker>& broker,
+         const std::shared_ptr<Storage>& storage, const MetricsRepositoryManagerPtr& metrics_manager,
+         const std::shared_ptr<RemoteReadCoalescer>& remote_read_coalescer = nullptr,
          std::chrono::milliseconds poll_timeout_ms = kModuleTimeout);
 
   std::string name() const override { return "Worker-" + std::to_string(channel()); }
@@ -76,6 +109,21 @@ class Worker : public NetworkedModule {
    */
   void Execute(const RunId& run_id);
 
+  /**
+   * Reads local storage and executes a private copy of a multi-home txn before all of its
+   * locks are acquired. The writes are kept in the copy instead of being applied to storage
+   */
+  void Speculate(TxnHolder* txn_holder);
+
+  /**
+   * Compares the values read by the speculative run of a txn with the values that the txn
+   * has just read under its locks. If they match, adopts the result of the speculative run
+   * and applies its writes.
+   *
+   * @return false if there is no valid speculative result and the txn must be executed
+   */
+  bool CommitSpeculation(TxnHolder* txn_holder);
+
   /**
    * Returns the result back to the scheduler and cleans up the transaction state
    */
@@ -83,17 +131,56 @@ class Worker : public NetworkedModule {
 
   void BroadcastReads(const RunId& run_id);
 
+  /**
+   * Sends out the remote reads accumulated in the coalescer
+   */
+  void FlushRemoteReads();
+
   // Precondition: txn_id must exists in txn states table
   TransactionState& TxnState(const RunId& run_id);
 
   void StartRedirection(const RunId& run_id);
   void StopRedirection(const RunId& run_id);
 
+  /**
+   * Whether an aborted txn can finish before receiving all of its remote reads. Under DDR, a txn
+   * must stay registered in the lock manager until the deadlock resolver has seen all of its
+   * partitions, and its deadlocked re-runs on other partitions need the reads of this partition,
+   * so every partition waits for all remote reads
+   */
+  bool CanAbortEarly() const { return config()->lock_manager() != internal::LockManagerType::DDR; }
+
+  /**
+   * Remembers a txn that finished before receiving all of its remote reads so
+   * that the late remote reads can be absorbed. The redirection at the broker is
+   * kept until the last remote read arrives or the tombstone is evicted.
+   */
+  void AddTombstone(const RunId& run_id, uint32_t remote_reads_waiting_on);
+
+  /**
+   * Absorbs a late remote read of an early-aborted txn.
+   *
+   * @return false if there is no tombstone for the txn
+   */
+  bool AbsorbLateRemoteRead(const RunId& run_id);
+
   int id_;
+  std::shared_ptr<SchedulerWorkerQueues> queues_;
   std::shared_ptr<Storage> storage_;
+  SharderPtr sharder_;
   std::unique_ptr<Execution> execution_;
-
-  std::map<RunId, TransactionState> txn_states_;
+  // Same as execution_ but never writes to storage. Used for speculative runs
+  std::unique_ptr<Execution> speculative_execution_;
+  std::unique_ptr<PerfCounter> cache_misses_;
+  std::shared_ptr<RemoteReadCoalescer> remote_read_coalescer_;
+
+  // The states are small enough to be stored inline in the table
+  FlatHashMap<RunId, TransactionState, RunIdHash> txn_states_;
+
+  // Number of remote reads still expected for each early-aborted txn
+  std::map<RunId, uint32_t> tombstones_;
+  // Insertion order of the tombstones, used to evict the oldest ones
+  std::deque<RunId> tombstone_order_;
 };
 
 }  // namespace slog
\ No newline at end of file
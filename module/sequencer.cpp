@@ -17,13 +17,43 @@ using internal::Batch;
 using internal::Request;
 using std::chrono::milliseconds;
 
+namespace {
+
+// How often the number of late multi-home txns is written to the metrics
+const milliseconds kLateArrivalReportInterval(1000);
+
+}  // namespace
+
 Sequencer::Sequencer(const std::shared_ptr<zmq::context_t>& context, const ConfigurationPtr& config,
-                     const MetricsRepositoryManagerPtr& metrics_manager, milliseconds poll_timeout)
+                     const MetricsRepositoryManagerPtr& metrics_manager, milliseconds poll_timeout,
+                     const std::shared_ptr<LogManagerBacklog>& log_manager_backlog)
     : NetworkedModule(context, config, config->sequencer_port(), kSequencerChannel, metrics_manager, poll_timeout),
-      batcher_(std::make_shared<Batcher>(context, config, metrics_manager, poll_timeout)),
-      batcher_runner_(std::static_pointer_cast<Module>(batcher_)) {}
+      batcher_(std::make_shared<Batcher>(context, config, metrics_manager, poll_timeout, log_manager_backlog)),
+      batcher_runner_(std::static_pointer_cast<Module>(batcher_)),
+      late_arrivals_(config->num_regions()) {}
 
-void Sequencer::Initialize() { batcher_runner_.StartInNewThread(); }
+void Sequencer::Initialize() {
+  batcher_runner_.StartInNewThread();
+  if (config()->bypass_mh_orderer() && config()->synchronized_batching()) {
+    ScheduleNextLateArrivalReport();
+  }
+}
+
+void Sequencer::ScheduleNextLateArrivalReport() {
+  NewTimedCallback(kLateArrivalReportInterval, [this] {
+    if (per_thread_metrics_repo != nullptr) {
+      auto now = slog_clock::now().time_since_epoch().count();
+      const auto& counts = late_arrivals_.counts();
+      for (size_t r = 0; r < counts.size(); r++) {
+        if (counts[r].num_txns > 0) {
+          per_thread_metrics_repo->RecordLateArrivals(now, r, counts[r].num_txns, counts[r].num_late_txns);
+        }
+      }
+    }
+    late_arrivals_.Reset();
+    ScheduleNextLateArrivalReport();
+  });
+}
 
 void Sequencer::OnInternalRequestReceived(EnvelopePtr&& env) {
   auto request = env->mutable_request();
@@ -57,15 +87,16 @@ void Sequencer::ProcessForwardRequest(EnvelopePtr&& env) {
   }
 
   if (config()->bypass_mh_orderer() && config()->synchronized_batching()) {
+    late_arrivals_.Count(*txn, GET_REGION_ID(env->from()), now);
     if (txn_internal->timestamp() <= now) {
       VLOG(2) << "Txn " << TXN_ID_STR(txn_internal->id()) << " has a timestamp "
               << (now - txn_internal->timestamp()) / 1000 << " us in the past";
 
-#if !defined(LOCK_MANAGER_DDR)
       // If not using DDR, restart the transaction
-      txn->set_status(TransactionStatus::ABORTED);
-      txn->set_abort_code(AbortCode::RESTARTED);
-#endif
+      if (config()->lock_manager() != internal::LockManagerType::DDR) {
+        txn->set_status(TransactionStatus::ABORTED);
+        txn->set_abort_code(AbortCode::RESTARTED);
+      }
     } else {
       VLOG(2) << "Txn " << TXN_ID_STR(txn_internal->id()) << " has a timestamp "
               << (txn_internal->timestamp() - now) / 1000 << " us into the future";
@@ -73,15 +104,8 @@ void Sequencer::ProcessForwardRequest(EnvelopePtr&& env) {
       RECORD_WITH_TIME(txn_internal, TransactionEvent::EXPECTED_WAIT_TIME_UNTIL_ENTER_LOCAL_BATCH,
                        txn_internal->timestamp() - now);
     }
-    // Put into a sorted buffer and wait until local clock reaches the txn's timestamp.
-    // Send a signal to the batcher if the earliest time in the buffer has changed, so that
-    // the batcher is rescheduled to wake up at this ealier time
-    bool signal_needed = batcher_->BufferFutureTxn(env->mutable_request()->mutable_forward_txn()->release_txn());
-    if (signal_needed) {
-      auto env = NewEnvelope();
-      env->mutable_request()->mutable_signal();
-      Send(move(env), kBatcherChannel);
-    }
+    // Hand over to the batcher, which buffers the txn until the local clock reaches its timestamp
+    batcher_->BufferFutureTxn(env->mutable_request()->mutable_forward_txn()->release_txn());
   } else {
     // Put to batch immediately
     txn_internal->set_mh_enter_local_batch_time(now);
@@ -10,6 +10,7 @@
 #include "connection/broker.h"
 #include "module/base/networked_module.h"
 #include "module/sequencer_components/batcher.h"
+#include "module/sequencer_components/late_arrival_counter.h"
 
 namespace slog {
 
@@ -29,7 +30,8 @@ class Sequencer : public NetworkedModule {
  public:
   Sequencer(const std::shared_ptr<zmq::context_t>& context, const ConfigurationPtr& config,
             const MetricsRepositoryManagerPtr& metrics_manager,
-            std::chrono::milliseconds poll_timeout = kModuleTimeout);
+            std::chrono::milliseconds poll_timeout = kModuleTimeout,
+            const std::shared_ptr<LogManagerBacklog>& log_manager_backlog = nullptr);
 
   std::string name() const override { return "Sequencer"; }
 
@@ -40,9 +42,13 @@ class Sequencer : public NetworkedModule {
  private:
   void ProcessForwardRequest(EnvelopePtr&& env);
   void ProcessPingRequest(EnvelopePtr&& env);
+  void ScheduleNextLateArrivalReport();
 
   std::shared_ptr<Batcher> batcher_;
   ModuleRunner batcher_runner_;
+
+  // Multi-home txns arriving with synchronized batching
+  LateArrivalCounter late_arrivals_;
 };
 
 }  // namespace slog
\ No newline at end of file
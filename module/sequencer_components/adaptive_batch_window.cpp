@@ -0,0 +1,44 @@
+#include "module/sequencer_components/adaptive_batch_window.h"
+
+#include <algorithm>
+
+namespace slog {
+
+namespace {
+// Weight of the newest sample in the smoothed arrival rate
+const double kArrivalRateWeight = 0.2;
+const double kGrowFactor = 1.5;
+const double kShrinkFactor = 0.8;
+}  // namespace
+
+AdaptiveBatchWindow::AdaptiveBatchWindow(std::chrono::microseconds min_window, std::chrono::microseconds max_window,
+                                         int64_t target_backlog, int max_batch_size)
+    : min_window_us_(std::max<double>(min_window.count(), 1)),
+      max_window_us_(std::max<double>(max_window.count(), min_window_us_)),
+      target_backlog_(target_backlog),
+      max_batch_size_(max_batch_size),
+      window_us_(min_window_us_),
+      arrival_rate_(0) {}
+
+void AdaptiveBatchWindow::Update(size_t batch_size, std::chrono::nanoseconds elapsed, int64_t backlog) {
+  if (elapsed.count() > 0) {
+    double rate = batch_size * 1e9 / elapsed.count();
+    arrival_rate_ = arrival_rate_ == 0 ? rate : kArrivalRateWeight * rate + (1 - kArrivalRateWeight) * arrival_rate_;
+  }
+
+  // Grow above the target backlog and shrink below half of it. The band in between avoids
+  // oscillating around the target
+  if (backlog > target_backlog_) {
+    window_us_ *= kGrowFactor;
+  } else if (2 * backlog < target_backlog_) {
+    window_us_ *= kShrinkFactor;
+  }
+
+  if (max_batch_size_ > 0 && arrival_rate_ > 0) {
+    window_us_ = std::min(window_us_, max_batch_size_ * 1e6 / arrival_rate_);
+  }
+
+  window_us_ = std::clamp(window_us_, min_window_us_, max_window_us_);
+}
+
+}  // namespace slog
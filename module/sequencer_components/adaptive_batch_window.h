@@ -0,0 +1,52 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+
+namespace slog {
+
+/**
+ * Chooses how long the batcher waits before closing a batch. The window stays at its lower
+ * bound while the log managers keep up so that txns do not wait longer than necessary. When
+ * the txns pile up in the log managers beyond the target backlog, the window grows so that the
+ * per-batch cost of Paxos and the log managers is amortized over more txns, and it shrinks
+ * back once the backlog is drained.
+ *
+ * The window is also capped at the time it takes to fill a batch of the max batch size at the
+ * observed arrival rate, since a longer window only produces more batches of the max size.
+ */
+class AdaptiveBatchWindow {
+ public:
+  /**
+   * @param min_window     Lower bound of the window
+   * @param max_window     Upper bound of the window
+   * @param target_backlog Number of txns buffered in the log managers to aim for
+   * @param max_batch_size Max number of txns in a batch. 0 means unlimited
+   */
+  AdaptiveBatchWindow(std::chrono::microseconds min_window, std::chrono::microseconds max_window,
+                      int64_t target_backlog, int max_batch_size);
+
+  /**
+   * Adjusts the window after closing a batch
+   *
+   * @param batch_size Number of txns in the batch
+   * @param elapsed    Time since the first txn of the batch arrived
+   * @param backlog    Current number of txns buffered in the log managers
+   */
+  void Update(size_t batch_size, std::chrono::nanoseconds elapsed, int64_t backlog);
+
+  std::chrono::microseconds window() const { return std::chrono::microseconds(static_cast<int64_t>(window_us_)); }
+
+  // Smoothed arrival rate in txns per second
+  double arrival_rate() const { return arrival_rate_; }
+
+ private:
+  const double min_window_us_;
+  const double max_window_us_;
+  const int64_t target_backlog_;
+  const int max_batch_size_;
+  double window_us_;
+  double arrival_rate_;
+};
+
+}  // namespace slog
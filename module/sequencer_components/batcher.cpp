@@ -1,9 +1,10 @@
 #include "module/sequencer_components/batcher.h"
 
+#include <algorithm>
+
 #include "common/clock.h"
 #include "common/json_utils.h"
 #include "common/proto_utils.h"
-#include "module/log_manager.h"
 
 using namespace std::chrono;
 
@@ -12,24 +13,31 @@ namespace slog {
 using internal::Batch;
 using internal::Request;
 
+namespace {
+// Future txns are buffered in microsecond slots
+uint64_t ToTick(int64_t timestamp) { return duration_cast<microseconds>(nanoseconds(timestamp)).count(); }
+}  // namespace
+
 Batcher::Batcher(const std::shared_ptr<zmq::context_t>& context, const ConfigurationPtr& config,
-                 const MetricsRepositoryManagerPtr& metrics_manager, milliseconds poll_timeout)
+                 const MetricsRepositoryManagerPtr& metrics_manager, milliseconds poll_timeout,
+                 const std::shared_ptr<LogManagerBacklog>& log_manager_backlog)
     : NetworkedModule(context, config, kBatcherChannel, metrics_manager, poll_timeout, true /* is_long_sender */),
       sharder_(Sharder::MakeSharder(config)),
+      future_txns_(ToTick(slog_clock::now().time_since_epoch().count())),
+      process_future_txn_callback_tick_(0),
       batch_id_counter_(0),
+      log_manager_backlog_(log_manager_backlog),
       rg_(std::random_device()()) {
+  if (config->adaptive_sequencer_batching()) {
+    adaptive_batch_window_.emplace(config->sequencer_min_batch_duration(), config->sequencer_max_batch_duration(),
+                                   config->sequencer_target_backlog(), config->sequencer_batch_size());
+  }
   StartOver();
 }
 
-bool Batcher::BufferFutureTxn(Transaction* txn) {
-  auto timestamp = std::make_pair(txn->internal().timestamp(), txn->internal().id());
+void Batcher::BufferFutureTxn(Transaction* txn) { future_txn_queue_.Push(txn); }
 
-  std::lock_guard<SpinLatch> guard(future_txns_mut_);
-  bool earliest_txn_changed = future_txns_.empty() || txn->internal().timestamp() < future_txns_.begin()->first.first;
-  auto res = future_txns_.emplace(timestamp, txn);
-  CHECK(res.second) << "Conflicting timestamps: (" << timestamp.first << ", " << timestamp.second << ")";
-  return earliest_txn_changed;
-}
+void Batcher::Initialize() { AddCustomEventFd(future_txn_queue_.notify_fd()); }
 
 void Batcher::OnInternalRequestReceived(EnvelopePtr&& env) {
   auto request = env->mutable_request();
@@ -37,13 +45,6 @@ void Batcher::OnInternalRequestReceived(EnvelopePtr&& env) {
     case Request::kForwardTxn:
       BatchTxn(env->mutable_request()->mutable_forward_txn()->release_txn());
       break;
-    case Request::kSignal: {
-      if (process_future_txn_callback_handle_.has_value()) {
-        RemoveTimedCallback(process_future_txn_callback_handle_.value());
-      }
-      ProcessReadyFutureTxns();
-      break;
-    }
     case Request::kStats:
       ProcessStatsRequest(request->stats());
       break;
@@ -53,36 +54,63 @@ void Batcher::OnInternalRequestReceived(EnvelopePtr&& env) {
   }
 }
 
-void Batcher::ProcessReadyFutureTxns() {
-  auto now = slog_clock::now().time_since_epoch().count();
-
-  std::optional<int64_t> earliest_timestamp;
-  std::vector<Transaction*> ready_txns;
-  {
-    std::lock_guard<SpinLatch> guard(future_txns_mut_);
-    auto it = future_txns_.begin();
-    for (; it != future_txns_.end(); it++) {
-      if (it->first.first > now) {
-        break;
-      }
-      ready_txns.push_back(it->second);
-    }
-    future_txns_.erase(future_txns_.begin(), it);
-    if (!future_txns_.empty()) {
-      earliest_timestamp = future_txns_.begin()->first.first;
-    }
+bool Batcher::OnCustomSocket() {
+  Transaction* txn;
+  bool received = false;
+  while (future_txn_queue_.Pop(txn)) {
+    future_txns_.Insert(ToTick(txn->internal().timestamp()), txn);
+    received = true;
   }
+  if (received) {
+    ProcessReadyFutureTxns();
+  }
+  return received;
+}
 
-  for (auto txn : ready_txns) {
+void Batcher::ProcessReadyFutureTxns() {
+  auto now = slog_clock::now().time_since_epoch().count();
+  auto now_tick = ToTick(now);
+
+  std::vector<TimingWheel<Transaction*>::Entry> ready_txns;
+  future_txns_.Advance(now_tick, ready_txns);
+  // Txns in the same slot are ordered by their full timestamps
+  std::sort(ready_txns.begin(), ready_txns.end(), [](const auto& a, const auto& b) {
+    const auto& a_internal = a.second->internal();
+    const auto& b_internal = b.second->internal();
+    return std::make_pair(a_internal.timestamp(), a_internal.id()) <
+           std::make_pair(b_internal.timestamp(), b_internal.id());
+  });
+
+  for (auto& [_, txn] : ready_txns) {
     txn->mutable_internal()->set_mh_enter_local_batch_time(now);
     BatchTxn(txn);
   }
 
-  process_future_txn_callback_handle_.reset();
-  if (earliest_timestamp.has_value()) {
-    auto delay = duration_cast<microseconds>(nanoseconds(earliest_timestamp.value() - now)) + 1us;
-    process_future_txn_callback_handle_ = NewTimedCallback(delay, [this]() { ProcessReadyFutureTxns(); });
+  auto next_tick = future_txns_.NextTick();
+  if (!next_tick.has_value()) {
+    return;
+  }
+  // Keep the scheduled callback if it wakes up early enough
+  if (process_future_txn_callback_handle_.has_value()) {
+    if (process_future_txn_callback_tick_ <= next_tick.value()) {
+      return;
+    }
+    RemoveTimedCallback(process_future_txn_callback_handle_.value());
+  }
+  // Wake up right after the slot of the next tick has passed
+  auto delay = microseconds(next_tick.value() + 1 - now_tick);
+  process_future_txn_callback_tick_ = next_tick.value();
+  process_future_txn_callback_handle_ = NewTimedCallback(delay, [this]() {
+    process_future_txn_callback_handle_.reset();
+    ProcessReadyFutureTxns();
+  });
+}
+
+microseconds Batcher::batch_window() const {
+  if (adaptive_batch_window_.has_value()) {
+    return adaptive_batch_window_->window();
   }
+  return config()->sequencer_batch_duration();
 }
 
 BatchId Batcher::batch_id() const { return (batch_id_counter_ << kMachineIdBits) | config()->local_machine_id(); }
@@ -130,7 +158,7 @@ void Batcher::BatchTxn(Transaction* txn) {
 
   // If this is the first txn after starting over, schedule to send the batch at a later time
   if (total_batch_size_ == 1) {
-    NewTimedCallback(config()->sequencer_batch_duration(), [this]() {
+    NewTimedCallback(batch_window(), [this]() {
       SendBatches();
       StartOver();
     });
@@ -149,9 +177,18 @@ void Batcher::SendBatches() {
           << " txns to be replicated. "
           << "Sending out for ordering and replicating";
 
+  auto elapsed = std::chrono::steady_clock::now() - batch_starting_time_;
   if (per_thread_metrics_repo != nullptr) {
-    per_thread_metrics_repo->RecordSequencerBatch(batch_id(), total_batch_size_,
-                                                  (std::chrono::steady_clock::now() - batch_starting_time_).count());
+    per_thread_metrics_repo->RecordSequencerBatch(batch_id(), total_batch_size_, elapsed.count(),
+                                                  duration_cast<nanoseconds>(batch_window()).count());
+  }
+
+  if (adaptive_batch_window_.has_value()) {
+    int64_t backlog = log_manager_backlog_ != nullptr ? log_manager_backlog_->load(std::memory_order_relaxed) : 0;
+    adaptive_batch_window_->Update(total_batch_size_, elapsed, backlog);
+
+    VLOG(1) << "Batch window: " << adaptive_batch_window_->window().count()
+            << " us. Arrival rate: " << adaptive_batch_window_->arrival_rate() << " txn/s. Backlog: " << backlog;
   }
 
   auto local_region = config()->local_region();
@@ -171,23 +208,24 @@ void Batcher::SendBatches() {
     paxos_propose->set_value(local_machine_id);
     Send(move(paxos_env), kLocalPaxos);
 
-    // Distribute the batch data to other partitions in the same replica
-    std::vector<internal::Batch*> batch_partitions;
+    // Serialize each batch partition once. The serialized partitions are reused in the messages
+    // to the local partitions and in the message to other regions and replicas
+    std::vector<std::string> serialized_partitions(num_partitions);
+    std::vector<std::string_view> batch_data(num_partitions);
     for (int p = 0; p < num_partitions; p++) {
-      auto batch_partition = batch[p].release();
-
-      RECORD(batch_partition, TransactionEvent::EXIT_SEQUENCER_IN_BATCH);
+      RECORD(batch[p].get(), TransactionEvent::EXIT_SEQUENCER_IN_BATCH);
+      serialized_partitions[p] = batch[p]->SerializeAsString();
+      batch_data[p] = serialized_partitions[p];
+    }
 
-      auto env = NewBatchForwardingMessage({batch_partition}, generator_position);
-      Send(*env, MakeMachineId(local_region, local_replica, p), LogManager::MakeLogChannel(local_region));
-      // Collect back the batch partition to send to other regions
-      batch_partitions.push_back(
-          env->mutable_request()->mutable_forward_batch_data()->mutable_batch_data()->ReleaseLast());
+    // Distribute the batch data to other partitions in the same replica
+    for (int p = 0; p < num_partitions; p++) {
+      Send(SerializeForwardBatchData({batch_data[p]}, local_machine_id, generator_position, config()->wire_format()),
+           MakeMachineId(local_region, local_replica, p), LogManager::MakeLogChannel(local_region));
     }
 
     // Distribute the batch data to other regions and other replicas in the local region.
     // All partitions of current batch are contained in a single message
-    auto env = NewBatchForwardingMessage(move(batch_partitions), generator_position);
     std::vector<MachineId> destinations;
     destinations.reserve(num_regions);
     for (int reg = 0; reg < num_regions; reg++) {
@@ -222,34 +260,26 @@ void Batcher::SendBatches() {
 
         VLOG(1) << "Delay batch " << TXN_ID_STR(batch_id) << " for " << delay_ms << " ms";
 
-        NewTimedCallback(milliseconds(delay_ms),
-                         [this, destinations, local_region, batch_id, delayed_env = env.release()]() {
-                           VLOG(1) << "Sending delayed batch " << TXN_ID_STR(batch_id);
-                           Send(*delayed_env, destinations, LogManager::MakeLogChannel(local_region));
-                           delete delayed_env;
-                         });
+        auto delayed_msg = std::make_shared<zmq::message_t>(
+            SerializeForwardBatchData(batch_data, local_machine_id, generator_position, config()->wire_format()));
+        NewTimedCallback(milliseconds(delay_ms), [this, destinations, local_region, batch_id, delayed_msg]() {
+          VLOG(1) << "Sending delayed batch " << TXN_ID_STR(batch_id);
+          Send(std::move(*delayed_msg), destinations, LogManager::MakeLogChannel(local_region));
+        });
 
         return;
       }
     }
 
-    Send(*env, destinations, LogManager::MakeLogChannel(local_region));
+    if (!destinations.empty()) {
+      Send(SerializeForwardBatchData(batch_data, local_machine_id, generator_position, config()->wire_format()),
+           destinations, LogManager::MakeLogChannel(local_region));
+    }
 
     generator_position++;
   }
 }
 
-EnvelopePtr Batcher::NewBatchForwardingMessage(std::vector<internal::Batch*>&& batch, int generator_position) {
-  auto env = NewEnvelope();
-  auto forward_batch = env->mutable_request()->mutable_forward_batch_data();
-  forward_batch->set_generator(config()->local_machine_id());
-  forward_batch->set_generator_position(generator_position);
-  for (auto b : batch) {
-    forward_batch->mutable_batch_data()->AddAllocated(b);
-  }
-  return env;
-}
-
 /**
  * {
  *    seq_num_future_txns: int,
@@ -274,21 +304,15 @@ void Batcher::ProcessStatsRequest(const internal::StatsRequest& stats_request) {
     stats.AddMember(StringRef(SEQ_PROCESS_FUTURE_TXN_CALLBACK_ID), -1, alloc);
   }
   stats.AddMember(StringRef(SEQ_BATCH_SIZE), total_batch_size_, alloc);
-  {
-    std::lock_guard<SpinLatch> guard(future_txns_mut_);
-    stats.AddMember(StringRef(SEQ_NUM_FUTURE_TXNS), future_txns_.size(), alloc);
-    if (level > 0) {
-      stats.AddMember(StringRef(SEQ_FUTURE_TXNS),
-                      ToJsonArray(
-                          future_txns_,
-                          [&alloc](const std::pair<Timestamp, Transaction*>& item) {
-                            rapidjson::Value entry(rapidjson::kArrayType);
-                            entry.PushBack(item.first.first, alloc).PushBack(item.second->internal().id(), alloc);
-                            return entry;
-                          },
-                          alloc),
-                      alloc);
-    }
+  stats.AddMember(StringRef(SEQ_NUM_FUTURE_TXNS), future_txns_.size(), alloc);
+  if (level > 0) {
+    rapidjson::Value future_txns(rapidjson::kArrayType);
+    future_txns_.ForEach([&future_txns, &alloc](const TimingWheel<Transaction*>::Entry& item) {
+      rapidjson::Value entry(rapidjson::kArrayType);
+      entry.PushBack(item.second->internal().timestamp(), alloc).PushBack(item.second->internal().id(), alloc);
+      future_txns.PushBack(std::move(entry), alloc);
+    });
+    stats.AddMember(StringRef(SEQ_FUTURE_TXNS), std::move(future_txns), alloc);
   }
 
   // Write JSON object to a buffer and send back to the server
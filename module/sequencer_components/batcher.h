@@ -1,29 +1,38 @@
 #pragma once
 
-#include <map>
-#include <mutex>
-
+#include "common/mpsc_queue.h"
 #include "common/sharder.h"
-#include "common/spin_latch.h"
+#include "common/timing_wheel.h"
 #include "module/base/networked_module.h"
+#include "module/log_manager.h"
+#include "module/sequencer_components/adaptive_batch_window.h"
 
 namespace slog {
 
 class Batcher : public NetworkedModule {
  public:
+  /**
+   * @param log_manager_backlog Backlog of the local log managers, used to adjust the batch
+   *                            window if adaptive batching is enabled. Can be null
+   */
   Batcher(const std::shared_ptr<zmq::context_t>& context, const ConfigurationPtr& config,
-          const MetricsRepositoryManagerPtr& metrics_manager, std::chrono::milliseconds poll_timeout);
+          const MetricsRepositoryManagerPtr& metrics_manager, std::chrono::milliseconds poll_timeout,
+          const std::shared_ptr<LogManagerBacklog>& log_manager_backlog = nullptr);
 
-  // Returns true if the earliest time has changed
-  bool BufferFutureTxn(Transaction* txn);
+  /**
+   * Hands a txn with a future timestamp over to the batcher, which batches it once the local
+   * clock reaches that timestamp. Can be called from any thread
+   */
+  void BufferFutureTxn(Transaction* txn);
 
   std::string name() const override { return "Batcher"; }
 
  protected:
+  void Initialize() final;
   void OnInternalRequestReceived(EnvelopePtr&& env) final;
+  bool OnCustomSocket() final;
 
  private:
-  using Timestamp = std::pair<int64_t, TxnId>;
   using PartitionedBatch = std::vector<std::unique_ptr<internal::Batch>>;
 
   void ProcessReadyFutureTxns();
@@ -32,14 +41,16 @@ class Batcher : public NetworkedModule {
   void BatchTxn(Transaction* txn);
   BatchId batch_id() const;
   void SendBatches();
-  EnvelopePtr NewBatchForwardingMessage(std::vector<internal::Batch*>&& batch, int generator_position);
+  std::chrono::microseconds batch_window() const;
 
   void ProcessStatsRequest(const internal::StatsRequest& stats_request);
 
   const SharderPtr sharder_;
-  SpinLatch future_txns_mut_;
-  std::map<Timestamp, Transaction*> future_txns_;
+  MpscQueue<Transaction*> future_txn_queue_;
+  // Future txns keyed by their timestamps in microseconds. Owned by the batcher thread
+  TimingWheel<Transaction*> future_txns_;
   std::optional<Poller::Handle> process_future_txn_callback_handle_;
+  uint64_t process_future_txn_callback_tick_;
 
   std::vector<PartitionedBatch> batches_;
   BatchId batch_id_counter_;
@@ -48,6 +59,9 @@ class Batcher : public NetworkedModule {
 
   std::chrono::steady_clock::time_point batch_starting_time_;
 
+  std::shared_ptr<LogManagerBacklog> log_manager_backlog_;
+  std::optional<AdaptiveBatchWindow> adaptive_batch_window_;
+
   std::mt19937 rg_;
 };
 
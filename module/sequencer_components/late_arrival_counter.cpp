@@ -0,0 +1,22 @@
+#include "module/sequencer_components/late_arrival_counter.h"
+
+#include <algorithm>
+
+namespace slog {
+
+LateArrivalCounter::LateArrivalCounter(int num_regions) : counts_(num_regions) {}
+
+void LateArrivalCounter::Count(const Transaction& txn, RegionId from, int64_t now) {
+  if (txn.internal().type() != TransactionType::MULTI_HOME_OR_LOCK_ONLY) {
+    return;
+  }
+  auto& counts = counts_[from];
+  counts.num_txns++;
+  if (txn.internal().timestamp() <= now) {
+    counts.num_late_txns++;
+  }
+}
+
+void LateArrivalCounter::Reset() { std::fill(counts_.begin(), counts_.end(), Counts()); }
+
+}  // namespace slog
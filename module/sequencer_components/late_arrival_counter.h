@@ -0,0 +1,40 @@
+#pragma once
+
+#include <cstdint>
+#include <vector>
+
+#include "common/types.h"
+#include "proto/transaction.pb.h"
+
+namespace slog {
+
+/**
+ * Counts the multi-home txns that reach the sequencer after their timestamp, per coordinating
+ * region. Only multi-home txns are given a timestamp by the forwarder, so the other txns are not
+ * counted.
+ */
+class LateArrivalCounter {
+ public:
+  struct Counts {
+    uint64_t num_txns = 0;
+    uint64_t num_late_txns = 0;
+  };
+
+  explicit LateArrivalCounter(int num_regions);
+
+  /**
+   * @param txn  The arriving txn
+   * @param from Region of the machine that sent the txn
+   * @param now  Arrival time in nanoseconds since the epoch of the slog clock
+   */
+  void Count(const Transaction& txn, RegionId from, int64_t now);
+
+  const std::vector<Counts>& counts() const { return counts_; }
+
+  void Reset();
+
+ private:
+  std::vector<Counts> counts_;
+};
+
+}  // namespace slog
@@ -56,7 +56,15 @@ Server::Server(const std::shared_ptr<Broker>& broker, const MetricsRepositoryMan
                std::chrono::milliseconds poll_timeout)
     : NetworkedModule(broker, kServerChannel, metrics_manager, poll_timeout),
       rate_limiter_(config()->tps_limit()),
-      txn_id_counter_(0) {}
+      txn_id_counter_(0),
+      num_in_flight_txns_(0),
+      num_shed_txns_(0) {}
+
+Server::~Server() {
+  for (auto txn : admission_queue_) {
+    delete txn;
+  }
+}
 
 /***********************************************
                 Initialization
@@ -140,14 +148,20 @@ bool Server::OnCustomSocket() {
         break;
       }
 
-      PreprocessTxn(txn);
-
-      RECORD(txn_internal, TransactionEvent::EXIT_SERVER_TO_FORWARDER);
+      // Txns wait behind the ones already waiting so that they are admitted in order
+      if (!admission_queue_.empty() || !HasAdmissionCredit()) {
+        if (admission_queue_.size() >= config()->server_admission_queue_size()) {
+          num_shed_txns_++;
+          txn->set_status(TransactionStatus::ABORTED);
+          txn->set_abort_code(AbortCode::RATE_LIMITED);
+          SendTxnToClient(txn);
+          break;
+        }
+        admission_queue_.push_back(txn);
+        break;
+      }
 
-      // Send to forwarder
-      auto env = NewEnvelope();
-      env->mutable_request()->mutable_forward_txn()->set_allocated_txn(txn);
-      Send(move(env), kForwarderChannel);
+      AdmitTxn(txn);
       break;
     }
     case api::Request::kStats: {
@@ -235,6 +249,36 @@ void Server::ProcessFinishedSubtxn(EnvelopePtr&& env) {
   if (finished_txn.AddSubTxn(std::move(env), part)) {
     SendTxnToClient(finished_txn.ReleaseTxn());
     finished_txns_.erase(txn_id);
+
+    // The finished txn returns its credit
+    num_in_flight_txns_--;
+    AdmitWaitingTxns();
+  }
+}
+
+bool Server::HasAdmissionCredit() const {
+  auto max_in_flight_txns = config()->server_max_in_flight_txns();
+  return max_in_flight_txns == 0 || num_in_flight_txns_ < max_in_flight_txns;
+}
+
+void Server::AdmitTxn(Transaction* txn) {
+  PreprocessTxn(txn);
+
+  RECORD(txn->mutable_internal(), TransactionEvent::EXIT_SERVER_TO_FORWARDER);
+
+  num_in_flight_txns_++;
+
+  // Send to forwarder
+  auto env = NewEnvelope();
+  env->mutable_request()->mutable_forward_txn()->set_allocated_txn(txn);
+  Send(move(env), kForwarderChannel);
+}
+
+void Server::AdmitWaitingTxns() {
+  while (!admission_queue_.empty() && HasAdmissionCredit()) {
+    auto txn = admission_queue_.front();
+    admission_queue_.pop_front();
+    AdmitTxn(txn);
   }
 }
 
@@ -251,6 +295,9 @@ void Server::ProcessStatsRequest(const internal::StatsRequest& stats_request) {
   stats.AddMember(StringRef(TXN_ID_COUNTER), txn_id_counter_, alloc);
   stats.AddMember(StringRef(NUM_PENDING_RESPONSES), pending_responses_.size(), alloc);
   stats.AddMember(StringRef(NUM_PARTIALLY_FINISHED_TXNS), finished_txns_.size(), alloc);
+  stats.AddMember(StringRef(NUM_IN_FLIGHT_TXNS), num_in_flight_txns_, alloc);
+  stats.AddMember(StringRef(NUM_TXNS_WAITING_FOR_ADMISSION), admission_queue_.size(), alloc);
+  stats.AddMember(StringRef(NUM_SHED_TXNS), num_shed_txns_, alloc);
   if (level >= 1) {
     stats.AddMember(StringRef(PENDING_RESPONSES),
                     ToJsonArrayOfKeyValue(
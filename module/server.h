@@ -3,6 +3,7 @@
 #include <glog/logging.h>
 
 #include <chrono>
+#include <deque>
 #include <set>
 #include <thread>
 #include <unordered_map>
@@ -29,11 +30,16 @@ namespace slog {
  * OUTPUT: For external TransactionRequest, it forwards the txn internally
  *         to appropriate modules and waits for internal responses before
  *         responding back to the client with an external TransactionResponse.
+ *
+ * The number of txns that a server has in the system is bounded by server_max_in_flight_txns.
+ * A finished txn returns its credit, letting in the txns that wait for admission. A txn
+ * arriving when the admission queue is full is aborted as rate limited.
  */
 class Server : public NetworkedModule {
  public:
   Server(const std::shared_ptr<Broker>& broker, const MetricsRepositoryManagerPtr& metrics_manager,
          std::chrono::milliseconds poll_timeout = kModuleTimeout);
+  ~Server();
 
   std::string name() const override { return "Server"; }
 
@@ -60,11 +66,21 @@ class Server : public NetworkedModule {
   void SendTxnToClient(Transaction* txn);
   void SendResponseToClient(TxnId txn_id, api::Response&& res);
 
+  bool HasAdmissionCredit() const;
+  void AdmitTxn(Transaction* txn);
+  void AdmitWaitingTxns();
+
   TxnId NextTxnId();
 
   RateLimiter rate_limiter_;
   TxnId txn_id_counter_;
 
+  // Number of txns sent into the system that have not finished
+  uint32_t num_in_flight_txns_;
+  // Txns waiting for a credit to be admitted
+  std::deque<Transaction*> admission_queue_;
+  uint64_t num_shed_txns_;
+
   struct PendingResponse {
     zmq::message_t identity;
     uint32_t stream_id;
@@ -1,5 +1,8 @@
 #include "paxos/acceptor.h"
 
+#include <glog/logging.h>
+
+#include "common/metrics.h"
 #include "paxos/simulated_multi_paxos.h"
 
 namespace slog {
@@ -8,16 +11,29 @@ using internal::Envelope;
 using internal::Request;
 using internal::Response;
 
-Acceptor::Acceptor(SimulatedMultiPaxos& sender) : sender_(sender), ballot_(0) {}
+Acceptor::Acceptor(SimulatedMultiPaxos& sender, MachineId me, const internal::PaxosDurability& durability)
+    : sender_(sender), ballot_(0), recovered_next_slot_(0), group_fsync_(durability.group_fsync_us()) {
+  if (durability.log_dir().empty()) {
+    return;
+  }
+  auto path = durability.log_dir() + "/paxos_" + std::to_string(sender_.channel()) + "_" + std::to_string(me) + ".log";
+  std::vector<AcceptorLog::Record> recovered;
+  log_ = std::make_unique<AcceptorLog>(path, recovered);
+  for (const auto& record : recovered) {
+    ballot_ = std::max(ballot_, record.ballot);
+    recovered_next_slot_ = std::max<SlotId>(recovered_next_slot_, record.slot + record.values.size());
+  }
+  if (!recovered.empty()) {
+    LOG(INFO) << "Recovered " << recovered.size() << " records from acceptor log \"" << path
+              << "\". Ballot: " << ballot_ << ". Next slot: " << recovered_next_slot_;
+  }
+}
 
 void Acceptor::HandleRequest(const internal::Envelope& req) {
   switch (req.request().type_case()) {
     case Request::TypeCase::kPaxosAccept:
       ProcessAcceptRequest(req.request().paxos_accept(), req.from());
       break;
-    case Request::TypeCase::kPaxosCommit:
-      ProcessCommitRequest(req.request().paxos_commit(), req.from());
-      break;
     default:
       break;
   }
@@ -28,6 +44,23 @@ void Acceptor::ProcessAcceptRequest(const internal::PaxosAcceptRequest& req, Mac
     return;
   }
   ballot_ = req.ballot();
+
+  if (log_ != nullptr) {
+    // The response is only sent once the accepted values are on disk
+    if (pending_responses_.empty()) {
+      group_start_time_ = std::chrono::steady_clock::now();
+      if (group_fsync_.count() > 0) {
+        sender_.NewTimedCallback(group_fsync_, [this] { SyncLog(); });
+      }
+    }
+    log_->Append(req);
+    pending_responses_.emplace_back(req.slot(), from_machine_id);
+    if (group_fsync_.count() == 0) {
+      SyncLog();
+    }
+    return;
+  }
+
   auto env = sender_.NewEnvelope();
   auto accept_response = env->mutable_response()->mutable_paxos_accept();
   accept_response->set_ballot(ballot_);
@@ -35,13 +68,32 @@ void Acceptor::ProcessAcceptRequest(const internal::PaxosAcceptRequest& req, Mac
   sender_.SendSameChannel(move(env), from_machine_id);
 }
 
-void Acceptor::ProcessCommitRequest(const internal::PaxosCommitRequest& req, MachineId from_machine_id) {
-  // TODO: If leader election is implemented, this is where we erase
-  //       memory about an accepted value
-  auto env = sender_.NewEnvelope();
-  auto commit_response = env->mutable_response()->mutable_paxos_commit();
-  commit_response->set_slot(req.slot());
-  sender_.SendSameChannel(move(env), from_machine_id);
+void Acceptor::SyncLog() {
+  if (pending_responses_.empty()) {
+    return;
+  }
+  auto num_records = log_->num_buffered_records();
+  auto sync_start_time = std::chrono::steady_clock::now();
+  auto num_bytes = log_->Sync();
+  auto sync_end_time = std::chrono::steady_clock::now();
+
+  for (auto [slot, machine_id] : pending_responses_) {
+    auto env = sender_.NewEnvelope();
+    auto accept_response = env->mutable_response()->mutable_paxos_accept();
+    accept_response->set_ballot(ballot_);
+    accept_response->set_slot(slot);
+    sender_.SendSameChannel(move(env), machine_id);
+  }
+  pending_responses_.clear();
+
+  if (per_thread_metrics_repo != nullptr) {
+    // The first record of the group waited the longest for its response, so its delay is the
+    // most that durability added to the commit latency of this group
+    auto sync_duration = std::chrono::duration_cast<std::chrono::nanoseconds>(sync_end_time - sync_start_time);
+    auto added_latency = std::chrono::duration_cast<std::chrono::nanoseconds>(sync_end_time - group_start_time_);
+    per_thread_metrics_repo->RecordPaxosSync(sender_.channel(), num_records, num_bytes, sync_duration.count(),
+                                             added_latency.count());
+  }
 }
 
-}  // namespace slog
\ No newline at end of file
+}  // namespace slog
@@ -1,6 +1,13 @@
 #pragma once
 
+#include <chrono>
+#include <memory>
+#include <utility>
+#include <vector>
+
 #include "common/types.h"
+#include "paxos/acceptor_log.h"
+#include "proto/configuration.pb.h"
 #include "proto/internal.pb.h"
 
 using std::string;
@@ -12,20 +19,32 @@ class SimulatedMultiPaxos;
 class Acceptor {
  public:
   /**
-   * @param sender The enclosing Paxos class
+   * @param sender     The enclosing Paxos class
+   * @param me         Machine Id of the current machine
+   * @param durability Where and how often the accepted values are persisted. If no log
+   *                   directory is given, the acceptor only keeps its state in memory
    */
-  Acceptor(SimulatedMultiPaxos& sender);
+  Acceptor(SimulatedMultiPaxos& sender, MachineId me, const internal::PaxosDurability& durability);
 
   void HandleRequest(const internal::Envelope& req);
 
+  // The slot after the last one accepted before a restart, or 0 if not durable
+  SlotId recovered_next_slot() const { return recovered_next_slot_; }
+
  private:
   void ProcessAcceptRequest(const internal::PaxosAcceptRequest& req, MachineId from_machine_id);
-
-  void ProcessCommitRequest(const internal::PaxosCommitRequest& req, MachineId from_machine_id);
+  void SyncLog();
 
   SimulatedMultiPaxos& sender_;
 
   uint32_t ballot_;
+  SlotId recovered_next_slot_;
+
+  std::unique_ptr<AcceptorLog> log_;
+  std::chrono::microseconds group_fsync_;
+  // Accept responses held back until their records are synced, as pairs of (slot, machine to respond to)
+  std::vector<std::pair<SlotId, MachineId>> pending_responses_;
+  std::chrono::steady_clock::time_point group_start_time_;
 };
 
-}  // namespace slog
\ No newline at end of file
+}  // namespace slog
@@ -0,0 +1,113 @@
+#include "paxos/acceptor_log.h"
+
+#include <fcntl.h>
+#include <glog/logging.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+
+namespace slog {
+
+namespace {
+
+// A record is laid out as [slot][ballot][number of values][values...]
+struct RecordHeader {
+  uint32_t slot;
+  uint32_t ballot;
+  uint32_t num_values;
+};
+
+}  // namespace
+
+AcceptorLog::AcceptorLog(const std::string& path, std::vector<Record>& recovered) : num_buffered_records_(0) {
+  fd_ = open(path.c_str(), O_RDWR | O_CREAT, 0644);
+  CHECK_GE(fd_, 0) << "Cannot open acceptor log \"" << path << "\": " << strerror(errno);
+
+  std::string content;
+  char buf[1 << 16];
+  ssize_t n;
+  while ((n = read(fd_, buf, sizeof(buf))) > 0) {
+    content.append(buf, n);
+  }
+  CHECK_GE(n, 0) << "Cannot read acceptor log \"" << path << "\": " << strerror(errno);
+
+  size_t pos = 0;
+  while (pos + sizeof(RecordHeader) <= content.size()) {
+    RecordHeader header;
+    memcpy(&header, content.data() + pos, sizeof(header));
+    auto values_size = header.num_values * sizeof(uint64_t);
+    if (pos + sizeof(header) + values_size > content.size()) {
+      break;
+    }
+    auto& record = recovered.emplace_back();
+    record.slot = header.slot;
+    record.ballot = header.ballot;
+    record.values.resize(header.num_values);
+    memcpy(record.values.data(), content.data() + pos + sizeof(header), values_size);
+    pos += sizeof(header) + values_size;
+  }
+
+  if (pos < content.size()) {
+    LOG(WARNING) << "Discarded " << content.size() - pos << " trailing bytes of acceptor log \"" << path << "\"";
+  }
+
+  if (content.empty()) {
+    return;
+  }
+
+  // The recovered values are not needed again since the paxos users start over after a restart. Only
+  // the highest ballot and the next free slot are kept, in a single empty record, so that the log
+  // does not grow across restarts. The compacted log replaces the old one atomically
+  RecordHeader summary{.slot = 0, .ballot = 0, .num_values = 0};
+  for (const auto& record : recovered) {
+    summary.slot = std::max<uint32_t>(summary.slot, record.slot + record.values.size());
+    summary.ballot = std::max(summary.ballot, record.ballot);
+  }
+  auto tmp_path = path + ".tmp";
+  auto tmp_fd = open(tmp_path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+  CHECK_GE(tmp_fd, 0) << "Cannot open acceptor log \"" << tmp_path << "\": " << strerror(errno);
+  if (!recovered.empty()) {
+    CHECK_EQ(write(tmp_fd, &summary, sizeof(summary)), static_cast<ssize_t>(sizeof(summary)))
+        << "Cannot write to acceptor log \"" << tmp_path << "\": " << strerror(errno);
+  }
+  CHECK_EQ(fdatasync(tmp_fd), 0) << "Cannot sync acceptor log \"" << tmp_path << "\": " << strerror(errno);
+  close(tmp_fd);
+  CHECK_EQ(rename(tmp_path.c_str(), path.c_str()), 0)
+      << "Cannot replace acceptor log \"" << path << "\": " << strerror(errno);
+
+  close(fd_);
+  fd_ = open(path.c_str(), O_WRONLY | O_APPEND);
+  CHECK_GE(fd_, 0) << "Cannot open acceptor log \"" << path << "\": " << strerror(errno);
+}
+
+AcceptorLog::~AcceptorLog() {
+  if (num_buffered_records_ > 0) {
+    Sync();
+  }
+  close(fd_);
+}
+
+void AcceptorLog::Append(const internal::PaxosAcceptRequest& req) {
+  RecordHeader header{
+      .slot = req.slot(), .ballot = req.ballot(), .num_values = static_cast<uint32_t>(req.values_size())};
+  buffer_.append(reinterpret_cast<const char*>(&header), sizeof(header));
+  buffer_.append(reinterpret_cast<const char*>(req.values().data()), req.values_size() * sizeof(uint64_t));
+  num_buffered_records_++;
+}
+
+size_t AcceptorLog::Sync() {
+  size_t written = 0;
+  while (written < buffer_.size()) {
+    auto n = write(fd_, buffer_.data() + written, buffer_.size() - written);
+    CHECK_GE(n, 0) << "Cannot write to acceptor log: " << strerror(errno);
+    written += n;
+  }
+  CHECK_EQ(fdatasync(fd_), 0) << "Cannot sync acceptor log: " << strerror(errno);
+  buffer_.clear();
+  num_buffered_records_ = 0;
+  return written;
+}
+
+}  // namespace slog
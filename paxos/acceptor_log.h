@@ -0,0 +1,57 @@
+#pragma once
+
+#include <string>
+#include <vector>
+
+#include "common/types.h"
+#include "proto/internal.pb.h"
+
+namespace slog {
+
+/**
+ * An append-only file of the values accepted by a Paxos acceptor. Each record holds the slot, the
+ * ballot and the values of an accept request.
+ *
+ * Appended records are buffered in memory and only written and flushed to disk by Sync(), so
+ * that an acceptor can sync a group of records at once and respond to all of them afterwards.
+ */
+class AcceptorLog {
+ public:
+  struct Record {
+    SlotId slot;
+    uint32_t ballot;
+    std::vector<uint64_t> values;
+  };
+
+  /**
+   * Opens the log at the given path, creating it if it does not exist. The records of an existing
+   * log are read back into `recovered`. A partially written record at the end of the file, left by
+   * a crash in the middle of a sync, is discarded.
+   *
+   * The existing log is then compacted into a single record without values that keeps the highest
+   * recovered ballot and the slot after the last recovered value.
+   */
+  AcceptorLog(const std::string& path, std::vector<Record>& recovered);
+  ~AcceptorLog();
+
+  AcceptorLog(const AcceptorLog&) = delete;
+  AcceptorLog& operator=(const AcceptorLog&) = delete;
+
+  void Append(const internal::PaxosAcceptRequest& req);
+
+  /**
+   * Writes the buffered records to the file and waits until they are on disk
+   *
+   * @return Number of bytes synced
+   */
+  size_t Sync();
+
+  size_t num_buffered_records() const { return num_buffered_records_; }
+
+ private:
+  int fd_;
+  std::string buffer_;
+  size_t num_buffered_records_;
+};
+
+}  // namespace slog
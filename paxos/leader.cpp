@@ -12,8 +12,13 @@ using internal::Envelope;
 using internal::Request;
 using internal::Response;
 
-Leader::Leader(SimulatedMultiPaxos& paxos, Members members, MachineId me)
-    : paxos_(paxos), members_(members), me_(me), next_empty_slot_(0) {
+Leader::Leader(SimulatedMultiPaxos& paxos, Members members, MachineId me, uint32_t window_size, SlotId start_slot)
+    : paxos_(paxos),
+      members_(members),
+      me_(me),
+      window_size_(window_size),
+      start_slot_(start_slot),
+      next_empty_slot_(start_slot) {
   auto it = std::find(members.acceptors.begin(), members.acceptors.end(), me);
   if (it != members.acceptors.end()) {
     auto position_in_acceptors = it - members.acceptors.begin();
@@ -27,6 +32,15 @@ Leader::Leader(SimulatedMultiPaxos& paxos, Members members, MachineId me)
     is_elected_ = false;
   }
   elected_leader_ = members.acceptors[kPaxosDefaultLeaderPosition];
+
+  auto& acceptors = members.acceptors;
+  auto& learners = members.learners;
+  is_learner_ = std::find(learners.begin(), learners.end(), me) != learners.end();
+  for (auto learner : learners) {
+    if (std::find(acceptors.begin(), acceptors.end(), learner) == acceptors.end()) {
+      non_acceptor_learners_.push_back(learner);
+    }
+  }
 }
 
 void Leader::HandleRequest(const Envelope& req) {
@@ -35,11 +49,18 @@ void Leader::HandleRequest(const Envelope& req) {
       // If elected as true leader, send accept request to the acceptors
       // Otherwise, forward the request to the true leader
       if (is_elected_) {
-        StartNewInstance(req.request().paxos_propose().value());
+        Propose(req.request().paxos_propose().value());
       } else {
         paxos_.SendSameChannel(req, elected_leader_);
       }
       break;
+    case Request::TypeCase::kPaxosAccept:
+      if (is_learner_) {
+        for (auto& commit : req.request().paxos_accept().commits()) {
+          ProcessCommitRequest(commit);
+        }
+      }
+      break;
     case Request::TypeCase::kPaxosCommit:
       ProcessCommitRequest(req.request().paxos_commit());
       break;
@@ -51,57 +72,82 @@ void Leader::HandleRequest(const Envelope& req) {
 void Leader::ProcessCommitRequest(const internal::PaxosCommitRequest& commit) {
   auto slot = commit.slot();
 
-  // Report to the paxos user
-  paxos_.OnCommit(slot, commit.value(), commit.leader());
+  // Report to the paxos user. The user starts empty after a restart, so its positions count from
+  // the first slot of the current leader instead of continuing from the slots taken before
+  for (auto value : commit.values()) {
+    paxos_.OnCommit(slot - commit.first_slot(), value, commit.leader());
+    slot++;
+  }
 
-  if (slot >= next_empty_slot_) {
-    next_empty_slot_ = slot + 1;
+  if (slot > next_empty_slot_) {
+    next_empty_slot_ = slot;
   }
 }
 
 void Leader::HandleResponse(const Envelope& res) {
-  if (res.response().has_paxos_accept()) {
-    auto slot = res.response().paxos_accept().slot();
-    auto it = instances_.find(slot);
-    if (it == instances_.end()) {
-      return;
-    }
-    auto& instance = it->second;
-    ++instance.num_accepts;
+  if (!res.response().has_paxos_accept()) {
+    return;
+  }
+  auto slot = res.response().paxos_accept().slot();
+  auto it = instances_.find(slot);
+  if (it == instances_.end()) {
+    return;
+  }
+  auto& instance = it->second;
+  ++instance.num_accepts;
 
-    if (instance.num_accepts == static_cast<int>(members_.acceptors.size() / 2 + 1)) {
+  if (instance.num_accepts < static_cast<int>(members_.acceptors.size() / 2 + 1)) {
+    return;
+  }
+
+  // The instance is chosen so the leader no longer needs it. Accept responses of the remaining
+  // acceptors are ignored
+  internal::PaxosCommitRequest commit;
+  commit.set_slot(slot);
+  commit.mutable_values()->Add(instance.values.begin(), instance.values.end());
+  commit.set_leader(me_);
+  commit.set_first_slot(start_slot_);
+  instances_.erase(it);
+
+  if (pending_values_.empty()) {
+    auto env = paxos_.NewEnvelope();
+    *env->mutable_request()->mutable_paxos_commit() = commit;
+    paxos_.SendSameChannel(move(env), members_.learners);
+  } else {
+    // Proposals are waiting for a free spot in the window, so the commit rides on the accept
+    // request of the next instance to the acceptors and only goes separately to the other learners
+    if (!non_acceptor_learners_.empty()) {
       auto env = paxos_.NewEnvelope();
-      auto paxos_commit = env->mutable_request()->mutable_paxos_commit();
-      paxos_commit->set_slot(slot);
-      paxos_commit->set_value(instance.value);
-      paxos_commit->set_leader(me_);
-      paxos_.SendSameChannel(move(env), members_.learners);
-    }
-  } else if (res.response().has_paxos_commit()) {
-    auto slot = res.response().paxos_accept().slot();
-    auto it = instances_.find(slot);
-    if (it == instances_.end()) {
-      return;
-    }
-    auto& instance = it->second;
-    ++instance.num_commits;
-    if (instance.num_commits == static_cast<int>(members_.acceptors.size())) {
-      instances_.erase(it);
+      *env->mutable_request()->mutable_paxos_commit() = commit;
+      paxos_.SendSameChannel(move(env), non_acceptor_learners_);
     }
+    StartNewInstance(&commit);
   }
 }
 
-void Leader::StartNewInstance(uint64_t value) {
-  instances_.try_emplace(next_empty_slot_, ballot_, value);
+void Leader::Propose(uint64_t value) {
+  pending_values_.push_back(value);
+  if (window_size_ == 0 || instances_.size() < window_size_) {
+    StartNewInstance();
+  }
+}
 
+void Leader::StartNewInstance(internal::PaxosCommitRequest* piggybacked_commit) {
   auto env = paxos_.NewEnvelope();
   auto paxos_accept = env->mutable_request()->mutable_paxos_accept();
   paxos_accept->set_ballot(ballot_);
   paxos_accept->set_slot(next_empty_slot_);
-  paxos_accept->set_value(value);
-  next_empty_slot_++;
+  paxos_accept->mutable_values()->Add(pending_values_.begin(), pending_values_.end());
+  if (piggybacked_commit != nullptr) {
+    paxos_accept->add_commits()->Swap(piggybacked_commit);
+  }
+
+  auto num_values = pending_values_.size();
+  instances_.try_emplace(next_empty_slot_, ballot_, move(pending_values_));
+  pending_values_.clear();
+  next_empty_slot_ += num_values;
 
   paxos_.SendSameChannel(move(env), members_.acceptors);
 }
 
-}  // namespace slog
\ No newline at end of file
+}  // namespace slog
@@ -28,12 +28,12 @@ struct Members {
 };
 
 struct PaxosInstance {
-  PaxosInstance(uint32_t ballot, uint64_t value) : ballot(ballot), value(value), num_accepts(0), num_commits(0) {}
+  PaxosInstance(uint32_t ballot, vector<uint64_t>&& values) : ballot(ballot), values(move(values)), num_accepts(0) {}
 
   uint32_t ballot;
-  uint64_t value;
+  // The values take consecutive slots starting from the slot of the instance
+  vector<uint64_t> values;
   int num_accepts;
-  int num_commits;
 };
 
 class Leader {
@@ -42,25 +42,38 @@ class Leader {
    * @param paxos     The enclosing Paxos class
    * @param members   Machine Ids of acceptors and learners
    * @param me        Machine Id of the current machine
+   * @param window_size Maximum number of instances in flight. Proposals arriving while
+   *                    the window is full are ordered together in the next instance.
+   *                    0 means no limit
+   * @param start_slot  First slot to propose to, which is past the slots that the acceptor
+   *                    of this machine accepted before a restart
    */
-  Leader(SimulatedMultiPaxos& paxos, Members members, MachineId me);
+  Leader(SimulatedMultiPaxos& paxos, Members members, MachineId me, uint32_t window_size = 0,
+         SlotId start_slot = 0);
 
   void HandleRequest(const internal::Envelope& req);
   void HandleResponse(const internal::Envelope& res);
 
  private:
   void ProcessCommitRequest(const internal::PaxosCommitRequest& commit);
-  void StartNewInstance(uint64_t value);
+  void Propose(uint64_t value);
+  void StartNewInstance(internal::PaxosCommitRequest* piggybacked_commit = nullptr);
 
   SimulatedMultiPaxos& paxos_;
 
   Members members_;
+  // Learners that do not receive accept requests so commits cannot be piggybacked for them
+  vector<MachineId> non_acceptor_learners_;
   const MachineId me_;
   bool is_elected_;
+  bool is_learner_;
   MachineId elected_leader_;
+  const uint32_t window_size_;
+  const SlotId start_slot_;
 
   SlotId next_empty_slot_;
   uint32_t ballot_;
   unordered_map<SlotId, PaxosInstance> instances_;
+  vector<uint64_t> pending_values_;
 };
 }  // namespace slog
\ No newline at end of file
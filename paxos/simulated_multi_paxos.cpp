@@ -9,8 +9,12 @@ using internal::Request;
 using internal::Response;
 
 SimulatedMultiPaxos::SimulatedMultiPaxos(Channel group_number, const shared_ptr<Broker>& broker, Members members,
-                                         MachineId me, std::chrono::milliseconds poll_timeout)
-    : NetworkedModule(broker, group_number, nullptr, poll_timeout), leader_(*this, members, me), acceptor_(*this) {}
+                                         MachineId me, std::chrono::milliseconds poll_timeout,
+                                         const internal::PaxosDurability& durability,
+                                         const MetricsRepositoryManagerPtr& metrics_manager)
+    : NetworkedModule(broker, group_number, metrics_manager, poll_timeout),
+      acceptor_(*this, me, durability),
+      leader_(*this, members, me, broker->config()->paxos_window_size(), acceptor_.recovered_next_slot()) {}
 
 void SimulatedMultiPaxos::OnInternalRequestReceived(EnvelopePtr&& req) {
   // A non-leader machine can still need to do some work to maintain its state should it becomes a leader later
@@ -18,9 +18,13 @@ class SimulatedMultiPaxos : public NetworkedModule {
    * @param broker        The broker for sending and receiving messages
    * @param members       Machine Id of all members participating in this Paxos process
    * @param me            Machine Id of the current machine
+   * @param durability    Persistence options of the acceptor
+   * @param metrics_manager Where the acceptor reports its disk syncs. Can be null
    */
   SimulatedMultiPaxos(Channel group_number, const shared_ptr<Broker>& broker, Members members, MachineId me,
-                      std::chrono::milliseconds poll_timeout = kModuleTimeout);
+                      std::chrono::milliseconds poll_timeout = kModuleTimeout,
+                      const internal::PaxosDurability& durability = internal::PaxosDurability(),
+                      const MetricsRepositoryManagerPtr& metrics_manager = nullptr);
 
   std::string name() const override { return "Paxos-" + std::to_string(channel()); }
 
@@ -28,11 +32,17 @@ class SimulatedMultiPaxos : public NetworkedModule {
   void OnInternalRequestReceived(EnvelopePtr&& env) final;
   void OnInternalResponseReceived(EnvelopePtr&& env) final;
 
+  /**
+   * Called for each committed value in the order of its slot. The slot is counted from the first
+   * slot that the leader proposed to since it started, so it begins at 0 even if the acceptors
+   * recovered slots from their logs
+   */
   virtual void OnCommit(uint32_t slot, int64_t value, MachineId leader) = 0;
 
  private:
-  Leader leader_;
+  // The acceptor is constructed first since the leader continues from the slots that it recovers
   Acceptor acceptor_;
+  Leader leader_;
 
   void SendSameChannel(const internal::Envelope& env, MachineId to_machine_id);
   void SendSameChannel(EnvelopePtr&& env, MachineId to_machine_id);
@@ -0,0 +1,99 @@
+#include <chrono>
+#include <iomanip>
+
+#include "common/batch_log.h"
+#include "common/configuration.h"
+#include "common/constants.h"
+#include "common/proto_utils.h"
+#include "connection/zmq_utils.h"
+#include "service/service_utils.h"
+#include "workload/basic.h"
+
+DEFINE_uint32(batch_size, 1000, "Number of transactions in a batch");
+DEFINE_uint32(rounds, 1000, "Number of times a batch is deserialized and freed");
+DEFINE_uint32(records, 100000, "Number of records");
+DEFINE_uint32(record_size, 100, "Size of a record in bytes");
+DEFINE_string(params, "", "Basic workload params");
+
+using namespace slog;
+using namespace std::chrono;
+
+using std::make_shared;
+using std::vector;
+
+namespace {
+
+/**
+ * Allocates the batch on the heap the way the log manager used to: every message is allocated
+ * separately and each txn is released from the batch and freed on its own
+ */
+void HeapRound(const zmq::message_t& msg) {
+  auto env = std::make_unique<internal::Envelope>();
+  CHECK(DeserializeProto(*env, msg));
+  auto batch = BatchPtr(env->mutable_request()->mutable_forward_batch_data()->mutable_batch_data()->ReleaseLast());
+  auto transactions = Unbatch(batch.get());
+  for (auto txn : transactions) {
+    delete txn;
+  }
+}
+
+/**
+ * Allocates the batch on an arena as the log manager does now. The txns share the ownership of
+ * the batch and the whole arena is freed when the last txn is released
+ */
+void ArenaRound(const zmq::message_t& msg) {
+  google::protobuf::ArenaOptions options;
+  options.start_block_size = std::max<size_t>(kMinArenaBlockSize, 4 * msg.size());
+  options.max_block_size = std::max(options.start_block_size, options.max_block_size);
+  auto arena = make_shared<google::protobuf::Arena>(options);
+  auto env = google::protobuf::Arena::CreateMessage<internal::Envelope>(arena.get());
+  CHECK(DeserializeProto(*env, msg));
+  auto batch = BatchPtr(std::shared_ptr<internal::Envelope>(arena, env),
+                        env->mutable_request()->mutable_forward_batch_data()->mutable_batch_data(0));
+  vector<TxnPtr> transactions;
+  transactions.reserve(batch->transactions_size());
+  for (auto& txn : *batch->mutable_transactions()) {
+    transactions.emplace_back(batch, &txn);
+  }
+  arena.reset();
+  batch.reset();
+  transactions.clear();
+}
+
+template <typename F>
+double MeasureMicros(F&& round, const zmq::message_t& msg) {
+  auto start = steady_clock::now();
+  for (uint32_t i = 0; i < FLAGS_rounds; i++) {
+    round(msg);
+  }
+  return duration_cast<nanoseconds>(steady_clock::now() - start).count() / 1000.0 / FLAGS_rounds;
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  InitializeService(&argc, &argv);
+
+  internal::Configuration config_proto;
+  config_proto.add_regions()->add_addresses("127.0.0.1");
+  config_proto.set_num_partitions(1);
+  config_proto.mutable_simple_partitioning()->set_num_records(FLAGS_records);
+  config_proto.mutable_simple_partitioning()->set_record_size_bytes(FLAGS_record_size);
+  auto config = make_shared<Configuration>(config_proto, "127.0.0.1");
+
+  // Build a serialized batch the same way it arrives at a log manager
+  BasicWorkload workload(config, 0, 0, "", FLAGS_params);
+  internal::Envelope env;
+  auto batch = env.mutable_request()->mutable_forward_batch_data()->add_batch_data();
+  for (uint32_t i = 0; i < FLAGS_batch_size; i++) {
+    batch->mutable_transactions()->AddAllocated(workload.NextTransaction().first);
+  }
+  auto msg = SerializeProto(env);
+  LOG(INFO) << "Serialized batch of " << FLAGS_batch_size << " txns: " << msg.size() << " bytes";
+
+  auto heap_us = MeasureMicros(HeapRound, msg);
+  auto arena_us = MeasureMicros(ArenaRound, msg);
+
+  LOG(INFO) << std::fixed << std::setprecision(3) << "Deserialize and free a batch. Heap: " << heap_us
+            << " us. Arena: " << arena_us << " us. Speedup: " << heap_us / arena_us << "x";
+}
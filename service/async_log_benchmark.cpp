@@ -0,0 +1,60 @@
+#include <chrono>
+#include <iomanip>
+#include <random>
+
+#include "common/async_log.h"
+#include "service/service_utils.h"
+
+DEFINE_uint32(items, 1000000, "Number of items inserted into the log");
+DEFINE_uint32(window, 100, "Items arrive out of order within windows of this many positions");
+DEFINE_uint32(rounds, 10, "Number of times the items are inserted and read");
+
+using namespace slog;
+using namespace std::chrono;
+
+using std::vector;
+
+namespace {
+
+/**
+ * Inserts the positions in the given order and reads the log as far as possible after each
+ * insertion, as the log manager does with batches and slots
+ */
+template <typename Log>
+double MeasureNanosPerItem(const vector<uint32_t>& positions) {
+  uint64_t checksum = 0;
+  auto start = steady_clock::now();
+  for (uint32_t r = 0; r < FLAGS_rounds; r++) {
+    Log log;
+    for (auto pos : positions) {
+      log.Insert(pos, pos);
+      while (log.HasNext()) {
+        checksum += log.Next().second;
+      }
+    }
+  }
+  auto elapsed = duration_cast<nanoseconds>(steady_clock::now() - start).count();
+  CHECK_EQ(checksum, static_cast<uint64_t>(FLAGS_rounds) * FLAGS_items * (FLAGS_items - 1) / 2);
+  return static_cast<double>(elapsed) / FLAGS_rounds / FLAGS_items;
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  InitializeService(&argc, &argv);
+
+  vector<uint32_t> positions(FLAGS_items);
+  for (uint32_t i = 0; i < FLAGS_items; i++) {
+    positions[i] = i;
+  }
+  std::mt19937 rng(0);
+  for (size_t i = 0; i < positions.size(); i += FLAGS_window) {
+    std::shuffle(positions.begin() + i, positions.begin() + std::min<size_t>(i + FLAGS_window, positions.size()), rng);
+  }
+
+  auto map_ns = MeasureNanosPerItem<MapAsyncLog<uint32_t>>(positions);
+  auto ring_ns = MeasureNanosPerItem<AsyncLog<uint32_t>>(positions);
+
+  LOG(INFO) << std::fixed << std::setprecision(3) << "Insert and read an item. Map: " << map_ns
+            << " ns. Ring: " << ring_ns << " ns. Speedup: " << map_ns / ring_ns << "x";
+}
@@ -0,0 +1,114 @@
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <iomanip>
+#include <mutex>
+
+#include "common/configuration.h"
+#include "common/constants.h"
+#include "connection/broker.h"
+#include "connection/sender.h"
+#include "module/base/module.h"
+#include "paxos/simulated_multi_paxos.h"
+#include "service/service_utils.h"
+
+DEFINE_uint32(machines, 3, "Number of acceptors, which are also the learners");
+DEFINE_uint32(proposals, 100000, "Number of values proposed");
+DEFINE_uint32(window, 0, "Maximum number of instances in flight. 0 means no limit");
+DEFINE_string(address_prefix, "/tmp/paxos_benchmark_", "Prefix of the ipc addresses of the machines");
+
+using namespace slog;
+using namespace std::chrono;
+
+using std::make_shared;
+using std::vector;
+
+namespace {
+
+/**
+ * Counts the committed values and wakes up the waiting thread once all of them are committed
+ */
+class BenchmarkPaxos : public SimulatedMultiPaxos {
+ public:
+  BenchmarkPaxos(const std::shared_ptr<Broker>& broker, Members members, MachineId me)
+      : SimulatedMultiPaxos(kLocalPaxos, broker, members, me), num_commits_(0) {}
+
+  void WaitForCommits(uint32_t num_commits) {
+    std::unique_lock<std::mutex> lock(mut_);
+    cv_.wait(lock, [this, num_commits] { return num_commits_.load() >= num_commits; });
+  }
+
+ protected:
+  void OnCommit(uint32_t, int64_t, MachineId) final {
+    if (++num_commits_ == FLAGS_proposals) {
+      std::lock_guard<std::mutex> guard(mut_);
+      cv_.notify_all();
+    }
+  }
+
+ private:
+  std::atomic<uint32_t> num_commits_;
+  std::mutex mut_;
+  std::condition_variable cv_;
+};
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  InitializeService(&argc, &argv);
+
+  internal::Configuration config_proto;
+  config_proto.set_protocol("ipc");
+  config_proto.add_broker_ports(0);
+  config_proto.add_broker_ports(1);
+  config_proto.set_forwarder_port(2);
+  config_proto.set_sequencer_port(3);
+  config_proto.set_num_partitions(FLAGS_machines);
+  config_proto.mutable_hash_partitioning()->set_partition_key_num_bytes(1);
+  config_proto.set_paxos_window_size(FLAGS_window);
+  auto region = config_proto.add_regions();
+  for (uint32_t p = 0; p < FLAGS_machines; p++) {
+    region->add_addresses(FLAGS_address_prefix + std::to_string(p));
+  }
+
+  vector<std::shared_ptr<Broker>> brokers;
+  vector<std::shared_ptr<BenchmarkPaxos>> paxi;
+  vector<std::unique_ptr<ModuleRunner>> runners;
+  for (uint32_t p = 0; p < FLAGS_machines; p++) {
+    auto config = make_shared<Configuration>(config_proto, FLAGS_address_prefix + std::to_string(p));
+    auto members = Members(config->all_machine_ids(), config->all_machine_ids());
+    auto broker = Broker::New(config);
+    auto paxos = make_shared<BenchmarkPaxos>(broker, members, config->local_machine_id());
+    runners.push_back(std::make_unique<ModuleRunner>(paxos));
+    brokers.push_back(broker);
+    paxi.push_back(paxos);
+  }
+  for (auto& broker : brokers) {
+    broker->StartInNewThreads();
+  }
+  for (auto& runner : runners) {
+    runner->StartInNewThread();
+  }
+
+  // Propose from the leader's machine so that no proposal has to be forwarded
+  Sender sender(brokers[0]->config(), brokers[0]->context());
+  auto start = steady_clock::now();
+  for (uint32_t i = 0; i < FLAGS_proposals; i++) {
+    auto env = std::make_unique<internal::Envelope>();
+    env->mutable_request()->mutable_paxos_propose()->set_value(i);
+    sender.Send(move(env), kLocalPaxos);
+  }
+  for (auto& paxos : paxi) {
+    paxos->WaitForCommits(FLAGS_proposals);
+  }
+  auto elapsed = duration_cast<microseconds>(steady_clock::now() - start).count();
+
+  LOG(INFO) << std::fixed << std::setprecision(3) << "Committed " << FLAGS_proposals << " values on "
+            << FLAGS_machines << " machines with window " << FLAGS_window << " in " << elapsed / 1000.0
+            << " ms. Throughput: " << FLAGS_proposals * 1e6 / elapsed << " values/s";
+
+  runners.clear();
+  for (auto& broker : brokers) {
+    broker->Stop();
+  }
+}
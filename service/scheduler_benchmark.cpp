@@ -17,11 +17,15 @@ DEFINE_string(params, "hot=0,hot_records=0", "Basic workload params");
 DEFINE_double(sample, 10, "Percent of sampled transactions to be written to result files");
 DEFINE_string(out_dir, "", "Directory containing output data");
 DEFINE_string(execution, "key_value", "Execution type. Choose from (noop and key_value)");
+DEFINE_bool(key_affinity, false, "Dispatch txns to workers by hashing their first write key");
+DEFINE_string(lock_managers, "ddr",
+              "Comma-separated list of lock managers (ddr, rma, old) to run the same workload through");
 
 using namespace slog;
 using namespace std::chrono;
 
 using std::make_shared;
+using std::pair;
 using std::string;
 using std::vector;
 
@@ -31,10 +35,37 @@ struct TxnInfo {
   TimePoint sent_at;
 };
 
-int main(int argc, char* argv[]) {
-  InitializeService(&argc, &argv);
+namespace {
 
-  string address("/tmp/test_scheduler");
+internal::LockManagerType ParseLockManager(const string& name) {
+  if (name == "ddr") {
+    return internal::LockManagerType::DDR;
+  } else if (name == "rma") {
+    return internal::LockManagerType::RMA;
+  } else if (name == "old") {
+    return internal::LockManagerType::OLD;
+  }
+  LOG(FATAL) << "Unknown lock manager: " << name;
+  return internal::LockManagerType::DDR;
+}
+
+bool IsCompatible(internal::LockManagerType lock_manager) {
+#if defined(REMASTER_PROTOCOL_SIMPLE) || defined(REMASTER_PROTOCOL_PER_KEY)
+  return lock_manager == internal::LockManagerType::OLD;
+#elif defined(REMASTER_PROTOCOL_COUNTERLESS)
+  return lock_manager != internal::LockManagerType::OLD;
+#else
+  (void)lock_manager;
+  return true;
+#endif
+}
+
+/**
+ * Runs the same workload through a scheduler using the given lock manager and returns the throughput
+ */
+double RunBenchmark(const string& lock_manager_name, const string& out_dir) {
+  // Use a different address for each run so that sockets of the previous run do not interfere
+  string address("/tmp/test_scheduler_" + lock_manager_name);
 
   internal::Configuration config_proto;
   config_proto.set_protocol("ipc");
@@ -47,6 +78,8 @@ int main(int argc, char* argv[]) {
   config_proto.mutable_simple_partitioning()->set_record_size_bytes(FLAGS_record_size);
   config_proto.add_regions()->add_addresses(address);
   config_proto.set_num_workers(FLAGS_workers);
+  config_proto.set_worker_key_affinity(FLAGS_key_affinity);
+  config_proto.set_lock_manager(ParseLockManager(lock_manager_name));
   if (FLAGS_execution == "noop") {
     config_proto.set_execution_type(internal::ExecutionType::NOOP);
   } else if (FLAGS_execution == "key_value") {
@@ -66,7 +99,8 @@ int main(int argc, char* argv[]) {
   broker->StartInNewThreads();
   scheduler->StartInNewThread();
 
-  // Prepare the workload
+  // Prepare the workload. The workload is seeded identically in every run so all lock managers
+  // see the same transactions and thus the same contention
   BasicWorkload workload(config, 0, 0, "", FLAGS_params);
   vector<Transaction*> transactions;
   LOG(INFO) << "Generating " << FLAGS_txns << " transactions";
@@ -85,7 +119,7 @@ int main(int argc, char* argv[]) {
   auto start_time = std::chrono::steady_clock::now();
 
   // Send transactions to the scheduler
-  LOG(INFO) << "Sending all transactions through the scheduler";
+  LOG(INFO) << "Sending all transactions through the scheduler using the " << lock_manager_name << " lock manager";
   std::unordered_map<TxnId, TxnInfo::TimePoint> sent_at;
   Sender sender(config, broker->context());
   for (auto txn : transactions) {
@@ -100,12 +134,7 @@ int main(int argc, char* argv[]) {
   vector<TxnInfo> results;
   results.reserve(FLAGS_txns);
   for (size_t i = 0; i < transactions.size(); i++) {
-    auto wrapped_env = RecvEnvelope(result_socket);
-    EnvelopePtr env;
-    env.reset(new slog::internal::Envelope());
-    if (DeserializeProto(*env, wrapped_env->raw().data(), wrapped_env->raw().size())) {
-      env->set_from(wrapped_env->from());
-    }
+    auto env = RecvEnvelope(result_socket);
     auto txn = env->mutable_request()->mutable_finished_subtxn()->release_txn();
     auto txn_id = txn->internal().id();
     results.push_back({.txn = txn, .sent_at = sent_at[txn_id]});
@@ -114,14 +143,15 @@ int main(int argc, char* argv[]) {
 
   auto duration = duration_cast<milliseconds>(std::chrono::steady_clock::now() - start_time);
   LOG(INFO) << "Elapsed time: " << duration.count() / 1000.0 << " s";
+  double avg_throughput = std::numeric_limits<double>::infinity();
   if (duration.count() == 0) {
     LOG(INFO) << "Avg. Throughput: inf txn/s";
   } else {
-    auto avg_throughput = FLAGS_txns / (duration.count() / 1000.0);
+    avg_throughput = FLAGS_txns / (duration.count() / 1000.0);
     LOG(INFO) << "Avg. Throughput: " << std::fixed << std::setprecision(3) << avg_throughput << " txn/s";
   }
 
-  if (!FLAGS_out_dir.empty()) {
+  if (!out_dir.empty()) {
     // Sample a subset of the result
     std::mt19937 rg(0);
     std::shuffle(results.begin(), results.end(), rg);
@@ -155,4 +185,33 @@ int main(int argc, char* argv[]) {
       }
     }
   }
-}
\ No newline at end of file
+
+  for (auto& info : results) {
+    delete info.txn;
+  }
+
+  return avg_throughput;
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  InitializeService(&argc, &argv);
+
+  vector<pair<string, double>> throughputs;
+  for (const auto& name : Split(FLAGS_lock_managers, ",")) {
+    if (!IsCompatible(ParseLockManager(name))) {
+      LOG(WARNING) << "Skipping the " << name << " lock manager, which is incompatible with the remaster protocol";
+      continue;
+    }
+    auto out_dir = FLAGS_out_dir;
+    if (!out_dir.empty() && FLAGS_lock_managers.find(',') != string::npos) {
+      out_dir += "/" + name;
+    }
+    throughputs.emplace_back(name, RunBenchmark(name, out_dir));
+  }
+
+  for (const auto& [name, throughput] : throughputs) {
+    LOG(INFO) << "Lock manager " << name << ": " << std::fixed << std::setprecision(3) << throughput << " txn/s";
+  }
+}
@@ -80,24 +80,34 @@ int main(int argc, char* argv[]) {
   // Create and initialize storage layer
   auto [storage, metadata_initializer] = slog::MakeStorage(config, FLAGS_data_dir);
 
+  // Each log manager hands the txns of its batches to the scheduler through its own queue
+  auto num_log_managers = broker->config()->num_log_managers();
+  vector<std::shared_ptr<slog::TxnQueue>> txn_queues;
+  for (int i = 0; i < num_log_managers; i++) {
+    txn_queues.push_back(std::make_shared<slog::TxnQueue>());
+  }
+  // The sequencer adapts its batch window to the number of txns buffered in the log managers
+  auto log_manager_backlog = std::make_shared<slog::LogManagerBacklog>(0);
+
   vector<pair<unique_ptr<slog::ModuleRunner>, slog::ModuleId>> modules;
   // clang-format off
   modules.emplace_back(MakeRunnerFor<slog::Server>(broker, metrics_manager),
                        slog::ModuleId::SERVER);
   modules.emplace_back(MakeRunnerFor<slog::MultiHomeOrderer>(broker, metrics_manager),
                        slog::ModuleId::MHORDERER);
-  modules.emplace_back(MakeRunnerFor<slog::LocalPaxos>(broker),
+  modules.emplace_back(MakeRunnerFor<slog::LocalPaxos>(broker, metrics_manager),
                        slog::ModuleId::LOCALPAXOS);
   modules.emplace_back(MakeRunnerFor<slog::Forwarder>(broker->context(), broker->config(), storage,
                                                       metadata_initializer, metrics_manager),
                        slog::ModuleId::FORWARDER);
-  modules.emplace_back(MakeRunnerFor<slog::Sequencer>(broker->context(), broker->config(), metrics_manager),
+  modules.emplace_back(MakeRunnerFor<slog::Sequencer>(broker->context(), broker->config(), metrics_manager,
+                                                      slog::kModuleTimeout, log_manager_backlog),
                        slog::ModuleId::SEQUENCER);
-  modules.emplace_back(MakeRunnerFor<slog::Scheduler>(broker, storage, metrics_manager),
+  modules.emplace_back(MakeRunnerFor<slog::Scheduler>(broker, storage, metrics_manager, slog::kModuleTimeout,
+                                                      txn_queues),
                        slog::ModuleId::SCHEDULER);
   // clang-format on
 
-  auto num_log_managers = broker->config()->num_log_managers();
   for (int i = 0; i < num_log_managers; i++) {
     std::vector<slog::RegionId> regions;
     for (int r = 0; r < broker->config()->num_regions(); r++) {
@@ -105,13 +115,15 @@ int main(int argc, char* argv[]) {
         regions.push_back(r);
       }
     }
-    modules.emplace_back(MakeRunnerFor<slog::LogManager>(i, regions, broker, metrics_manager),
-                         slog::ModuleId::LOG_MANAGER);
+    modules.emplace_back(
+        MakeRunnerFor<slog::LogManager>(i, regions, broker, metrics_manager, slog::kModuleTimeout, txn_queues[i],
+                                        log_manager_backlog),
+        slog::ModuleId::LOG_MANAGER);
   }
 
   // One region is selected to globally order the multihome batches
   if (config->num_regions() > 1 && config->leader_region_for_multi_home_ordering() == config->local_region()) {
-    modules.emplace_back(MakeRunnerFor<slog::GlobalPaxos>(broker), slog::ModuleId::GLOBALPAXOS);
+    modules.emplace_back(MakeRunnerFor<slog::GlobalPaxos>(broker, metrics_manager), slog::ModuleId::GLOBALPAXOS);
   }
 
   // Block SIGINT from here so that the new threads inherit the block mask
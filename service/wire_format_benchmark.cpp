@@ -0,0 +1,86 @@
+#include <chrono>
+#include <iomanip>
+
+#include "common/configuration.h"
+#include "common/proto_utils.h"
+#include "connection/zmq_utils.h"
+#include "service/service_utils.h"
+#include "workload/basic.h"
+
+DEFINE_uint32(batch_size, 100, "Number of transactions in a batch");
+DEFINE_uint32(rounds, 100000, "Number of times a message is serialized and deserialized");
+DEFINE_uint32(records, 100000, "Number of records");
+DEFINE_uint32(record_size, 100, "Size of a record in bytes");
+DEFINE_string(params, "", "Basic workload params");
+
+using namespace slog;
+using namespace std::chrono;
+
+using std::make_shared;
+
+namespace {
+
+struct Measurement {
+  size_t bytes;
+  double serialize_us;
+  double deserialize_us;
+};
+
+Measurement Measure(const internal::Envelope& env, internal::WireFormat format) {
+  Measurement m;
+  m.bytes = SerializeProto(env, format).size();
+
+  auto start = steady_clock::now();
+  for (uint32_t i = 0; i < FLAGS_rounds; i++) {
+    auto msg = SerializeProto(env, format);
+  }
+  m.serialize_us = duration_cast<nanoseconds>(steady_clock::now() - start).count() / 1000.0 / FLAGS_rounds;
+
+  auto msg = SerializeProto(env, format);
+  start = steady_clock::now();
+  for (uint32_t i = 0; i < FLAGS_rounds; i++) {
+    internal::Envelope env2;
+    CHECK(DeserializeProto(env2, msg));
+  }
+  m.deserialize_us = duration_cast<nanoseconds>(steady_clock::now() - start).count() / 1000.0 / FLAGS_rounds;
+  return m;
+}
+
+void Compare(const std::string& name, const internal::Envelope& env) {
+  auto any = Measure(env, internal::WireFormat::ANY);
+  auto lean = Measure(env, internal::WireFormat::LEAN);
+  LOG(INFO) << std::fixed << std::setprecision(3) << name << ". Bytes: " << any.bytes << " -> " << lean.bytes
+            << " (saved " << static_cast<int64_t>(any.bytes - lean.bytes) << "). Serialize: " << any.serialize_us
+            << " us -> " << lean.serialize_us << " us. Deserialize: " << any.deserialize_us << " us -> "
+            << lean.deserialize_us << " us";
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+  InitializeService(&argc, &argv);
+
+  internal::Configuration config_proto;
+  config_proto.add_regions()->add_addresses("127.0.0.1");
+  config_proto.set_num_partitions(1);
+  config_proto.mutable_simple_partitioning()->set_num_records(FLAGS_records);
+  config_proto.mutable_simple_partitioning()->set_record_size_bytes(FLAGS_record_size);
+  auto config = make_shared<Configuration>(config_proto, "127.0.0.1");
+  BasicWorkload workload(config, 0, 0, "", FLAGS_params);
+
+  internal::Envelope ping_env;
+  auto now = duration_cast<nanoseconds>(system_clock::now().time_since_epoch()).count();
+  ping_env.mutable_request()->mutable_ping()->set_src_time(now);
+  Compare("Ping", ping_env);
+
+  internal::Envelope txn_env;
+  txn_env.mutable_request()->mutable_forward_txn()->set_allocated_txn(workload.NextTransaction().first);
+  Compare("Txn", txn_env);
+
+  internal::Envelope batch_env;
+  auto batch = batch_env.mutable_request()->mutable_forward_batch_data()->add_batch_data();
+  for (uint32_t i = 0; i < FLAGS_batch_size; i++) {
+    batch->mutable_transactions()->AddAllocated(workload.NextTransaction().first);
+  }
+  Compare("Batch of " + std::to_string(FLAGS_batch_size) + " txns", batch_env);
+}
@@ -0,0 +1,83 @@
+#include "common/async_log.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <random>
+#include <string>
+#include <vector>
+
+using namespace std;
+using namespace slog;
+
+TEST(AsyncLogTest, InOrder) {
+  AsyncLog<string> log(10);
+  ASSERT_FALSE(log.HasNext());
+  log.Insert(10, "a");
+  log.Insert(11, "b");
+  ASSERT_TRUE(log.HasNext());
+  ASSERT_EQ(log.Peek(), "a");
+  ASSERT_EQ(log.Next(), make_pair(10U, string("a")));
+  ASSERT_EQ(log.Next(), make_pair(11U, string("b")));
+  ASSERT_FALSE(log.HasNext());
+  ASSERT_THROW(log.Next(), runtime_error);
+  ASSERT_THROW(log.Peek(), out_of_range);
+}
+
+TEST(AsyncLogTest, OutOfOrderAndGrow) {
+  AsyncLog<int> log;
+  // Far enough ahead to grow the ring a few times
+  log.Insert(100, 100);
+  log.Insert(2, 2);
+  log.Insert(0, 0);
+  ASSERT_EQ(log.NumBufferredItems(), 3U);
+  ASSERT_EQ(log.Next().first, 0U);
+  ASSERT_FALSE(log.HasNext());
+  log.Insert(1, 1);
+  ASSERT_EQ(log.Next().second, 1);
+  ASSERT_EQ(log.Next().second, 2);
+  ASSERT_FALSE(log.HasNext());
+  for (int i = 3; i < 100; i++) {
+    log.Insert(i, i);
+  }
+  for (int i = 3; i <= 100; i++) {
+    ASSERT_EQ(log.Next(), make_pair(static_cast<uint32_t>(i), i));
+  }
+  ASSERT_EQ(log.NumBufferredItems(), 0U);
+}
+
+TEST(AsyncLogTest, DuplicateAndPassedPositions) {
+  AsyncLog<int> log;
+  log.Insert(0, 0);
+  log.Insert(5, 5);
+  ASSERT_THROW(log.Insert(5, 6), runtime_error);
+  log.Next();
+  // Positions that have been read are ignored
+  log.Insert(0, 1);
+  ASSERT_EQ(log.NumBufferredItems(), 1U);
+}
+
+TEST(AsyncLogTest, MatchesMapAsyncLog) {
+  mt19937 rng(0);
+  vector<uint32_t> positions(10000);
+  for (uint32_t i = 0; i < positions.size(); i++) {
+    positions[i] = i;
+  }
+  // Shuffle within windows so that the positions arrive out of order but not too far ahead
+  for (size_t i = 0; i < positions.size(); i += 100) {
+    shuffle(positions.begin() + i, positions.begin() + min(i + 300, positions.size()), rng);
+  }
+
+  AsyncLog<uint32_t> ring_log;
+  MapAsyncLog<uint32_t> map_log;
+  for (auto pos : positions) {
+    ring_log.Insert(pos, pos * 2);
+    map_log.Insert(pos, pos * 2);
+    ASSERT_EQ(ring_log.HasNext(), map_log.HasNext());
+    while (map_log.HasNext()) {
+      ASSERT_EQ(ring_log.Next(), map_log.Next());
+    }
+    ASSERT_EQ(ring_log.NumBufferredItems(), map_log.NumBufferredItems());
+  }
+  ASSERT_FALSE(ring_log.HasNext());
+}
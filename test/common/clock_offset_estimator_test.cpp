@@ -0,0 +1,56 @@
+#include "common/clock_offset_estimator.h"
+
+#include <gtest/gtest.h>
+
+using namespace std;
+using namespace slog;
+
+const int64_t kMs = 1000000;
+
+TEST(ClockOffsetEstimatorTest, SelectLowestRoundTripTime) {
+  ClockOffsetEstimator estimator(3);
+  ASSERT_FALSE(estimator.has_estimate());
+  // The true offset is 100ms. Delay asymmetry shifts the measured offset by at most half of the rtt
+  estimator.AddSample(0, 100 * kMs + 4 * kMs, 10 * kMs);
+  estimator.AddSample(1 * kMs, 1 * kMs + 100 * kMs - 1 * kMs, 2 * kMs);
+  estimator.AddSample(2 * kMs, 2 * kMs + 100 * kMs + 3 * kMs, 8 * kMs);
+  ASSERT_TRUE(estimator.has_estimate());
+  ASSERT_EQ(estimator.min_rtt(), 2 * kMs);
+  ASSERT_EQ(estimator.OffsetAt(1 * kMs), 99 * kMs);
+  ASSERT_EQ(estimator.ErrorBoundAt(1 * kMs), 1 * kMs);
+}
+
+TEST(ClockOffsetEstimatorTest, ForgetOldSamples) {
+  ClockOffsetEstimator estimator(2);
+  estimator.AddSample(0, 100 * kMs, 1 * kMs);
+  estimator.AddSample(1 * kMs, 1 * kMs + 200 * kMs, 5 * kMs);
+  ASSERT_EQ(estimator.min_rtt(), 1 * kMs);
+  estimator.AddSample(2 * kMs, 2 * kMs + 200 * kMs, 4 * kMs);
+  ASSERT_EQ(estimator.min_rtt(), 4 * kMs);
+  ASSERT_EQ(estimator.OffsetAt(2 * kMs), 200 * kMs);
+}
+
+TEST(ClockOffsetEstimatorTest, CompensateDrift) {
+  ClockOffsetEstimator estimator(1);
+  // The remote clock gains 100us every second
+  const double kDrift = 1e-4;
+  for (int64_t t = 0; t <= 10000 * kMs; t += 1000 * kMs) {
+    estimator.AddSample(t, t + 5 * kMs + static_cast<int64_t>(kDrift * t), 1000);
+  }
+  ASSERT_NEAR(estimator.drift(), kDrift, 1e-6);
+  // Extrapolate half a second past the last sample
+  auto t = 10500 * kMs;
+  ASSERT_NEAR(estimator.OffsetAt(t), 5 * kMs + kDrift * t, 1000);
+  // The error grows with the distance from the last sample
+  ASSERT_GT(estimator.ErrorBoundAt(t), estimator.ErrorBoundAt(10000 * kMs));
+  ASSERT_LT(estimator.ErrorBoundAt(t), 1 * kMs);
+}
+
+TEST(ClockOffsetEstimatorTest, BoundUnknownDrift) {
+  ClockOffsetEstimator estimator(1);
+  estimator.AddSample(0, 5 * kMs, 2000);
+  ASSERT_EQ(estimator.drift(), 0);
+  ASSERT_EQ(estimator.ErrorBoundAt(0), 1000);
+  auto max_drift_error = static_cast<int64_t>(ClockOffsetEstimator::kMaxDrift * 1000 * kMs);
+  ASSERT_EQ(estimator.ErrorBoundAt(1000 * kMs), 1000 + max_drift_error);
+}
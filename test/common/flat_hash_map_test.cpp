@@ -0,0 +1,74 @@
+#include "common/flat_hash_map.h"
+
+#include <gtest/gtest.h>
+
+#include <random>
+#include <string>
+#include <unordered_map>
+
+using namespace std;
+using namespace slog;
+
+TEST(FlatHashMapTest, BasicOperations) {
+  FlatHashMap<uint64_t, string> map;
+  ASSERT_TRUE(map.empty());
+  ASSERT_EQ(map.find(1), map.end());
+  ASSERT_EQ(map.erase(1), 0U);
+
+  auto [it, inserted] = map.try_emplace(1, "one");
+  ASSERT_TRUE(inserted);
+  ASSERT_EQ(it->first, 1U);
+  ASSERT_EQ(it->second, "one");
+
+  // An existing value is not replaced
+  tie(it, inserted) = map.try_emplace(1, "uno");
+  ASSERT_FALSE(inserted);
+  ASSERT_EQ(it->second, "one");
+
+  map.try_emplace(2, "two");
+  ASSERT_EQ(map.size(), 2U);
+  ASSERT_EQ(map.find(2)->second, "two");
+
+  map.erase(map.find(1));
+  ASSERT_EQ(map.find(1), map.end());
+  ASSERT_EQ(map.erase(2), 1U);
+  ASSERT_TRUE(map.empty());
+}
+
+TEST(FlatHashMapTest, Iterate) {
+  FlatHashMap<uint64_t, int> map(4);
+  for (int i = 0; i < 100; i++) {
+    map.try_emplace(i * 1000, i);
+  }
+  int sum = 0;
+  size_t count = 0;
+  for (const auto& [key, value] : map) {
+    ASSERT_EQ(key, static_cast<uint64_t>(value * 1000));
+    sum += value;
+    count++;
+  }
+  ASSERT_EQ(count, 100U);
+  ASSERT_EQ(sum, 4950);
+}
+
+TEST(FlatHashMapTest, RandomOperations) {
+  // Keys share the low bits like txn ids do, which produces long probe sequences to erase from
+  FlatHashMap<uint64_t, uint64_t> map(8);
+  unordered_map<uint64_t, uint64_t> expected;
+  mt19937 rg(0);
+  uniform_int_distribution<uint64_t> key_dist(0, 500);
+  for (int i = 0; i < 100000; i++) {
+    auto key = key_dist(rg) << 16;
+    if (rg() % 2) {
+      ASSERT_EQ(map.try_emplace(key, i).second, expected.try_emplace(key, i).second);
+    } else {
+      ASSERT_EQ(map.erase(key), expected.erase(key));
+    }
+    ASSERT_EQ(map.size(), expected.size());
+  }
+  for (const auto& [key, value] : expected) {
+    auto it = map.find(key);
+    ASSERT_NE(it, map.end());
+    ASSERT_EQ(it->second, value);
+  }
+}
@@ -0,0 +1,91 @@
+#include "common/mpsc_queue.h"
+
+#include <gtest/gtest.h>
+#include <poll.h>
+
+#include <thread>
+#include <vector>
+
+using namespace std;
+using namespace slog;
+
+namespace {
+bool IsNotified(int fd) {
+  pollfd item{.fd = fd, .events = POLLIN, .revents = 0};
+  return poll(&item, 1, 0) > 0;
+}
+
+void Reset(int fd) {
+  uint64_t val;
+  [[maybe_unused]] auto res = read(fd, &val, sizeof(val));
+}
+}  // namespace
+
+TEST(MpscQueueTest, PushAndPop) {
+  MpscQueue<int> queue;
+  int val;
+  ASSERT_FALSE(queue.Pop(val));
+
+  queue.Push(1);
+  queue.Push(2);
+  queue.Push(3);
+  ASSERT_TRUE(queue.Pop(val));
+  ASSERT_EQ(val, 1);
+  ASSERT_TRUE(queue.Pop(val));
+  ASSERT_EQ(val, 2);
+  ASSERT_TRUE(queue.Pop(val));
+  ASSERT_EQ(val, 3);
+  ASSERT_FALSE(queue.Pop(val));
+}
+
+TEST(MpscQueueTest, NotifyOncePerDrain) {
+  MpscQueue<int> queue;
+  ASSERT_FALSE(IsNotified(queue.notify_fd()));
+
+  queue.Push(1);
+  ASSERT_TRUE(IsNotified(queue.notify_fd()));
+  Reset(queue.notify_fd());
+
+  // The consumer has not drained the queue so there is no need to notify
+  queue.Push(2);
+  ASSERT_FALSE(IsNotified(queue.notify_fd()));
+
+  int val;
+  ASSERT_TRUE(queue.Pop(val));
+  ASSERT_TRUE(queue.Pop(val));
+  ASSERT_FALSE(queue.Pop(val));
+
+  queue.Push(3);
+  ASSERT_TRUE(IsNotified(queue.notify_fd()));
+}
+
+TEST(MpscQueueTest, ConcurrentProducers) {
+  const int kNumProducers = 4;
+  const int kNumItems = 10000;
+  MpscQueue<pair<int, int>> queue;
+
+  vector<thread> producers;
+  for (int p = 0; p < kNumProducers; p++) {
+    producers.emplace_back([&queue, p] {
+      for (int i = 0; i < kNumItems; i++) {
+        queue.Push({p, i});
+      }
+    });
+  }
+
+  // Items of the same producer are popped in the order they are pushed
+  vector<int> expected(kNumProducers, 0);
+  for (int popped = 0; popped < kNumProducers * kNumItems;) {
+    pair<int, int> val;
+    if (queue.Pop(val)) {
+      ASSERT_EQ(val.second, expected[val.first]);
+      expected[val.first]++;
+      popped++;
+    } else {
+      this_thread::yield();
+    }
+  }
+  for (auto& producer : producers) {
+    producer.join();
+  }
+}
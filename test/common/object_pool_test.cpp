@@ -0,0 +1,49 @@
+#include "common/object_pool.h"
+
+#include <gtest/gtest.h>
+
+#include <string>
+#include <vector>
+
+using namespace std;
+using namespace slog;
+
+TEST(ObjectPoolTest, ReuseReleasedObjects) {
+  ObjectPool<string> pool(2);
+  auto a = pool.Acquire("a");
+  auto b = pool.Acquire("b");
+  ASSERT_EQ(*a, "a");
+  ASSERT_EQ(*b, "b");
+  ASSERT_EQ(pool.num_acquired(), 2U);
+  ASSERT_EQ(pool.capacity(), 2U);
+
+  auto a_addr = a.get();
+  a.reset();
+  ASSERT_EQ(pool.num_acquired(), 1U);
+
+  // The released slot is reused without allocating a new chunk
+  auto c = pool.Acquire("c");
+  ASSERT_EQ(c.get(), a_addr);
+  ASSERT_EQ(*c, "c");
+  ASSERT_EQ(pool.capacity(), 2U);
+
+  auto d = pool.Acquire("d");
+  ASSERT_EQ(pool.capacity(), 4U);
+  ASSERT_EQ(*b, "b");
+}
+
+TEST(ObjectPoolTest, StableAddresses) {
+  ObjectPool<int> pool(4);
+  vector<ObjectPool<int>::Ptr> objs;
+  vector<int*> addrs;
+  for (int i = 0; i < 100; i++) {
+    objs.push_back(pool.Acquire(i));
+    addrs.push_back(objs.back().get());
+  }
+  for (int i = 0; i < 100; i++) {
+    ASSERT_EQ(objs[i].get(), addrs[i]);
+    ASSERT_EQ(*objs[i], i);
+  }
+  objs.clear();
+  ASSERT_EQ(pool.num_acquired(), 0U);
+}
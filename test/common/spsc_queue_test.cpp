@@ -0,0 +1,106 @@
+#include "common/spsc_queue.h"
+
+#include <gtest/gtest.h>
+#include <poll.h>
+
+#include <thread>
+
+using namespace std;
+using namespace slog;
+
+namespace {
+bool IsNotified(int fd) {
+  pollfd item{.fd = fd, .events = POLLIN, .revents = 0};
+  return poll(&item, 1, 0) > 0;
+}
+
+void Reset(int fd) {
+  uint64_t val;
+  [[maybe_unused]] auto res = read(fd, &val, sizeof(val));
+}
+}  // namespace
+
+TEST(SpscQueueTest, PushAndPop) {
+  SpscQueue<int> queue(4);
+  int val;
+  ASSERT_FALSE(queue.Pop(val));
+
+  queue.Push(1);
+  queue.Push(2);
+  queue.Push(3);
+  ASSERT_TRUE(queue.Pop(val));
+  ASSERT_EQ(val, 1);
+  ASSERT_TRUE(queue.Pop(val));
+  ASSERT_EQ(val, 2);
+  ASSERT_TRUE(queue.Pop(val));
+  ASSERT_EQ(val, 3);
+  ASSERT_FALSE(queue.Pop(val));
+}
+
+TEST(SpscQueueTest, Overflow) {
+  SpscQueue<int> queue(2);
+  for (int i = 0; i < 5; i++) {
+    queue.Push(i);
+  }
+  // Only 2 items fit in the ring, the rest wait in the overflow list
+  ASSERT_TRUE(queue.Flush());
+
+  int val;
+  for (int i = 0; i < 5; i++) {
+    if (!queue.Pop(val)) {
+      queue.Flush();
+      ASSERT_TRUE(queue.Pop(val));
+    }
+    ASSERT_EQ(val, i);
+  }
+  ASSERT_FALSE(queue.Flush());
+  ASSERT_FALSE(queue.Pop(val));
+}
+
+TEST(SpscQueueTest, NotifyWhenEmpty) {
+  SpscQueue<int> queue(4);
+  ASSERT_FALSE(IsNotified(queue.notify_fd()));
+
+  queue.Push(1);
+  ASSERT_TRUE(IsNotified(queue.notify_fd()));
+  Reset(queue.notify_fd());
+
+  // The consumer has not caught up so there is no need to notify
+  queue.Push(2);
+  ASSERT_FALSE(IsNotified(queue.notify_fd()));
+
+  int val;
+  ASSERT_TRUE(queue.Pop(val));
+  ASSERT_TRUE(queue.Pop(val));
+  ASSERT_FALSE(queue.Pop(val));
+
+  queue.Push(3);
+  ASSERT_TRUE(IsNotified(queue.notify_fd()));
+}
+
+TEST(SpscQueueTest, ConcurrentProducerConsumer) {
+  const int kNumItems = 10000;
+  SpscQueue<int> queue(16);
+
+  std::thread producer([&queue] {
+    for (int i = 0; i < kNumItems; i++) {
+      queue.Push(i);
+      queue.Flush();
+    }
+    while (queue.Flush()) {
+      std::this_thread::yield();
+    }
+  });
+
+  int expected = 0;
+  while (expected < kNumItems) {
+    int val;
+    if (queue.Pop(val)) {
+      ASSERT_EQ(val, expected);
+      expected++;
+    } else {
+      std::this_thread::yield();
+    }
+  }
+  producer.join();
+}
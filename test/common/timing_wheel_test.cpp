@@ -0,0 +1,98 @@
+#include "common/timing_wheel.h"
+
+#include <gtest/gtest.h>
+
+#include <map>
+#include <random>
+
+using namespace std;
+using namespace slog;
+
+using Entries = vector<TimingWheel<int>::Entry>;
+
+TEST(TimingWheelTest, ExpireInOrder) {
+  TimingWheel<int> wheel(1000);
+  wheel.Insert(1010, 1);
+  wheel.Insert(1005, 2);
+  wheel.Insert(1010, 3);
+  ASSERT_EQ(wheel.size(), 3U);
+  ASSERT_EQ(wheel.NextTick(), 1005U);
+
+  Entries ready;
+  // Items expire only once the current tick is past their ticks
+  wheel.Advance(1005, ready);
+  ASSERT_TRUE(ready.empty());
+  wheel.Advance(1006, ready);
+  ASSERT_EQ(ready, (Entries{{1005, 2}}));
+  ASSERT_EQ(wheel.NextTick(), 1010U);
+
+  ready.clear();
+  wheel.Advance(2000, ready);
+  ASSERT_EQ(ready, (Entries{{1010, 1}, {1010, 3}}));
+  ASSERT_TRUE(wheel.empty());
+  ASSERT_FALSE(wheel.NextTick().has_value());
+}
+
+TEST(TimingWheelTest, PassedTick) {
+  TimingWheel<int> wheel(1000);
+  wheel.Insert(900, 1);
+  ASSERT_EQ(wheel.NextTick(), 1000U);
+
+  Entries ready;
+  wheel.Advance(1000, ready);
+  ASSERT_EQ(ready, (Entries{{900, 1}}));
+  ASSERT_TRUE(wheel.empty());
+}
+
+TEST(TimingWheelTest, CascadeAcrossLevels) {
+  TimingWheel<int> wheel(0);
+  // One item per level, including the overflow list
+  wheel.Insert(50, 0);
+  wheel.Insert(3000, 1);
+  wheel.Insert(200000, 2);
+  wheel.Insert(10000000, 3);
+  wheel.Insert(20000000, 4);
+
+  Entries ready;
+  for (uint64_t now : {51, 3001, 200001, 10000001, 20000001}) {
+    // The next tick is a lower bound that never passes the actual tick
+    auto next = wheel.NextTick();
+    ASSERT_TRUE(next.has_value());
+    ASSERT_LE(next.value(), now - 1);
+    wheel.Advance(now - 1, ready);
+    auto before = ready.size();
+    wheel.Advance(now, ready);
+    ASSERT_EQ(ready.size(), before + 1);
+    ASSERT_EQ(ready.back().first, now - 1);
+  }
+  ASSERT_TRUE(wheel.empty());
+}
+
+TEST(TimingWheelTest, MatchesOrderedMap) {
+  mt19937 rng(0);
+  uniform_int_distribution<uint64_t> delay(0, 30000000);
+  uniform_int_distribution<uint64_t> step(1, 100000);
+
+  TimingWheel<int> wheel(0);
+  multimap<uint64_t, int> expected;
+  uint64_t now = 0;
+  for (int i = 0; i < 20000; i++) {
+    auto tick = now + delay(rng) / (1 + (i % 1000));
+    wheel.Insert(tick, i);
+    expected.emplace(tick, i);
+
+    if (i % 10 == 0) {
+      now += step(rng);
+      Entries ready;
+      wheel.Advance(now, ready);
+      auto end = expected.lower_bound(now);
+      Entries expected_ready(expected.begin(), end);
+      expected.erase(expected.begin(), end);
+      ASSERT_EQ(ready, expected_ready);
+      ASSERT_EQ(wheel.size(), expected.size());
+      if (!expected.empty()) {
+        ASSERT_LE(wheel.NextTick().value(), expected.begin()->first);
+      }
+    }
+  }
+}
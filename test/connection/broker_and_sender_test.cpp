@@ -98,6 +98,87 @@ TEST(BrokerAndSenderTest, PingPong) {
   pong.join();
 }
 
+TEST(BrokerAndSenderTest, RawChannelReceivesMessageAsIs) {
+  const Channel PING = 8;
+  const Channel PONG = 9;
+  ConfigVec configs = MakeTestConfigurations("raw_channel", 1, 1, 2);
+
+  auto ping = thread([&]() {
+    // Set blocky to true to avoid exitting before sending the ping message
+    auto broker = Broker::New(configs[0], kTestModuleTimeout, true);
+    broker->AddChannel(Broker::ChannelOption(PING, false /* is_raw */));
+    broker->StartInNewThreads();
+
+    Sender sender(broker->config(), broker->context());
+    sender.Send(*MakePing(99), MakeMachineId(0, 0, 1), PONG);
+  });
+
+  auto pong = thread([&]() {
+    auto broker = Broker::New(configs[1], kTestModuleTimeout);
+    broker->AddChannel(Broker::ChannelOption(PONG, true /* is_raw */));
+    broker->StartInNewThreads();
+
+    auto socket = MakePullSocket(*broker->context(), PONG);
+
+    // The message arrives undeserialized, with the sender in its header
+    EnvelopePtr env;
+    zmq::message_t raw;
+    ASSERT_TRUE(RecvEnvelopeOrRawMessage(socket, env, raw));
+    ASSERT_EQ(env, nullptr);
+    MachineId from = -1;
+    ASSERT_TRUE(ParseMachineId(from, raw));
+    ASSERT_EQ(MakeMachineId(0, 0, 0), from);
+
+    auto req = DeserializeEnvelope(raw);
+    ASSERT_TRUE(req != nullptr);
+    ASSERT_EQ(MakeMachineId(0, 0, 0), req->from());
+    ASSERT_EQ(99, req->request().ping().src_time());
+  });
+
+  ping.join();
+  pong.join();
+}
+
+TEST(BrokerAndSenderTest, CoalescedMessages) {
+  const Channel PING = 8;
+  const Channel PONG = 9;
+  internal::Configuration extra_config;
+  extra_config.set_sender_coalescing_bytes(1000);
+  ConfigVec configs = MakeTestConfigurations("coalesced", 1, 1, 2, extra_config);
+
+  auto ping = thread([&]() {
+    // Set blocky to true to avoid exitting before sending the ping messages
+    auto broker = Broker::New(configs[0], kTestModuleTimeout, true);
+    broker->AddChannel(Broker::ChannelOption(PING, false /* is_raw */));
+    broker->StartInNewThreads();
+
+    Sender sender(broker->config(), broker->context());
+    for (int i = 0; i < 5; i++) {
+      sender.Send(*MakePing(i), MakeMachineId(0, 0, 1), PONG);
+    }
+    sender.Flush();
+  });
+
+  auto pong = thread([&]() {
+    auto broker = Broker::New(configs[1], kTestModuleTimeout);
+    broker->AddChannel(Broker::ChannelOption(PONG, false /* is_raw */));
+    broker->StartInNewThreads();
+
+    auto socket = MakePullSocket(*broker->context(), PONG);
+
+    // The messages are split by the broker and arrive in the order that they were sent
+    for (int i = 0; i < 5; i++) {
+      auto req = RecvEnvelope(socket);
+      ASSERT_TRUE(req != nullptr);
+      ASSERT_EQ(MakeMachineId(0, 0, 0), req->from());
+      ASSERT_EQ(i, req->request().ping().src_time());
+    }
+  });
+
+  ping.join();
+  pong.join();
+}
+
 TEST(BrokerTest, LocalPingPong) {
   const Channel PING = 8;
   const Channel PONG = 9;
@@ -4,6 +4,7 @@
 
 #include <iostream>
 
+#include "common/constants.h"
 #include "proto/internal.pb.h"
 
 using namespace std;
@@ -116,4 +117,136 @@ TEST(ZmqUtilsTest, FailedParsing) {
   ASSERT_FALSE(ParseChannel(chan, msg));
   Request req;
   ASSERT_FALSE(DeserializeProto(req, msg));
-}
\ No newline at end of file
+}
+TEST(ZmqUtilsTest, SerializeForwardBatchData) {
+  internal::Envelope env;
+  auto forward_batch = env.mutable_request()->mutable_forward_batch_data();
+  forward_batch->set_generator(3);
+  forward_batch->set_generator_position(300);
+  vector<string> serialized_batches;
+  for (int i = 0; i < 3; i++) {
+    auto batch = forward_batch->add_batch_data();
+    batch->set_id(100 + i);
+    batch->add_transactions()->mutable_internal()->set_id(1000 + i);
+    serialized_batches.push_back(batch->SerializeAsString());
+  }
+
+  // Compare the buffers past the headers, which are not filled in yet
+  auto header_sz = sizeof(MachineId) + sizeof(Channel);
+  auto expected = SerializeProto(env);
+  auto actual = SerializeForwardBatchData({serialized_batches.begin(), serialized_batches.end()}, 3, 300);
+  ASSERT_EQ(actual.to_string().substr(header_sz), expected.to_string().substr(header_sz));
+
+  internal::Envelope env2;
+  ASSERT_TRUE(DeserializeProto(env2, actual));
+  ASSERT_EQ(env2.request().forward_batch_data().batch_data_size(), 3);
+  ASSERT_EQ(env2.request().forward_batch_data().batch_data(2).id(), 102U);
+  ASSERT_EQ(env2.request().forward_batch_data().generator_position(), 300U);
+}
+
+TEST(ZmqUtilsTest, FindSerializedBatchData) {
+  internal::Envelope env;
+  auto forward_batch = env.mutable_request()->mutable_forward_batch_data();
+  forward_batch->set_generator(3);
+  for (int i = 0; i < 3; i++) {
+    forward_batch->add_batch_data()->set_id(100 + i);
+  }
+  auto serialized = SerializeProto(env).to_string();
+
+  vector<string_view> batch_data;
+  ASSERT_TRUE(FindSerializedBatchData(serialized, batch_data));
+  ASSERT_EQ(batch_data.size(), 3U);
+  for (int i = 0; i < 3; i++) {
+    internal::Batch batch;
+    ASSERT_TRUE(batch.ParseFromArray(batch_data[i].data(), batch_data[i].size()));
+    ASSERT_EQ(batch.id(), 100U + i);
+  }
+
+  // Not a ForwardBatchData request
+  internal::Envelope ping_env;
+  ping_env.mutable_request()->mutable_ping()->set_src_time(99);
+  ASSERT_FALSE(FindSerializedBatchData(SerializeProto(ping_env).to_string(), batch_data));
+  ASSERT_FALSE(FindSerializedBatchData(serialized.substr(0, serialized.size() - 1), batch_data));
+}
+
+TEST(ZmqUtilsTest, LeanWireFormat) {
+  internal::Envelope env;
+  env.mutable_request()->mutable_ping()->set_src_time(99);
+
+  auto any = SerializeProto(env);
+  auto lean = SerializeProto(env, internal::WireFormat::LEAN);
+  ASSERT_LT(lean.size(), any.size());
+
+  // Both formats are read the same way
+  for (auto msg : {&any, &lean}) {
+    internal::Envelope env2;
+    ASSERT_TRUE(DeserializeProto(env2, *msg));
+    ASSERT_EQ(env2.request().ping().src_time(), 99);
+  }
+
+  // The message type in the frame header must match
+  internal::Request req;
+  ASSERT_FALSE(DeserializeProto(req, lean));
+
+  // Messages without a lean message type fall back to the Any format
+  req.mutable_ping()->set_src_time(99);
+  auto req_msg = SerializeProto(req, internal::WireFormat::LEAN);
+  internal::Request req2;
+  ASSERT_TRUE(DeserializeProto(req2, req_msg));
+  ASSERT_EQ(req2.ping().src_time(), 99);
+}
+
+TEST(ZmqUtilsTest, SerializeForwardBatchDataLean) {
+  internal::Envelope env;
+  auto forward_batch = env.mutable_request()->mutable_forward_batch_data();
+  forward_batch->set_generator(3);
+  forward_batch->set_generator_position(300);
+  vector<string> serialized_batches;
+  for (int i = 0; i < 3; i++) {
+    auto batch = forward_batch->add_batch_data();
+    batch->set_id(100 + i);
+    serialized_batches.push_back(batch->SerializeAsString());
+  }
+
+  auto header_sz = sizeof(MachineId) + sizeof(Channel);
+  auto expected = SerializeProto(env, internal::WireFormat::LEAN);
+  auto actual = SerializeForwardBatchData({serialized_batches.begin(), serialized_batches.end()}, 3, 300,
+                                          internal::WireFormat::LEAN);
+  ASSERT_EQ(actual.to_string().substr(header_sz), expected.to_string().substr(header_sz));
+
+  vector<string_view> batch_data;
+  auto serialized = actual.to_string();
+  ASSERT_TRUE(FindSerializedBatchData(serialized, batch_data));
+  ASSERT_EQ(batch_data.size(), 3U);
+  for (int i = 0; i < 3; i++) {
+    ASSERT_EQ(batch_data[i], serialized_batches[i]);
+  }
+}
+
+TEST(ZmqUtilsTest, CoalesceMessages) {
+  vector<zmq::message_t> msgs;
+  for (int i = 0; i < 3; i++) {
+    internal::Envelope env;
+    env.mutable_request()->mutable_ping()->set_src_time(i);
+    msgs.push_back(SerializeProto(env));
+    AddressBuffer(msgs.back(), 1, 2 + i);
+  }
+  auto frame = CoalesceMessages(msgs);
+  AddressBuffer(frame, 1, kCoalescedMessagesTag);
+
+  int i = 0;
+  ASSERT_TRUE(ForEachCoalescedMessage(frame, [&i](zmq::message_t&& msg) {
+    Channel chan;
+    ASSERT_TRUE(ParseChannel(chan, msg));
+    ASSERT_EQ(chan, 2U + i);
+    internal::Envelope env;
+    ASSERT_TRUE(DeserializeProto(env, msg));
+    ASSERT_EQ(env.request().ping().src_time(), i);
+    i++;
+  }));
+  ASSERT_EQ(i, 3);
+
+  // Truncated frame
+  zmq::message_t truncated(frame.data(), frame.size() - 1);
+  ASSERT_FALSE(ForEachCoalescedMessage(truncated, [](zmq::message_t&&) {}));
+}
@@ -54,8 +54,8 @@ class E2ETest : public ::testing::TestWithParam<tuple<bool, int, int, int>> {
           slog.AddForwarder();
           slog.AddMultiHomeOrderer();
           slog.AddSequencer();
-          slog.AddLogManagers();
           slog.AddScheduler();
+          slog.AddLogManagers();
           slog.AddLocalPaxos();
           // One region is selected to globally order the multihome batches
           if (config->leader_region_for_multi_home_ordering() == config->local_region()) {
@@ -0,0 +1,53 @@
+#include "module/forwarder_components/latency_estimator.h"
+
+#include <gtest/gtest.h>
+
+using namespace std;
+using namespace slog;
+
+TEST(LatencyEstimatorTest, Average) {
+  LatencyEstimator estimator(3, 0);
+  ASSERT_EQ(estimator.estimate(), 0);
+  estimator.Add(10);
+  estimator.Add(20);
+  ASSERT_EQ(estimator.estimate(), 15);
+  estimator.Add(30);
+  estimator.Add(40);
+  // 10 has left the window
+  ASSERT_EQ(estimator.estimate(), 30);
+  ASSERT_EQ(estimator.avg(), 30);
+}
+
+TEST(LatencyEstimatorTest, Percentile) {
+  LatencyEstimator estimator(100, 99);
+  for (int i = 1; i <= 100; i++) {
+    estimator.Add(i);
+  }
+  ASSERT_EQ(estimator.estimate(), 99);
+  ASSERT_EQ(estimator.avg(), 50.5);
+}
+
+TEST(LatencyEstimatorTest, PercentileCoversSpikes) {
+  LatencyEstimator estimator(10, 90);
+  for (int i = 0; i < 8; i++) {
+    estimator.Add(100);
+  }
+  estimator.Add(500);
+  estimator.Add(100);
+  ASSERT_EQ(estimator.estimate(), 100);
+  estimator.Add(400);
+  ASSERT_EQ(estimator.estimate(), 400);
+  ASSERT_LT(estimator.avg(), 200);
+}
+
+TEST(LatencyEstimatorTest, MaxPercentile) {
+  LatencyEstimator estimator(4, 100);
+  estimator.Add(5);
+  estimator.Add(1);
+  estimator.Add(3);
+  ASSERT_EQ(estimator.estimate(), 5);
+  estimator.Add(2);
+  estimator.Add(2);
+  // 5 has left the window
+  ASSERT_EQ(estimator.estimate(), 3);
+}
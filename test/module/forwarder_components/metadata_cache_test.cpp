@@ -0,0 +1,64 @@
+#include "module/forwarder_components/metadata_cache.h"
+
+#include <gtest/gtest.h>
+
+using namespace std;
+using namespace slog;
+
+TEST(MetadataCacheTest, GetAfterPut) {
+  MetadataCache cache(10);
+  Metadata metadata;
+  ASSERT_FALSE(cache.Get("A", metadata));
+  cache.Put("A", Metadata(1, 2));
+  ASSERT_TRUE(cache.Get("A", metadata));
+  ASSERT_EQ(metadata.master, 1);
+  ASSERT_EQ(metadata.counter, 2);
+  ASSERT_EQ(cache.num_hits(), 1);
+  ASSERT_EQ(cache.num_misses(), 1);
+}
+
+TEST(MetadataCacheTest, EvictLeastRecentlyUsed) {
+  MetadataCache cache(2);
+  Metadata metadata;
+  cache.Put("A", Metadata(0));
+  cache.Put("B", Metadata(1));
+  // Use A so that B is evicted next
+  ASSERT_TRUE(cache.Get("A", metadata));
+  cache.Put("C", Metadata(2));
+  ASSERT_EQ(cache.size(), 2);
+  ASSERT_TRUE(cache.Get("A", metadata));
+  ASSERT_FALSE(cache.Get("B", metadata));
+  ASSERT_TRUE(cache.Get("C", metadata));
+  ASSERT_EQ(metadata.master, 2);
+}
+
+TEST(MetadataCacheTest, IgnoreOutdatedMetadata) {
+  MetadataCache cache(10);
+  Metadata metadata;
+  cache.Put("A", Metadata(0, 0));
+  cache.Update("A", Metadata(1, 1));
+  ASSERT_TRUE(cache.Get("A", metadata));
+  ASSERT_EQ(metadata.master, 1);
+  ASSERT_EQ(metadata.counter, 1);
+
+  // A lookup response sent before the remaster arrives late
+  cache.Put("A", Metadata(0, 0));
+  ASSERT_TRUE(cache.Get("A", metadata));
+  ASSERT_EQ(metadata.master, 1);
+  ASSERT_EQ(metadata.counter, 1);
+}
+
+TEST(MetadataCacheTest, UpdateDoesNotAddKey) {
+  MetadataCache cache(10);
+  Metadata metadata;
+  cache.Update("A", Metadata(1, 1));
+  ASSERT_EQ(cache.size(), 0);
+  ASSERT_FALSE(cache.Get("A", metadata));
+}
+
+TEST(MetadataCacheTest, Disabled) {
+  MetadataCache cache(0);
+  Metadata metadata;
+  cache.Put("A", Metadata(1));
+  ASSERT_FALSE(cache.Get("A", metadata));
+}
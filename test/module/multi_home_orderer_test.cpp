@@ -0,0 +1,88 @@
+#include "module/multi_home_orderer.h"
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+#include "common/constants.h"
+#include "common/proto_utils.h"
+#include "test/test_utils.h"
+
+using namespace std;
+using namespace slog;
+
+using internal::Envelope;
+using internal::Request;
+
+class MultiHomeOrdererTest : public ::testing::Test {
+ protected:
+  static constexpr int kBatchSize = 2;
+  static constexpr int kBatchDurationMs = 500;
+
+  void SetUp() {
+    internal::Configuration extra_config;
+    extra_config.set_mh_orderer_batch_duration(kBatchDurationMs);
+    extra_config.set_mh_orderer_batch_size(kBatchSize);
+    configs_ = MakeTestConfigurations("mh_orderer", 2 /* num_regions */, 1 /* num_replicas */,
+                                      1 /* num_partitions */, extra_config);
+
+    for (int i = 0; i < 2; i++) {
+      slog_[i] = make_unique<TestSlog>(configs_[i]);
+      senders_[i] = slog_[i]->NewSender();
+    }
+    // The orderer of region 0 proposes its batches to the global paxos on the same machine
+    slog_[0]->AddMultiHomeOrderer();
+    slog_[0]->AddOutputSocket(kGlobalPaxos);
+    slog_[1]->AddOutputSocket(kMultiHomeOrdererChannel);
+
+    for (auto& slog : slog_) {
+      slog->StartInNewThreads();
+    }
+  }
+
+  void SendToOrderer(TxnId id) {
+    auto txn = MakeTestTransaction(configs_[0], id, {{"A", KeyType::READ, 0}, {"B", KeyType::WRITE, 1}});
+    txn->mutable_internal()->set_type(TransactionType::MULTI_HOME_OR_LOCK_ONLY);
+    txn->mutable_internal()->add_involved_regions(0);
+    txn->mutable_internal()->add_involved_regions(1);
+
+    auto env = make_unique<Envelope>();
+    env->mutable_request()->mutable_forward_txn()->set_allocated_txn(txn);
+    senders_[0]->Send(move(env), kMultiHomeOrdererChannel);
+  }
+
+  EnvelopePtr ReceiveProposal(std::chrono::milliseconds timeout) {
+    vector<zmq::pollitem_t> poll_items{slog_[0]->GetPollItemForOutputSocket(kGlobalPaxos)};
+    if (zmq::poll(poll_items, timeout) <= 0) {
+      return nullptr;
+    }
+    return slog_[0]->ReceiveFromOutputSocket(kGlobalPaxos);
+  }
+
+  unique_ptr<Sender> senders_[2];
+  unique_ptr<TestSlog> slog_[2];
+  ConfigVec configs_;
+};
+
+TEST_F(MultiHomeOrdererTest, SendFullBatchBeforeWindowCloses) {
+  for (int i = 0; i < kBatchSize; i++) {
+    SendToOrderer(1000 + i);
+  }
+
+  // The batch is full so it is proposed well before its window closes
+  auto proposal = ReceiveProposal(std::chrono::milliseconds(kBatchDurationMs / 2));
+  ASSERT_TRUE(proposal != nullptr);
+  ASSERT_EQ(proposal->request().type_case(), Request::kPaxosPropose);
+  auto batch_id = proposal->request().paxos_propose().value();
+
+  // The data of the same batch is replicated to the other region
+  auto batch_data = slog_[1]->ReceiveFromOutputSocket(kMultiHomeOrdererChannel);
+  ASSERT_TRUE(batch_data != nullptr);
+  ASSERT_EQ(batch_data->request().type_case(), Request::kForwardBatchData);
+  auto& batch = batch_data->request().forward_batch_data().batch_data(0);
+  ASSERT_EQ(batch.id(), batch_id);
+  ASSERT_EQ(batch.transactions_size(), kBatchSize);
+
+  // The timer of the sent batch was cancelled so nothing else is sent when the window would have closed
+  ASSERT_EQ(ReceiveProposal(std::chrono::milliseconds(kBatchDurationMs * 2)), nullptr);
+}
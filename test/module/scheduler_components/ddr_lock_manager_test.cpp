@@ -220,9 +220,11 @@ class DDRLockManagerWithResolverTest : public ::testing::Test {
  protected:
   std::deque<DDRLockManager> lock_managers;
 
-  slog::ConfigVec Initialize(int num_regions, int num_partitions, int ddr_interval = 0) {
+  slog::ConfigVec Initialize(int num_regions, int num_partitions, int ddr_interval = 0,
+                             bool compact_graph_log = false) {
     internal::Configuration add_on;
     add_on.set_ddr_interval(ddr_interval);
+    add_on.set_ddr_compact_graph_log(compact_graph_log);
     auto configs = MakeTestConfigurations("locking", num_regions, 1, num_partitions, add_on);
 
     for (auto config : configs) {
@@ -331,6 +333,40 @@ TEST_F(DDRLockManagerWithResolverTest, SimplePartitionedDeadlock) {
   }
 }
 
+TEST_F(DDRLockManagerWithResolverTest, SimplePartitionedDeadlockWithCompactGraphLog) {
+  auto configs = Initialize(2, 2, 0, true /* compact_graph_log */);
+
+  StartBrokers();
+
+  // Partition 0
+  auto holder1_0 = MakeTestTxnHolder(configs[0], 1000, {{"A", KeyType::WRITE, 0}, {"B", KeyType::WRITE, 1}});
+  auto holder2_0 = MakeTestTxnHolder(configs[0], 2000, {{"A", KeyType::WRITE, 0}, {"B", KeyType::WRITE, 1}});
+  // Lock queues on this partition:
+  // A: 1000 2000
+  ASSERT_EQ(lock_managers[0].AcquireLocks(holder1_0.lock_only_txn(0)), AcquireLocksResult::ACQUIRED);
+  ASSERT_EQ(lock_managers[0].AcquireLocks(holder2_0.lock_only_txn(0)), AcquireLocksResult::WAITING);
+
+  lock_managers[0].ResolveDeadlock(true /* dont_recv_remote_msg */);
+  ASSERT_FALSE(HasSignalFromResolver(0));
+
+  // Partition 1
+  auto holder1_1 = MakeTestTxnHolder(configs[1], 1000, {{"A", KeyType::WRITE, 0}, {"B", KeyType::WRITE, 1}});
+  auto holder2_1 = MakeTestTxnHolder(configs[1], 2000, {{"A", KeyType::WRITE, 0}, {"B", KeyType::WRITE, 1}});
+  // Lock queues on this partition:
+  // B: 2000 1000
+  ASSERT_EQ(lock_managers[1].AcquireLocks(holder2_1.lock_only_txn(1)), AcquireLocksResult::ACQUIRED);
+  ASSERT_EQ(lock_managers[1].AcquireLocks(holder1_1.lock_only_txn(1)), AcquireLocksResult::WAITING);
+
+  // The edge 1000 -> 2000 is decoded from the compact log sent by partition 0
+  lock_managers[1].ResolveDeadlock();
+  ASSERT_TRUE(HasSignalFromResolver(1));
+  ASSERT_THAT(lock_managers[1].GetReadyTxns(), ElementsAre(1000));
+
+  lock_managers[0].ResolveDeadlock();
+  ASSERT_TRUE(HasSignalFromResolver(0));
+  ASSERT_THAT(lock_managers[0].GetReadyTxns(), ElementsAre(1000));
+}
+
 TEST_F(DDRLockManagerWithResolverTest, IdempotentDeadlockSignal) {
   auto configs = Initialize(2, 2);
 
@@ -68,7 +68,7 @@ TEST(OldLockManager, ReleaseLocksAndGetManyNewHolders) {
   // Txn 300 was removed from the wait list due to the
   // ReleaseLocks call above
   ASSERT_EQ(ready_txns.size(), 2U);
-  ASSERT_THAT(ready_txns, UnorderedElementsAre(200, 400));
+  ASSERT_THAT(ready_txns, UnorderedElementsAre(make_pair(200, false), make_pair(400, false)));
 }
 
 TEST(OldLockManager, PartiallyAcquiredLocks) {
@@ -84,10 +84,10 @@ TEST(OldLockManager, PartiallyAcquiredLocks) {
   ASSERT_EQ(lock_manager.AcquireLocks(holder3.lock_only_txn(0)), AcquireLocksResult::WAITING);
 
   auto ready_txns = lock_manager.ReleaseLocks(holder1.txn_id());
-  ASSERT_THAT(ready_txns, ElementsAre(200));
+  ASSERT_THAT(ready_txns, ElementsAre(make_pair(200, false)));
 
   ready_txns = lock_manager.ReleaseLocks(holder2.txn_id());
-  ASSERT_THAT(ready_txns, ElementsAre(300));
+  ASSERT_THAT(ready_txns, ElementsAre(make_pair(300, false)));
 }
 
 TEST(OldLockManager, AcquireLocksWithLockOnlyholder1) {
@@ -102,7 +102,7 @@ TEST(OldLockManager, AcquireLocksWithLockOnlyholder1) {
   ASSERT_EQ(lock_manager.AcquireLocks(holder2.lock_only_txn(2)), AcquireLocksResult::ACQUIRED);
 
   auto ready_txns = lock_manager.ReleaseLocks(holder2.txn_id());
-  ASSERT_THAT(ready_txns, ElementsAre(100));
+  ASSERT_THAT(ready_txns, ElementsAre(make_pair(100, false)));
 }
 
 TEST(OldLockManager, AcquireLocksWithLockOnlyholder2) {
@@ -117,5 +117,5 @@ TEST(OldLockManager, AcquireLocksWithLockOnlyholder2) {
   ASSERT_EQ(lock_manager.AcquireLocks(holder2.lock_only_txn(2)), AcquireLocksResult::WAITING);
 
   auto ready_txns = lock_manager.ReleaseLocks(holder1.txn_id());
-  ASSERT_THAT(ready_txns, ElementsAre(200));
+  ASSERT_THAT(ready_txns, ElementsAre(make_pair(200, false)));
 }
@@ -65,7 +65,7 @@ TEST(RMALockManagerTest, ReleaseLocksAndGetMultipleNewLockHolders) {
   auto result = lock_manager.ReleaseLocks(holder1.txn_id());
   // Txn 300 was removed from the wait list due to the
   // ReleaseLocks call above
-  ASSERT_THAT(result, UnorderedElementsAre(200, 400));
+  ASSERT_THAT(result, UnorderedElementsAre(make_pair(200, false), make_pair(400, false)));
 }
 
 TEST(RMALockManagerTest, PartiallyAcquiredLocks) {
@@ -81,10 +81,10 @@ TEST(RMALockManagerTest, PartiallyAcquiredLocks) {
   ASSERT_EQ(lock_manager.AcquireLocks(holder3.lock_only_txn(0)), AcquireLocksResult::WAITING);
 
   auto result = lock_manager.ReleaseLocks(holder1.txn_id());
-  ASSERT_THAT(result, ElementsAre(200));
+  ASSERT_THAT(result, ElementsAre(make_pair(200, false)));
 
   result = lock_manager.ReleaseLocks(holder2.txn_id());
-  ASSERT_THAT(result, ElementsAre(300));
+  ASSERT_THAT(result, ElementsAre(make_pair(300, false)));
 }
 
 TEST(RMALockManagerTest, AcquireLocksWithLockOnly1) {
@@ -99,7 +99,7 @@ TEST(RMALockManagerTest, AcquireLocksWithLockOnly1) {
   ASSERT_EQ(lock_manager.AcquireLocks(holder2.lock_only_txn(1)), AcquireLocksResult::ACQUIRED);
 
   auto result = lock_manager.ReleaseLocks(holder2.txn_id());
-  ASSERT_THAT(result, ElementsAre(100));
+  ASSERT_THAT(result, ElementsAre(make_pair(100, false)));
 }
 
 TEST(RMALockManagerTest, AcquireLocksWithLockOnly2) {
@@ -114,7 +114,7 @@ TEST(RMALockManagerTest, AcquireLocksWithLockOnly2) {
   ASSERT_EQ(lock_manager.AcquireLocks(holder2.lock_only_txn(0)), AcquireLocksResult::WAITING);
 
   auto result = lock_manager.ReleaseLocks(holder1.txn_id());
-  ASSERT_THAT(result, ElementsAre(200));
+  ASSERT_THAT(result, ElementsAre(make_pair(200, false)));
 }
 
 TEST(RMALockManagerTest, KeyRegionLocks) {
@@ -1,7 +1,12 @@
 #include <gtest/gtest.h>
 
+#include <algorithm>
+#include <map>
+#include <thread>
 #include <vector>
 
+#include "common/constants.h"
+#include "common/json_utils.h"
 #include "common/proto_utils.h"
 #include "test/test_utils.h"
 
@@ -95,6 +100,49 @@ class SchedulerTest : public ::testing::Test {
 
   MachineId MakeMachineId(int region, int partition) { return region * kNumPartitions + partition; }
 
+  // The stats come back on the server channel so the txns whose stats are requested must be coordinated
+  // by another machine
+  rapidjson::Document GetSchedulerStats(MachineId machine) {
+    auto env = make_unique<internal::Envelope>();
+    env->mutable_request()->mutable_stats()->set_level(0);
+    sender[machine]->Send(move(env), kSchedulerChannel);
+    auto res_env = test_slogs[machine]->ReceiveFromOutputSocket(kServerChannel);
+    CHECK(res_env != nullptr);
+    CHECK(res_env->response().has_stats());
+    rapidjson::Document stats;
+    stats.Parse(res_env->response().stats().stats_json().c_str());
+    return stats;
+  }
+
+  // Returns the stats of the scheduler once it has no txn left
+  rapidjson::Document WaitForIdleSchedulerStats(MachineId machine) {
+    for (int i = 0; i < 100; i++) {
+      auto stats = GetSchedulerStats(machine);
+      if (stats[NUM_ALL_TXNS].GetInt() == 0) {
+        return stats;
+      }
+      this_thread::sleep_for(10ms);
+    }
+    LOG(FATAL) << "Scheduler of machine " << machine << " still has txns";
+    return rapidjson::Document();
+  }
+
+  // Returns the worker loads once they reach the expected loads or the last loads seen after a timeout
+  vector<int> WaitForWorkerLoads(MachineId machine, const vector<int>& expected) {
+    vector<int> loads;
+    for (int i = 0; i < 100 && loads != expected; i++) {
+      if (i > 0) {
+        this_thread::sleep_for(10ms);
+      }
+      auto stats = GetSchedulerStats(machine);
+      loads.clear();
+      for (const auto& load : stats[WORKER_LOADS].GetArray()) {
+        loads.push_back(load.GetInt());
+      }
+    }
+    return loads;
+  }
+
   unique_ptr<TestSlog> test_slogs[kNumMachines];
   unique_ptr<Sender> sender[kNumMachines];
 };
@@ -368,6 +416,41 @@ TEST_F(SchedulerTest, AbortSingleHomeMultiPartition2Active) {
   ASSERT_EQ(output_txn.status(), TransactionStatus::ABORTED);
 }
 
+TEST_F(SchedulerTest, AbortMultiPartitionThenCommit) {
+  // Y has outdated master information so the partition of Y aborts the txn while
+  // the other partitions may still be waiting for remote reads
+  auto txn1 = MakeTestTransaction(
+      test_slogs[0]->config(), 1000,
+      {{"Y", KeyType::READ, {{1, 1}}}, {"C", KeyType::WRITE, {{1, 0}}}, {"B", KeyType::WRITE, {{1, 0}}}},
+      {{"GET", "Y"}, {"SET", "C", "newC"}, {"SET", "B", "newB"}}, {}, MakeMachineId(0, 1));
+  auto txn2 = MakeTestTransaction(test_slogs[0]->config(), 2000,
+                                  {{"C", KeyType::WRITE, {{0, 1}}}, {"B", KeyType::WRITE, {{0, 1}}}},
+                                  {{"SET", "C", "newC"}, {"SET", "B", "newB"}}, {}, MakeMachineId(0, 1));
+
+  SendTransaction(txn1);
+  SendTransaction(txn2);
+
+  // The late remote reads of the aborted txn must not interfere with the next txn
+  map<TxnId, Transaction> output_txns;
+  for (int i = 0; i < 5; i++) {
+    auto req_env = test_slogs[1]->ReceiveFromOutputSocket(kServerChannel);
+    ASSERT_NE(req_env, nullptr);
+    const auto& sub_txn = req_env->request().finished_subtxn().txn();
+    auto [it, inserted] = output_txns.try_emplace(sub_txn.internal().id(), sub_txn);
+    if (!inserted) {
+      MergeTransaction(it->second, sub_txn);
+    }
+  }
+
+  ASSERT_EQ(output_txns.size(), 2U);
+  LOG(INFO) << output_txns[1000];
+  ASSERT_EQ(output_txns[1000].status(), TransactionStatus::ABORTED);
+  LOG(INFO) << output_txns[2000];
+  ASSERT_EQ(output_txns[2000].status(), TransactionStatus::COMMITTED);
+  ASSERT_EQ(TxnValueEntry(output_txns[2000], "C").new_value(), "newC");
+  ASSERT_EQ(TxnValueEntry(output_txns[2000], "B").new_value(), "newB");
+}
+
 TEST_F(SchedulerTest, AbortMultiHomeMultiPartition2Active) {
   // D and X have outdated master information
   auto txn = MakeTestTransaction(test_slogs[0]->config(), 1000,
@@ -389,7 +472,221 @@ TEST_F(SchedulerTest, AbortMultiHomeMultiPartition2Active) {
   ASSERT_EQ(output_txn.status(), TransactionStatus::ABORTED);
 }
 
-#ifdef LOCK_MANAGER_DDR
+class SchedulerTestWithEarlyAbort : public SchedulerTest {
+ protected:
+  // Aborted txns only finish before receiving all of their remote reads under a non-DDR lock manager
+  ConfigVec MakeConfigs() final {
+    internal::Configuration add_on;
+    add_on.set_lock_manager(internal::LockManagerType::RMA);
+    return MakeTestConfigurations("scheduler", kNumRegions, 1, kNumPartitions, add_on);
+  }
+};
+
+TEST_F(SchedulerTestWithEarlyAbort, AbortBeforeReceivingRemoteReads) {
+  // txn0 holds the lock of B so the partition of B sends its reads for txn1 late
+  auto txn0 = MakeTestTransaction(test_slogs[0]->config(), 1000, {{"B", KeyType::WRITE, {{0, 1}}}},
+                                  {{"SLEEP", "300"}, {"SET", "B", "B0"}}, {}, MakeMachineId(0, 1));
+  // X has outdated master information so the partition of X aborts txn1 right away
+  auto txn1 = MakeTestTransaction(
+      test_slogs[0]->config(), 2000,
+      {{"A", KeyType::READ, {{0, 1}}}, {"X", KeyType::WRITE, {{0, 1}}}, {"B", KeyType::WRITE, {{0, 1}}}},
+      {{"GET", "A"}, {"SET", "X", "X1"}, {"SET", "B", "B1"}}, {}, MakeMachineId(0, 1));
+  auto txn2 = MakeTestTransaction(test_slogs[0]->config(), 3000, {{"X", KeyType::WRITE, {{1, 1}}}},
+                                  {{"SET", "X", "X2"}}, {}, MakeMachineId(0, 1));
+
+  SendTransaction(txn0);
+  SendTransaction(txn1);
+  SendTransaction(txn2);
+
+  // txn2 gets the lock of X released by the early abort of txn1 and finishes while txn0 is still running
+  map<TxnId, Transaction> output_txns;
+  for (int i = 0; i < 5; i++) {
+    auto req_env = test_slogs[1]->ReceiveFromOutputSocket(kServerChannel);
+    ASSERT_NE(req_env, nullptr);
+    const auto& sub_txn = req_env->request().finished_subtxn().txn();
+    if (sub_txn.internal().id() == 3000) {
+      ASSERT_EQ(output_txns.count(1000), 0U);
+    }
+    auto [it, inserted] = output_txns.try_emplace(sub_txn.internal().id(), sub_txn);
+    if (!inserted) {
+      MergeTransaction(it->second, sub_txn);
+    }
+  }
+
+  ASSERT_EQ(output_txns.size(), 3U);
+  ASSERT_EQ(output_txns[1000].status(), TransactionStatus::COMMITTED);
+  ASSERT_EQ(output_txns[2000].status(), TransactionStatus::ABORTED);
+  ASSERT_EQ(output_txns[3000].status(), TransactionStatus::COMMITTED);
+  ASSERT_EQ(TxnValueEntry(output_txns[3000], "X").new_value(), "X2");
+
+  // The late remote reads of txn1 are absorbed by the partition of X without interfering with the next
+  // txn on that partition, and the write of txn1 to B is discarded
+  auto txn3 = MakeTestTransaction(test_slogs[0]->config(), 4000,
+                                  {{"B", KeyType::READ, {{0, 1}}}, {"C", KeyType::WRITE, {{0, 1}}}},
+                                  {{"COPY", "B", "C"}}, {}, MakeMachineId(0, 1));
+
+  SendTransaction(txn3);
+
+  auto output_txn = ReceiveMultipleAndMerge(1, 2);
+  LOG(INFO) << output_txn;
+  ASSERT_EQ(output_txn.status(), TransactionStatus::COMMITTED);
+  ASSERT_EQ(TxnValueEntry(output_txn, "B").value(), "B0");
+  ASSERT_EQ(TxnValueEntry(output_txn, "C").new_value(), "B0");
+}
+
+class SchedulerTestWithCoalescedRemoteReads : public SchedulerTest {
+ protected:
+  ConfigVec MakeConfigs() final {
+    internal::Configuration add_on;
+    add_on.set_remote_read_batch_duration_us(1000);
+    add_on.set_num_workers(2);
+    return MakeTestConfigurations("scheduler", kNumRegions, 1, kNumPartitions, add_on);
+  }
+};
+
+TEST_F(SchedulerTestWithCoalescedRemoteReads, MultiPartitionTransactions) {
+  // Both txns exchange remote reads between partitions 1 and 2, possibly in the same batch
+  auto txn1 = MakeTestTransaction(test_slogs[0]->config(), 1000,
+                                  {{"B", KeyType::WRITE, {{0, 1}}}, {"C", KeyType::WRITE, {{0, 1}}}},
+                                  {{"COPY", "C", "B"}, {"COPY", "B", "C"}});
+  auto txn2 =
+      MakeTestTransaction(test_slogs[0]->config(), 2000,
+                          {{"E", KeyType::READ, {{0, 1}}}, {"F", KeyType::WRITE, {{0, 1}}}}, {{"COPY", "E", "F"}});
+
+  SendTransaction(txn1);
+  SendTransaction(txn2);
+
+  map<TxnId, Transaction> output_txns;
+  for (int i = 0; i < 4; i++) {
+    auto req_env = test_slogs[0]->ReceiveFromOutputSocket(kServerChannel);
+    ASSERT_NE(req_env, nullptr);
+    const auto& sub_txn = req_env->request().finished_subtxn().txn();
+    auto [it, inserted] = output_txns.try_emplace(sub_txn.internal().id(), sub_txn);
+    if (!inserted) {
+      MergeTransaction(it->second, sub_txn);
+    }
+  }
+
+  ASSERT_EQ(output_txns.size(), 2U);
+  ASSERT_EQ(output_txns[1000].status(), TransactionStatus::COMMITTED);
+  ASSERT_EQ(TxnValueEntry(output_txns[1000], "B").new_value(), "valueC");
+  ASSERT_EQ(TxnValueEntry(output_txns[1000], "C").new_value(), "valueB");
+  ASSERT_EQ(output_txns[2000].status(), TransactionStatus::COMMITTED);
+  ASSERT_EQ(TxnValueEntry(output_txns[2000], "F").new_value(), "valueE");
+}
+
+class SchedulerTestWithSpeculation : public SchedulerTest {
+ protected:
+  ConfigVec MakeConfigs() final {
+    internal::Configuration add_on;
+    add_on.set_speculative_multi_home(true);
+    return MakeTestConfigurations("scheduler", kNumRegions, 1, kNumPartitions, add_on);
+  }
+};
+
+TEST_F(SchedulerTestWithSpeculation, CommitSpeculation) {
+  auto txn = MakeTestTransaction(test_slogs[0]->config(), 1000,
+                                 {{"Y", KeyType::READ, {{1, 1}}}, {"D", KeyType::WRITE, {{0, 1}}}},
+                                 {{"COPY", "Y", "D"}});
+
+  auto lo_txn_0 = GenerateLockOnlyTxn(txn, 0);
+  auto lo_txn_1 = GenerateLockOnlyTxn(txn, 1);
+
+  delete txn;
+
+  // The txn runs speculatively after the first lock-only txn and is validated after the second one
+  SendTransaction(lo_txn_0);
+  SendTransaction(lo_txn_1);
+
+  auto output_txn = ReceiveMultipleAndMerge(0, 1);
+  LOG(INFO) << output_txn;
+  ASSERT_EQ(output_txn.status(), TransactionStatus::COMMITTED);
+  ASSERT_EQ(TxnValueEntry(output_txn, "Y").value(), "valueY");
+  ASSERT_EQ(TxnValueEntry(output_txn, "D").new_value(), "valueY");
+
+  // The result comes from the speculative run
+  auto stats = WaitForIdleSchedulerStats(0);
+  ASSERT_EQ(stats[NUM_SPECULATIONS].GetInt(), 1);
+  ASSERT_EQ(stats[NUM_COMMITTED_SPECULATIONS].GetInt(), 1);
+}
+
+TEST_F(SchedulerTestWithSpeculation, ReexecuteAfterFailedValidation) {
+  auto mh_txn = MakeTestTransaction(test_slogs[0]->config(), 1000,
+                                    {{"Y", KeyType::READ, {{1, 1}}}, {"D", KeyType::WRITE, {{0, 1}}}},
+                                    {{"COPY", "Y", "D"}});
+  auto sh_txn =
+      MakeTestTransaction(test_slogs[0]->config(), 2000, {{"Y", KeyType::WRITE, {{1, 1}}}}, {{"SET", "Y", "newY"}});
+
+  auto lo_txn_0 = GenerateLockOnlyTxn(mh_txn, 0);
+  auto lo_txn_1 = GenerateLockOnlyTxn(mh_txn, 1);
+
+  delete mh_txn;
+
+  // The single-home txn is ordered before the multi-home txn on Y so the speculative
+  // run reads a stale value of Y and must be re-executed
+  SendTransaction(lo_txn_0);
+  SendTransaction(sh_txn);
+  SendTransaction(lo_txn_1);
+
+  map<TxnId, Transaction> output_txns;
+  for (int i = 0; i < 2; i++) {
+    auto req_env = test_slogs[0]->ReceiveFromOutputSocket(kServerChannel);
+    ASSERT_NE(req_env, nullptr);
+    const auto& sub_txn = req_env->request().finished_subtxn().txn();
+    output_txns.emplace(sub_txn.internal().id(), sub_txn);
+  }
+
+  ASSERT_EQ(output_txns.size(), 2U);
+  ASSERT_EQ(output_txns[2000].status(), TransactionStatus::COMMITTED);
+  ASSERT_EQ(output_txns[1000].status(), TransactionStatus::COMMITTED);
+  ASSERT_EQ(TxnValueEntry(output_txns[1000], "Y").value(), "newY");
+  ASSERT_EQ(TxnValueEntry(output_txns[1000], "D").new_value(), "newY");
+
+  // The speculative run was discarded and the result above comes from the re-execution
+  auto stats = WaitForIdleSchedulerStats(0);
+  ASSERT_EQ(stats[NUM_SPECULATIONS].GetInt(), 1);
+  ASSERT_EQ(stats[NUM_COMMITTED_SPECULATIONS].GetInt(), 0);
+}
+
+class SchedulerTestWithPriorityDispatch : public SchedulerTest {
+ protected:
+  ConfigVec MakeConfigs() final {
+    internal::Configuration add_on;
+    add_on.set_priority_dispatch(true);
+    add_on.set_num_workers(1);
+    return MakeTestConfigurations("scheduler", kNumRegions, 1, kNumPartitions, add_on);
+  }
+};
+
+TEST_F(SchedulerTestWithPriorityDispatch, DispatchTxnWithMostWaitersFirst) {
+  // txn1 holds the locks of A and D long enough for the other txns to queue up behind it
+  auto txn1 = MakeTestTransaction(test_slogs[0]->config(), 1000,
+                                  {{"A", KeyType::WRITE, {{0, 1}}}, {"D", KeyType::WRITE, {{0, 1}}}},
+                                  {{"SLEEP", "200"}, {"SET", "A", "A1"}, {"SET", "D", "D1"}});
+  auto txn2 =
+      MakeTestTransaction(test_slogs[0]->config(), 2000, {{"A", KeyType::WRITE, {{0, 1}}}}, {{"SET", "A", "A2"}});
+  auto txn3 =
+      MakeTestTransaction(test_slogs[0]->config(), 3000, {{"D", KeyType::WRITE, {{0, 1}}}}, {{"SET", "D", "D3"}});
+  auto txn4 =
+      MakeTestTransaction(test_slogs[0]->config(), 4000, {{"D", KeyType::WRITE, {{0, 1}}}}, {{"SET", "D", "D4"}});
+
+  SendTransaction(txn1);
+  SendTransaction(txn2);
+  SendTransaction(txn3);
+  SendTransaction(txn4);
+
+  // txn2 and txn3 are unblocked at the same time but txn3 goes first because txn4 waits for it
+  vector<TxnId> finished;
+  for (int i = 0; i < 4; i++) {
+    auto req_env = test_slogs[0]->ReceiveFromOutputSocket(kServerChannel);
+    ASSERT_NE(req_env, nullptr);
+    const auto& txn = req_env->request().finished_subtxn().txn();
+    ASSERT_EQ(txn.status(), TransactionStatus::COMMITTED);
+    finished.push_back(txn.internal().id());
+  }
+  ASSERT_EQ(finished, vector<TxnId>({1000, 3000, 2000, 4000}));
+}
+
 class SchedulerTestWithDeadlockResolver : public SchedulerTest {
  protected:
   static const size_t kNumMachines = 6;
@@ -451,8 +748,203 @@ TEST_F(SchedulerTestWithDeadlockResolver, PartitionedDeadlock) {
     ASSERT_EQ(TxnValueEntry(output_txn, "A").new_value(), "test");
   }
 }
+
+TEST_F(SchedulerTestWithDeadlockResolver, PartitionedDeadlockWithAbort) {
+  // C has outdated master information so the partition of X and C aborts txn1. The txn must
+  // stay in the lock manager of that partition until the deadlock is resolved
+  auto txn1 = MakeTestTransaction(
+      test_slogs[0]->config(), 1000,
+      {{"A", KeyType::READ, {{0, 1}}}, {"X", KeyType::WRITE, {{1, 1}}}, {"C", KeyType::READ, {{1, 1}}}},
+      {{"GET", "A"}, {"SET", "X", "test"}}, {}, 0);
+  auto lo_txn_1_0 = GenerateLockOnlyTxn(txn1, 0);
+  auto lo_txn_1_1 = GenerateLockOnlyTxn(txn1, 1);
+  delete txn1;
+
+  auto txn2 = MakeTestTransaction(test_slogs[0]->config(), 2000,
+                                  {{"A", KeyType::WRITE, {{0, 1}}}, {"X", KeyType::READ, {{1, 1}}}},
+                                  {{"COPY", "X", "A"}}, {}, 1);
+  auto lo_txn_2_0 = GenerateLockOnlyTxn(txn2, 0);
+  auto lo_txn_2_1 = GenerateLockOnlyTxn(txn2, 1);
+  delete txn2;
+
+  SendTransaction(lo_txn_1_0);
+  SendTransaction(lo_txn_2_0);
+  SendTransaction(lo_txn_2_1);
+  SendTransaction(lo_txn_1_1);
+
+  {
+    auto output_txn = ReceiveMultipleAndMerge(0, 2);
+    LOG(INFO) << output_txn;
+    ASSERT_EQ(output_txn.internal().id(), 1000);
+    ASSERT_EQ(output_txn.status(), TransactionStatus::ABORTED);
+  }
+
+  {
+    auto output_txn = ReceiveMultipleAndMerge(1, 2);
+    LOG(INFO) << output_txn;
+    ASSERT_EQ(output_txn.internal().id(), 2000);
+    ASSERT_EQ(output_txn.status(), TransactionStatus::COMMITTED);
+    ASSERT_EQ(TxnValueEntry(output_txn, "X").value(), "valueX");
+    ASSERT_EQ(TxnValueEntry(output_txn, "A").new_value(), "valueX");
+  }
+}
+
+class SchedulerTestWithMetadataCache : public SchedulerTest {
+ protected:
+  ConfigVec MakeConfigs() final {
+    internal::Configuration add_on;
+    add_on.set_forwarder_metadata_cache_size(100);
+    return MakeTestConfigurations("scheduler", kNumRegions, 1, kNumPartitions, add_on);
+  }
+
+  void SetUp() {
+    SchedulerTest::SetUp();
+    for (size_t i = 0; i < kNumMachines; i++) {
+      test_slogs[i]->AddOutputSocket(kForwarderChannel);
+    }
+  }
+};
+
+#if defined(REMASTER_PROTOCOL_SIMPLE) || defined(REMASTER_PROTOCOL_PER_KEY) || defined(REMASTER_PROTOCOL_COUNTERLESS)
+TEST_F(SchedulerTestWithMetadataCache, SendMasterUpdateAfterRemaster) {
+#ifdef REMASTER_PROTOCOL_COUNTERLESS
+  auto remaster_txn = MakeTestTransaction(test_slogs[0]->config(), 1000, {{"A", KeyType::WRITE, 0}}, {},
+                                          1 /* new master */, MakeMachineId(0, 1));
+  auto remaster_txn_lo_0 = GenerateLockOnlyTxn(remaster_txn, 0);
+  auto remaster_txn_lo_1 = GenerateLockOnlyTxn(remaster_txn, 1);
+  delete remaster_txn;
+
+  SendTransaction(remaster_txn_lo_1);
+  SendTransaction(remaster_txn_lo_0);
+  const uint32_t kNewCounter = 1;
+#else
+  auto remaster_txn = MakeTestTransaction(test_slogs[0]->config(), 1000, {{"A", KeyType::WRITE, {{0, 1}}}}, {},
+                                          1 /* new master */, MakeMachineId(0, 1));
+  SendTransaction(remaster_txn);
+  const uint32_t kNewCounter = 2;
+#endif
+
+  auto output_remaster_txn = ReceiveMultipleAndMerge(1, 1);
+  ASSERT_EQ(output_remaster_txn.status(), TransactionStatus::COMMITTED);
+
+  // A is stored on partition 0 so the forwarders of the other partitions receive its new master
+  for (int p = 1; p < static_cast<int>(kNumPartitions); p++) {
+    auto req_env = test_slogs[p]->ReceiveFromOutputSocket(kForwarderChannel, false);
+    ASSERT_NE(req_env, nullptr);
+    ASSERT_EQ(req_env->request().type_case(), internal::Request::kMasterUpdate);
+    const auto& updates = req_env->request().master_update().updates();
+    ASSERT_EQ(updates.size(), 1);
+    ASSERT_EQ(updates[0].key(), "A");
+    ASSERT_EQ(updates[0].metadata().master(), 1U);
+    ASSERT_EQ(updates[0].metadata().counter(), kNewCounter);
+  }
+}
 #endif
 
+class SchedulerTestWithLeastLoadedDispatch : public SchedulerTest {
+ protected:
+  ConfigVec MakeConfigs() final {
+    internal::Configuration add_on;
+    add_on.set_num_workers(3);
+    return MakeTestConfigurations("scheduler", kNumRegions, 1, kNumPartitions, add_on);
+  }
+
+  Transaction* MakeSleepingTxn(TxnId id, int sleep_ms) {
+    // The txns only read A so they can run at the same time
+    return MakeTestTransaction(test_slogs[0]->config(), id, {{"A", KeyType::READ, {{0, 1}}}},
+                               {{"SLEEP", to_string(sleep_ms)}}, {}, MakeMachineId(0, 1));
+  }
+};
+
+TEST_F(SchedulerTestWithLeastLoadedDispatch, DispatchToLeastLoadedWorker) {
+  SendTransaction(MakeSleepingTxn(1000, 300));
+  ASSERT_EQ(WaitForWorkerLoads(0, {1, 0, 0}), vector<int>({1, 0, 0}));
+
+  // Worker 0 is busy so the next txn goes to another worker
+  SendTransaction(MakeSleepingTxn(2000, 1000));
+  ASSERT_EQ(WaitForWorkerLoads(0, {1, 1, 0}), vector<int>({1, 1, 0}));
+
+  auto output_txn = ReceiveMultipleAndMerge(1, 1);
+  ASSERT_EQ(output_txn.internal().id(), 1000);
+  ASSERT_EQ(WaitForWorkerLoads(0, {0, 1, 0}), vector<int>({0, 1, 0}));
+
+  // Workers 0 and 2 are equally loaded. The tie is broken in round-robin order starting after the
+  // last selected worker, so worker 2 is chosen
+  SendTransaction(MakeSleepingTxn(3000, 1000));
+  ASSERT_EQ(WaitForWorkerLoads(0, {0, 1, 1}), vector<int>({0, 1, 1}));
+}
+
+class SchedulerTestWithKeyAffinity : public SchedulerTest {
+ protected:
+  ConfigVec MakeConfigs() final {
+    internal::Configuration add_on;
+    add_on.set_num_workers(kNumWorkers);
+    add_on.set_worker_key_affinity(true);
+    add_on.set_worker_affinity_max_load(1);
+    return MakeTestConfigurations("scheduler", kNumRegions, 1, kNumPartitions, add_on);
+  }
+
+  // Loads of the workers when only the preferred worker of the given key runs a txn
+  static vector<int> LoadsOnPreferredWorker(const Key& key) {
+    vector<int> loads(kNumWorkers, 0);
+    loads[hash<Key>{}(key) % kNumWorkers] = 1;
+    return loads;
+  }
+
+  static constexpr int kNumWorkers = 3;
+};
+
+TEST_F(SchedulerTestWithKeyAffinity, DispatchSameWriteKeyToSameWorker) {
+  auto expected_loads = LoadsOnPreferredWorker("D");
+  for (TxnId id : {1000, 2000}) {
+    SendTransaction(MakeTestTransaction(test_slogs[0]->config(), id,
+                                        {{"A", KeyType::READ, {{0, 1}}}, {"D", KeyType::WRITE, {{0, 1}}}},
+                                        {{"SLEEP", "300"}}, {}, MakeMachineId(0, 1)));
+    // Both txns go to the worker of D even though least-loaded dispatch would rotate to another worker
+    ASSERT_EQ(WaitForWorkerLoads(0, expected_loads), expected_loads);
+
+    auto output_txn = ReceiveMultipleAndMerge(1, 1);
+    ASSERT_EQ(output_txn.internal().id(), id);
+    ASSERT_EQ(WaitForWorkerLoads(0, {0, 0, 0}), vector<int>({0, 0, 0}));
+  }
+
+  auto stats = GetSchedulerStats(0);
+  ASSERT_EQ(stats[NUM_AFFINITY_DISPATCHES].GetInt(), 2);
+  ASSERT_EQ(stats[NUM_AFFINITY_FALLBACKS].GetInt(), 0);
+}
+
+TEST_F(SchedulerTestWithKeyAffinity, FallBackToLeastLoadedWorker) {
+  // Read-only txns are placed by their first key. They only read A so they can run at the same time
+  auto MakeReadOnlyTxn = [this](TxnId id) {
+    return MakeTestTransaction(test_slogs[0]->config(), id, {{"A", KeyType::READ, {{0, 1}}}}, {{"SLEEP", "1000"}},
+                               {}, MakeMachineId(0, 1));
+  };
+
+  SendTransaction(MakeReadOnlyTxn(1000));
+  auto expected_loads = LoadsOnPreferredWorker("A");
+  ASSERT_EQ(WaitForWorkerLoads(0, expected_loads), expected_loads);
+
+  // The worker of A reached the max load so the next txn goes to an idle worker
+  SendTransaction(MakeReadOnlyTxn(2000));
+  vector<int> loads;
+  for (int i = 0; i < 100; i++) {
+    auto stats = GetSchedulerStats(0);
+    if (stats[NUM_AFFINITY_FALLBACKS].GetInt() == 1) {
+      ASSERT_EQ(stats[NUM_AFFINITY_DISPATCHES].GetInt(), 1);
+      for (const auto& load : stats[WORKER_LOADS].GetArray()) {
+        loads.push_back(load.GetInt());
+      }
+      break;
+    }
+    this_thread::sleep_for(10ms);
+  }
+  // Each txn runs on a different worker
+  ASSERT_EQ(loads.size(), static_cast<size_t>(kNumWorkers));
+  ASSERT_EQ(loads[hash<Key>{}("A") % kNumWorkers], 1);
+  ASSERT_EQ(count(loads.begin(), loads.end(), 1), 2);
+  ASSERT_EQ(count(loads.begin(), loads.end(), 0), kNumWorkers - 2);
+}
+
 int main(int argc, char* argv[]) {
   ::testing::InitGoogleTest(&argc, argv);
   google::InstallFailureSignalHandler();
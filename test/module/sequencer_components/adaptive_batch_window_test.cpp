@@ -0,0 +1,54 @@
+#include "module/sequencer_components/adaptive_batch_window.h"
+
+#include <gtest/gtest.h>
+
+using namespace std;
+using namespace std::chrono;
+using namespace slog;
+
+TEST(AdaptiveBatchWindowTest, StartAtLowerBound) {
+  AdaptiveBatchWindow window(1000us, 10000us, 100, 0);
+  ASSERT_EQ(window.window(), 1000us);
+}
+
+TEST(AdaptiveBatchWindowTest, GrowWithBacklogAndShrinkWhenDrained) {
+  AdaptiveBatchWindow window(1000us, 10000us, 100, 0);
+  auto prev = window.window();
+  for (int i = 0; i < 3; i++) {
+    window.Update(10, 1ms, 500);
+    ASSERT_GT(window.window(), prev);
+    prev = window.window();
+  }
+
+  // The window stays the same while the backlog is between half of the target and the target
+  window.Update(10, 1ms, 80);
+  ASSERT_EQ(window.window(), prev);
+
+  for (int i = 0; i < 3; i++) {
+    window.Update(10, 1ms, 0);
+    ASSERT_LT(window.window(), prev);
+    prev = window.window();
+  }
+}
+
+TEST(AdaptiveBatchWindowTest, StayWithinBounds) {
+  AdaptiveBatchWindow window(1000us, 10000us, 100, 0);
+  for (int i = 0; i < 100; i++) {
+    window.Update(10, 1ms, 500);
+  }
+  ASSERT_EQ(window.window(), 10000us);
+  for (int i = 0; i < 100; i++) {
+    window.Update(10, 1ms, 0);
+  }
+  ASSERT_EQ(window.window(), 1000us);
+}
+
+TEST(AdaptiveBatchWindowTest, CapAtTimeToFillMaxBatch) {
+  // 100 txns per ms fills a batch of 200 txns in 2 ms
+  AdaptiveBatchWindow window(1000us, 10000us, 100, 200);
+  for (int i = 0; i < 100; i++) {
+    window.Update(100, 1ms, 500);
+  }
+  ASSERT_DOUBLE_EQ(window.arrival_rate(), 100000);
+  ASSERT_EQ(window.window(), 2000us);
+}
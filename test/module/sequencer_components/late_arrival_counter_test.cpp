@@ -0,0 +1,41 @@
+#include "module/sequencer_components/late_arrival_counter.h"
+
+#include <gtest/gtest.h>
+
+using namespace std;
+using namespace slog;
+
+namespace {
+
+Transaction MakeTxn(TransactionType type, int64_t timestamp) {
+  Transaction txn;
+  txn.mutable_internal()->set_type(type);
+  txn.mutable_internal()->set_timestamp(timestamp);
+  return txn;
+}
+
+}  // namespace
+
+TEST(LateArrivalCounterTest, CountOnlyMultiHomeTxns) {
+  LateArrivalCounter counter(2);
+  const int64_t kNow = 1000;
+
+  // Single-home txns have no timestamp so they would all look late if they were counted
+  counter.Count(MakeTxn(TransactionType::SINGLE_HOME, 0), 0, kNow);
+  counter.Count(MakeTxn(TransactionType::SINGLE_HOME, 0), 1, kNow);
+  counter.Count(MakeTxn(TransactionType::MULTI_HOME_OR_LOCK_ONLY, kNow - 1), 0, kNow);
+  counter.Count(MakeTxn(TransactionType::MULTI_HOME_OR_LOCK_ONLY, kNow + 1), 0, kNow);
+  counter.Count(MakeTxn(TransactionType::MULTI_HOME_OR_LOCK_ONLY, kNow + 1), 1, kNow);
+  counter.Count(MakeTxn(TransactionType::SINGLE_HOME, 0), 1, kNow);
+
+  auto& counts = counter.counts();
+  ASSERT_EQ(counts.size(), 2U);
+  ASSERT_EQ(counts[0].num_txns, 2U);
+  ASSERT_EQ(counts[0].num_late_txns, 1U);
+  ASSERT_EQ(counts[1].num_txns, 1U);
+  ASSERT_EQ(counts[1].num_late_txns, 0U);
+
+  counter.Reset();
+  ASSERT_EQ(counter.counts()[0].num_txns, 0U);
+  ASSERT_EQ(counter.counts()[0].num_late_txns, 0U);
+}
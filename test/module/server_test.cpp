@@ -0,0 +1,116 @@
+#include "module/server.h"
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+#include "common/configuration.h"
+#include "common/constants.h"
+#include "common/proto_utils.h"
+#include "test/test_utils.h"
+
+using namespace std;
+using namespace slog;
+
+class ServerTest : public ::testing::Test {
+ protected:
+  static const size_t NUM_MACHINES = 2;
+
+  void SetUp() {
+    internal::Configuration extra_config;
+    // Only one txn is let into the system at a time and only one more can wait for it
+    extra_config.set_server_max_in_flight_txns(1);
+    extra_config.set_server_admission_queue_size(1);
+    configs = MakeTestConfigurations("server", 1 /* num_regions */, 1 /* num_replicas */, 2 /* num_partitions */,
+                                     extra_config);
+
+    for (size_t i = 0; i < NUM_MACHINES; i++) {
+      test_slogs[i] = make_unique<TestSlog>(configs[i]);
+      senders[i] = test_slogs[i]->NewSender();
+    }
+    test_slogs[0]->AddServerAndClient();
+    test_slogs[0]->AddOutputSocket(kForwarderChannel);
+
+    for (const auto& test_slog : test_slogs) {
+      test_slog->StartInNewThreads();
+    }
+  }
+
+  Transaction* ReceiveOnForwarderChannel(long timeout_ms = -1) {
+    vector<zmq::pollitem_t> poll_items{test_slogs[0]->GetPollItemForOutputSocket(kForwarderChannel)};
+    if (zmq::poll(poll_items, std::chrono::milliseconds(timeout_ms)) <= 0) {
+      return nullptr;
+    }
+    auto req_env = test_slogs[0]->ReceiveFromOutputSocket(kForwarderChannel);
+    if (req_env == nullptr || req_env->request().type_case() != internal::Request::kForwardTxn) {
+      return nullptr;
+    }
+    return req_env->mutable_request()->mutable_forward_txn()->release_txn();
+  }
+
+  // Sends the result of a txn on the given partition to the server
+  void SendFinishedSubtxn(const Transaction& txn, PartitionId partition, const vector<PartitionId>& involved) {
+    auto env = make_unique<internal::Envelope>();
+    auto finished_subtxn = env->mutable_request()->mutable_finished_subtxn();
+    auto subtxn = finished_subtxn->mutable_txn();
+    subtxn->CopyFrom(txn);
+    subtxn->set_status(TransactionStatus::COMMITTED);
+    subtxn->mutable_internal()->mutable_involved_partitions()->Add(involved.begin(), involved.end());
+    finished_subtxn->set_partition(partition);
+    senders[partition]->Send(move(env), MakeMachineId(0, 0, 0), kServerChannel);
+  }
+
+  unique_ptr<TestSlog> test_slogs[NUM_MACHINES];
+  unique_ptr<Sender> senders[NUM_MACHINES];
+  ConfigVec configs;
+};
+
+TEST_F(ServerTest, AdmitWaitingTxnAfterMultiPartitionResult) {
+  test_slogs[0]->SendTxn(MakeTransaction({{"A"}, {"B", KeyType::WRITE}}));
+  unique_ptr<Transaction> txn1(ReceiveOnForwarderChannel());
+  ASSERT_TRUE(txn1 != nullptr);
+
+  // The only credit is taken by the first txn so the second one waits
+  test_slogs[0]->SendTxn(MakeTransaction({{"C"}}));
+  ASSERT_EQ(ReceiveOnForwarderChannel(200), nullptr);
+
+  // The second txn is still waiting until the results from all partitions of the first txn are back
+  SendFinishedSubtxn(*txn1, 0, {0, 1});
+  ASSERT_EQ(ReceiveOnForwarderChannel(200), nullptr);
+
+  SendFinishedSubtxn(*txn1, 1, {0, 1});
+  auto result = test_slogs[0]->RecvTxnResult();
+  ASSERT_EQ(result.internal().id(), txn1->internal().id());
+  ASSERT_EQ(result.status(), TransactionStatus::COMMITTED);
+
+  unique_ptr<Transaction> txn2(ReceiveOnForwarderChannel());
+  ASSERT_TRUE(txn2 != nullptr);
+  ASSERT_EQ(txn2->keys_size(), 1);
+  ASSERT_EQ(txn2->keys(0).key(), "C");
+}
+
+TEST_F(ServerTest, ShedTxnWhenAdmissionQueueIsFull) {
+  test_slogs[0]->SendTxn(MakeTransaction({{"A"}}));
+  unique_ptr<Transaction> txn1(ReceiveOnForwarderChannel());
+  ASSERT_TRUE(txn1 != nullptr);
+
+  // Takes the only spot in the admission queue
+  test_slogs[0]->SendTxn(MakeTransaction({{"B"}}));
+  // No spot is left for this one
+  test_slogs[0]->SendTxn(MakeTransaction({{"C"}}));
+
+  auto shed_txn = test_slogs[0]->RecvTxnResult();
+  ASSERT_EQ(shed_txn.status(), TransactionStatus::ABORTED);
+  ASSERT_EQ(shed_txn.abort_code(), AbortCode::RATE_LIMITED);
+  ASSERT_EQ(shed_txn.keys(0).key(), "C");
+  ASSERT_EQ(ReceiveOnForwarderChannel(200), nullptr);
+
+  // The queued txn is admitted once the first one finishes
+  SendFinishedSubtxn(*txn1, 0, {0});
+  auto result = test_slogs[0]->RecvTxnResult();
+  ASSERT_EQ(result.internal().id(), txn1->internal().id());
+
+  unique_ptr<Transaction> txn2(ReceiveOnForwarderChannel());
+  ASSERT_TRUE(txn2 != nullptr);
+  ASSERT_EQ(txn2->keys(0).key(), "B");
+}
@@ -0,0 +1,118 @@
+#include "paxos/acceptor_log.h"
+
+#include <gmock/gmock.h>
+#include <gtest/gtest.h>
+#include <unistd.h>
+
+#include <cstdio>
+#include <fstream>
+
+using namespace std;
+using namespace slog;
+using ::testing::ElementsAre;
+
+class AcceptorLogTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    path_ = "/tmp/acceptor_log_test_" + to_string(getpid()) + ".log";
+    remove(path_.c_str());
+  }
+
+  void TearDown() override { remove(path_.c_str()); }
+
+  static internal::PaxosAcceptRequest MakeAcceptRequest(uint32_t ballot, uint32_t slot, vector<uint64_t> values) {
+    internal::PaxosAcceptRequest req;
+    req.set_ballot(ballot);
+    req.set_slot(slot);
+    req.mutable_values()->Add(values.begin(), values.end());
+    return req;
+  }
+
+  string path_;
+};
+
+TEST_F(AcceptorLogTest, EmptyLog) {
+  vector<AcceptorLog::Record> recovered;
+  AcceptorLog log(path_, recovered);
+  ASSERT_TRUE(recovered.empty());
+}
+
+TEST_F(AcceptorLogTest, RecoverSyncedRecords) {
+  {
+    vector<AcceptorLog::Record> recovered;
+    AcceptorLog log(path_, recovered);
+    log.Append(MakeAcceptRequest(0, 0, {10}));
+    log.Append(MakeAcceptRequest(0, 1, {20, 30, 40}));
+    ASSERT_EQ(log.num_buffered_records(), 2);
+    log.Sync();
+    ASSERT_EQ(log.num_buffered_records(), 0);
+    log.Append(MakeAcceptRequest(2, 4, {}));
+    log.Sync();
+  }
+  vector<AcceptorLog::Record> recovered;
+  AcceptorLog log(path_, recovered);
+  ASSERT_EQ(recovered.size(), 3);
+  ASSERT_EQ(recovered[0].slot, 0);
+  ASSERT_EQ(recovered[0].ballot, 0);
+  ASSERT_THAT(recovered[0].values, ElementsAre(10));
+  ASSERT_EQ(recovered[1].slot, 1);
+  ASSERT_THAT(recovered[1].values, ElementsAre(20, 30, 40));
+  ASSERT_EQ(recovered[2].slot, 4);
+  ASSERT_EQ(recovered[2].ballot, 2);
+  ASSERT_TRUE(recovered[2].values.empty());
+}
+
+TEST_F(AcceptorLogTest, DiscardTornRecord) {
+  {
+    vector<AcceptorLog::Record> recovered;
+    AcceptorLog log(path_, recovered);
+    log.Append(MakeAcceptRequest(1, 0, {10, 20}));
+    log.Sync();
+  }
+  // Simulate a crash in the middle of writing the next record
+  {
+    ofstream f(path_, ios::binary | ios::app);
+    uint32_t partial[] = {2, 1, 5};
+    f.write(reinterpret_cast<const char*>(partial), sizeof(partial));
+  }
+  {
+    vector<AcceptorLog::Record> recovered;
+    AcceptorLog log(path_, recovered);
+    ASSERT_EQ(recovered.size(), 1);
+    ASSERT_THAT(recovered[0].values, ElementsAre(10, 20));
+    // The next record is appended right after the last complete one
+    log.Append(MakeAcceptRequest(1, 2, {30}));
+    log.Sync();
+  }
+  vector<AcceptorLog::Record> recovered;
+  AcceptorLog log(path_, recovered);
+  ASSERT_EQ(recovered.size(), 2);
+  ASSERT_EQ(recovered[1].slot, 2);
+  ASSERT_THAT(recovered[1].values, ElementsAre(30));
+}
+
+TEST_F(AcceptorLogTest, CompactOnOpen) {
+  {
+    vector<AcceptorLog::Record> recovered;
+    AcceptorLog log(path_, recovered);
+    log.Append(MakeAcceptRequest(1, 0, {10, 20}));
+    log.Append(MakeAcceptRequest(3, 2, {30}));
+    log.Sync();
+  }
+  {
+    vector<AcceptorLog::Record> recovered;
+    AcceptorLog log(path_, recovered);
+    ASSERT_EQ(recovered.size(), 2);
+    log.Append(MakeAcceptRequest(3, 3, {40}));
+    log.Sync();
+  }
+  // The records before the previous open are replaced by one that only keeps the ballot and the next slot
+  vector<AcceptorLog::Record> recovered;
+  AcceptorLog log(path_, recovered);
+  ASSERT_EQ(recovered.size(), 2);
+  ASSERT_EQ(recovered[0].slot, 3);
+  ASSERT_EQ(recovered[0].ballot, 3);
+  ASSERT_TRUE(recovered[0].values.empty());
+  ASSERT_EQ(recovered[1].slot, 3);
+  ASSERT_THAT(recovered[1].values, ElementsAre(40));
+}
@@ -1,9 +1,14 @@
 #include <gtest/gtest.h>
+#include <unistd.h>
 
 #include <condition_variable>
+#include <filesystem>
+#include <fstream>
+#include <queue>
 #include <vector>
 
 #include "common/proto_utils.h"
+#include "paxos/acceptor_log.h"
 #include "paxos/simulated_multi_paxos.h"
 #include "test/test_utils.h"
 
@@ -16,18 +21,19 @@ const Channel kTestChannel = 1;
 
 class TestSimulatedMultiPaxos : public SimulatedMultiPaxos {
  public:
-  TestSimulatedMultiPaxos(const shared_ptr<Broker>& broker, Members members, const MachineId& me)
-      : SimulatedMultiPaxos(kTestChannel, broker, members, me, kTestModuleTimeout) {}
+  TestSimulatedMultiPaxos(const shared_ptr<Broker>& broker, Members members, const MachineId& me,
+                          const internal::PaxosDurability& durability = {})
+      : SimulatedMultiPaxos(kTestChannel, broker, members, me, kTestModuleTimeout, durability) {}
 
   Pair Poll() {
     unique_lock<mutex> lock(m_);
-    // Wait until committed_ is not null
-    bool ok = cv_.wait_for(lock, std::chrono::milliseconds(2000), [this] { return committed_ != nullptr; });
+    // Wait until something is committed
+    bool ok = cv_.wait_for(lock, std::chrono::milliseconds(2000), [this] { return !committed_.empty(); });
     if (!ok) {
       CHECK(false) << "Poll timed out";
     }
-    Pair ret = *committed_;
-    committed_.reset();
+    Pair ret = committed_.front();
+    committed_.pop();
     return ret;
   }
 
@@ -35,28 +41,29 @@ class TestSimulatedMultiPaxos : public SimulatedMultiPaxos {
   void OnCommit(uint32_t slot, int64_t value, MachineId) final {
     {
       lock_guard<mutex> g(m_);
-      CHECK(committed_ == nullptr) << "The result needs to be read before committing another one";
-      committed_.reset(new Pair(slot, value));
+      committed_.emplace(slot, value);
     }
     cv_.notify_all();
   }
 
  private:
-  unique_ptr<Pair> committed_;
+  queue<Pair> committed_;
   mutex m_;
   condition_variable cv_;
 };
 
 class PaxosTest : public ::testing::Test {
  protected:
-  void AddAndStartNewPaxos(const ConfigurationPtr& config) {
-    AddAndStartNewPaxos(config, config->all_machine_ids(), config->all_machine_ids(), config->local_machine_id());
+  void AddAndStartNewPaxos(const ConfigurationPtr& config, const internal::PaxosDurability& durability = {}) {
+    AddAndStartNewPaxos(config, config->all_machine_ids(), config->all_machine_ids(), config->local_machine_id(),
+                        durability);
   }
 
   void AddAndStartNewPaxos(const ConfigurationPtr& config, const vector<MachineId>& acceptors,
-                           const vector<MachineId>& learners, MachineId me) {
+                           const vector<MachineId>& learners, MachineId me,
+                           const internal::PaxosDurability& durability = {}) {
     auto broker = Broker::New(config, kTestModuleTimeout);
-    auto paxos = make_shared<TestSimulatedMultiPaxos>(broker, Members(acceptors, learners), me);
+    auto paxos = make_shared<TestSimulatedMultiPaxos>(broker, Members(acceptors, learners), me, durability);
     auto sender = make_unique<Sender>(broker->config(), broker->context());
     auto paxos_runner = new ModuleRunner(paxos);
 
@@ -161,4 +168,93 @@ TEST_F(PaxosTest, ExtraLearners) {
     ASSERT_EQ(0U, ret.first);
     ASSERT_EQ(111U, ret.second);
   }
-}
\ No newline at end of file
+}
+
+TEST_F(PaxosTest, ProposeManyValuesWithWindow) {
+  internal::Configuration extra_config;
+  // Values proposed while an instance is in flight are ordered together in the next instance
+  extra_config.set_paxos_window_size(1);
+  auto configs = MakeTestConfigurations("paxos", 1, 1, 3, extra_config);
+  for (auto config : configs) {
+    AddAndStartNewPaxos(config);
+  }
+
+  const int kNumValues = 100;
+  for (int i = 0; i < kNumValues; i++) {
+    Propose(0, 1000 + i);
+  }
+  // Every value gets its own slot, following the order in which they are proposed
+  for (auto& paxos : paxi) {
+    for (int i = 0; i < kNumValues; i++) {
+      auto ret = paxos->Poll();
+      ASSERT_EQ(static_cast<uint32_t>(i), ret.first);
+      ASSERT_EQ(static_cast<uint32_t>(1000 + i), ret.second);
+    }
+  }
+
+  // Slots continue after the batched instances
+  Propose(1, 222);
+  for (auto& paxos : paxi) {
+    auto ret = paxos->Poll();
+    ASSERT_EQ(static_cast<uint32_t>(kNumValues), ret.first);
+    ASSERT_EQ(222U, ret.second);
+  }
+}
+
+TEST_F(PaxosTest, RestartWithExistingLog) {
+  auto log_dir = filesystem::temp_directory_path() / ("paxos_test_" + to_string(getpid()));
+  filesystem::remove_all(log_dir);
+  filesystem::create_directories(log_dir);
+  internal::PaxosDurability durability;
+  durability.set_log_dir(log_dir.string());
+
+  auto configs = MakeTestConfigurations("paxos", 1, 1, 3);
+  auto LogPath = [&](MachineId me) {
+    return log_dir / ("paxos_" + to_string(kTestChannel) + "_" + to_string(me) + ".log");
+  };
+
+  // Leave the logs of a previous run in which slots 0 to 4 were accepted
+  for (auto config : configs) {
+    vector<AcceptorLog::Record> recovered;
+    AcceptorLog log(LogPath(config->local_machine_id()), recovered);
+    internal::PaxosAcceptRequest req;
+    req.set_slot(0);
+    for (uint64_t value = 1; value <= 5; value++) {
+      req.add_values(value);
+    }
+    log.Append(req);
+    log.Sync();
+  }
+
+  for (auto config : configs) {
+    AddAndStartNewPaxos(config, durability);
+  }
+
+  // The users of paxos start over so they receive positions from 0
+  Propose(0, 111);
+  for (auto& paxos : paxi) {
+    auto ret = paxos->Poll();
+    ASSERT_EQ(0U, ret.first);
+    ASSERT_EQ(111U, ret.second);
+  }
+
+  Propose(1, 222);
+  for (auto& paxos : paxi) {
+    auto ret = paxos->Poll();
+    ASSERT_EQ(1U, ret.first);
+    ASSERT_EQ(222U, ret.second);
+  }
+
+  // The records of the previous run are compacted into one that only keeps the next slot, which is where
+  // the leader continued proposing from
+  for (auto config : configs) {
+    ifstream f(LogPath(config->local_machine_id()), ios::binary);
+    uint32_t header[3];  // [slot][ballot][number of values]
+    f.read(reinterpret_cast<char*>(header), sizeof(header));
+    ASSERT_TRUE(f.good());
+    ASSERT_EQ(5U, header[0]);
+    ASSERT_EQ(0U, header[2]);
+  }
+
+  filesystem::remove_all(log_dir);
+}
@@ -53,6 +53,10 @@ ConfigVec MakeTestConfigurations(string&& prefix, int num_regions, int num_repli
   common_config.set_sequencer_batch_duration(1);
   common_config.set_forwarder_batch_duration(1);
   common_config.set_execution_type(internal::ExecutionType::KEY_VALUE);
+#if defined(REMASTER_PROTOCOL_SIMPLE) || defined(REMASTER_PROTOCOL_PER_KEY)
+  // These remaster protocols only work with the OLD lock manager
+  common_config.set_lock_manager(internal::LockManagerType::OLD);
+#endif
   int counter = 0;
   for (int reg = 0; reg < num_regions; reg++) {
     auto region = common_config.add_regions();
@@ -162,15 +166,22 @@ void TestSlog::AddLogManagers() {
         regions.push_back(r);
       }
     }
-    log_managers_.push_back(MakeRunnerFor<slog::LogManager>(i, regions, broker_, nullptr, kTestModuleTimeout));
+    auto txn_queue = txn_queues_.empty() ? nullptr : txn_queues_[i];
+    log_managers_.push_back(
+        MakeRunnerFor<slog::LogManager>(i, regions, broker_, nullptr, kTestModuleTimeout, txn_queue));
   }
 }
 
-void TestSlog::AddScheduler() { scheduler_ = MakeRunnerFor<Scheduler>(broker_, storage_, nullptr, kTestModuleTimeout); }
+void TestSlog::AddScheduler() {
+  for (int i = 0; i < broker_->config()->num_log_managers(); i++) {
+    txn_queues_.push_back(std::make_shared<TxnQueue>());
+  }
+  scheduler_ = MakeRunnerFor<Scheduler>(broker_, storage_, nullptr, kTestModuleTimeout, txn_queues_);
+}
 
-void TestSlog::AddLocalPaxos() { local_paxos_ = MakeRunnerFor<LocalPaxos>(broker_, kTestModuleTimeout); }
+void TestSlog::AddLocalPaxos() { local_paxos_ = MakeRunnerFor<LocalPaxos>(broker_, nullptr, kTestModuleTimeout); }
 
-void TestSlog::AddGlobalPaxos() { global_paxos_ = MakeRunnerFor<GlobalPaxos>(broker_, kTestModuleTimeout); }
+void TestSlog::AddGlobalPaxos() { global_paxos_ = MakeRunnerFor<GlobalPaxos>(broker_, nullptr, kTestModuleTimeout); }
 
 void TestSlog::AddMultiHomeOrderer() {
   multi_home_orderer_ = MakeRunnerFor<MultiHomeOrderer>(broker_, nullptr, kTestModuleTimeout);
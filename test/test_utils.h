@@ -52,6 +52,8 @@ class TestSlog {
   void AddServerAndClient();
   void AddForwarder();
   void AddSequencer();
+  // If the scheduler is added first, the log managers hand the txns to it through queues.
+  // Otherwise, the log managers send the txns to the scheduler channel
   void AddLogManagers();
   void AddScheduler();
   void AddLocalPaxos();
@@ -83,6 +85,7 @@ class TestSlog {
   ModuleRunnerPtr sequencer_;
   std::vector<ModuleRunnerPtr> log_managers_;
   ModuleRunnerPtr scheduler_;
+  std::vector<shared_ptr<TxnQueue>> txn_queues_;
   ModuleRunnerPtr local_paxos_;
   ModuleRunnerPtr global_paxos_;
   ModuleRunnerPtr multi_home_orderer_;